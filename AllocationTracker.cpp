@@ -0,0 +1,174 @@
+#include "AllocationTracker.h"
+#include <atomic>
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+
+namespace {
+
+const char* REGION_NAMES[] = { "other", "zoo", "enclosure", "factory", "persistence" };
+const size_t REGION_COUNT = static_cast<size_t>(AllocRegion::COUNT);
+
+static_assert(sizeof(REGION_NAMES) / sizeof(REGION_NAMES[0]) == REGION_COUNT,
+              "every AllocRegion needs a name");
+
+// Plain arrays of atomics: no constructors to run before the first new
+struct RegionCounters {
+    std::atomic<uint64_t> operations;
+    std::atomic<uint64_t> allocations;
+    std::atomic<uint64_t> bytes;
+    std::atomic<uint64_t> frees;
+};
+
+RegionCounters counters[REGION_COUNT];
+
+#ifdef ZOO_TRACK_ALLOCATIONS
+thread_local AllocRegion currentRegion = AllocRegion::Other;
+
+void* allocate(std::size_t size) {
+    void* memory = std::malloc(size == 0 ? 1 : size);
+    if (!memory) {
+        throw std::bad_alloc();
+    }
+    RegionCounters& region = counters[static_cast<size_t>(currentRegion)];
+    region.allocations.fetch_add(1, std::memory_order_relaxed);
+    region.bytes.fetch_add(size, std::memory_order_relaxed);
+    return memory;
+}
+
+void release(void* memory) {
+    if (memory) {
+        counters[static_cast<size_t>(currentRegion)].frees.fetch_add(1, std::memory_order_relaxed);
+        std::free(memory);
+    }
+}
+#endif
+
+} // namespace
+
+bool AllocationTracker::isEnabled() {
+#ifdef ZOO_TRACK_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+}
+
+const char* AllocationTracker::regionName(AllocRegion region) {
+    return region < AllocRegion::COUNT ? REGION_NAMES[static_cast<size_t>(region)] : "unknown";
+}
+
+AllocationStats AllocationTracker::get(AllocRegion region) {
+    const RegionCounters& c = counters[static_cast<size_t>(region)];
+    AllocationStats stats;
+    stats.operations = c.operations.load(std::memory_order_relaxed);
+    stats.allocations = c.allocations.load(std::memory_order_relaxed);
+    stats.bytes = c.bytes.load(std::memory_order_relaxed);
+    stats.frees = c.frees.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void AllocationTracker::reset() {
+    for (RegionCounters& c : counters) {
+        c.operations.store(0, std::memory_order_relaxed);
+        c.allocations.store(0, std::memory_order_relaxed);
+        c.bytes.store(0, std::memory_order_relaxed);
+        c.frees.store(0, std::memory_order_relaxed);
+    }
+}
+
+void AllocationTracker::report(std::ostream& out) {
+    if (!isEnabled()) {
+        out << "Allocation tracking is off (rebuild with make TRACK_ALLOCATIONS=1)" << std::endl;
+        return;
+    }
+    out << std::left << std::setw(14) << "region"
+        << std::right << std::setw(12) << "ops"
+        << std::setw(14) << "allocs"
+        << std::setw(16) << "bytes"
+        << std::setw(14) << "frees"
+        << std::setw(12) << "allocs/op"
+        << std::setw(12) << "bytes/op" << std::endl;
+    for (size_t i = 0; i < REGION_COUNT; ++i) {
+        AllocationStats s = get(static_cast<AllocRegion>(i));
+        if (s.operations == 0 && s.allocations == 0) {
+            continue;
+        }
+        out << std::left << std::setw(14) << REGION_NAMES[i]
+            << std::right << std::setw(12) << s.operations
+            << std::setw(14) << s.allocations
+            << std::setw(16) << s.bytes
+            << std::setw(14) << s.frees
+            << std::fixed << std::setprecision(2)
+            << std::setw(12) << (s.operations ? static_cast<double>(s.allocations) / s.operations : 0.0)
+            << std::setw(12) << (s.operations ? static_cast<double>(s.bytes) / s.operations : 0.0)
+            << std::endl;
+        out.unsetf(std::ios::floatfield);
+    }
+}
+
+#ifdef ZOO_TRACK_ALLOCATIONS
+
+AllocationScope::AllocationScope(AllocRegion region) : previous(currentRegion) {
+    if (region != previous) {
+        counters[static_cast<size_t>(region)].operations.fetch_add(1, std::memory_order_relaxed);
+    }
+    currentRegion = region;
+}
+
+AllocationScope::~AllocationScope() {
+    currentRegion = previous;
+}
+
+// Replacements for the global allocation functions; the aligned and
+// nothrow forms of the standard library fall back to these
+
+void* operator new(std::size_t size) {
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size) {
+    return allocate(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return allocate(size);
+    } catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return allocate(size);
+    } catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+
+void operator delete(void* memory) noexcept {
+    release(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    release(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    release(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept {
+    release(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept {
+    release(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept {
+    release(memory);
+}
+
+#endif // ZOO_TRACK_ALLOCATIONS
@@ -0,0 +1,74 @@
+#ifndef ALLOCATIONTRACKER_H
+#define ALLOCATIONTRACKER_H
+
+#include <cstdint>
+#include <ostream>
+
+/**
+ * Opt-in heap allocation counts per subsystem
+ * Built with ZOO_TRACK_ALLOCATIONS (make TRACK_ALLOCATIONS=1), the global
+ * operator new/delete count every allocation, its size and every free
+ * against the region the calling thread is in. Code marks its regions
+ * with AllocationScope; the innermost scope wins. Entering a region from
+ * a different one counts as one operation of that region, so the report
+ * shows allocations per operation.
+ *
+ * Without the macro AllocationScope is empty and nothing is replaced, so
+ * the scopes cost nothing in normal builds.
+ */
+enum class AllocRegion : uint8_t {
+    Other,          // outside any scope
+    Zoo,            // Zoo member functions
+    Enclosure,
+    Factory,        // AnimalFactory
+    Persistence,    // save, load, archives
+    COUNT
+};
+
+struct AllocationStats {
+    uint64_t operations;
+    uint64_t allocations;
+    uint64_t bytes;
+    uint64_t frees;
+};
+
+class AllocationTracker {
+public:
+    // True if this build counts allocations
+    static bool isEnabled();
+
+    static const char* regionName(AllocRegion region);
+    static AllocationStats get(AllocRegion region);
+    static void reset();
+
+    // One line per region that saw any operations or allocations
+    static void report(std::ostream& out);
+};
+
+#ifdef ZOO_TRACK_ALLOCATIONS
+
+class AllocationScope {
+private:
+    AllocRegion previous;
+
+public:
+    explicit AllocationScope(AllocRegion region);
+    ~AllocationScope();
+
+    AllocationScope(const AllocationScope&) = delete;
+    AllocationScope& operator=(const AllocationScope&) = delete;
+};
+
+#else
+
+class AllocationScope {
+public:
+    explicit AllocationScope(AllocRegion) {}
+
+    AllocationScope(const AllocationScope&) = delete;
+    AllocationScope& operator=(const AllocationScope&) = delete;
+};
+
+#endif // ZOO_TRACK_ALLOCATIONS
+
+#endif // ALLOCATIONTRACKER_H
@@ -1,20 +1,51 @@
 #include "Animal.h"
 #include <iostream>
+#include <atomic>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+    std::atomic<uint32_t> nextAnimalId(1);
+
+    int32_t toGrams(double kg) {
+        double grams = std::round(kg * 1000.0);
+        if (grams >= static_cast<double>(INT32_MAX)) return INT32_MAX;
+        if (grams <= static_cast<double>(INT32_MIN)) return INT32_MIN;
+        return static_cast<int32_t>(grams);
+    }
+}
 
 Animal::Animal(std::string name, int age, double weight)
-    : name(name), age(age), weight(weight), isHealthy(true) {
+    : weightGrams(toGrams(weight)), age(static_cast<uint16_t>(checkRange(age, UINT16_MAX, "Age"))),
+      species(SpeciesId::Unknown), isHealthy(true), slot(0), id(nextAnimalId++),
+      observer(nullptr), name(name) {
+}
+
+int Animal::checkRange(int value, int max, const char* what) {
+    if (value < 0 || value > max) {
+        throw std::invalid_argument(std::string(what) + " out of range: " + std::to_string(value));
+    }
+    return value;
 }
 
 Animal::~Animal() {
     // Virtual destructor ensures proper cleanup in derived classes
 }
 
-std::string Animal::getName() const {
+const std::string& Animal::getName() const {
     return name;
 }
 
 void Animal::setName(const std::string& name) {
+    if (this->name == name) {
+        return;
+    }
+    std::string oldName = this->name;
     this->name = name;
+    if (observer) {
+        observer->onNameChanged(this, oldName);
+    }
 }
 
 int Animal::getAge() const {
@@ -22,18 +53,24 @@ int Animal::getAge() const {
 }
 
 void Animal::setAge(int age) {
-    if (age >= 0) {
-        this->age = age;
+    if (age >= 0 && age <= UINT16_MAX && age != this->age) {
+        this->age = static_cast<uint16_t>(age);
+        if (observer) {
+            observer->onAgeChanged(this, age);
+        }
     }
 }
 
 double Animal::getWeight() const {
-    return weight;
+    return weightGrams / 1000.0;
 }
 
 void Animal::setWeight(double weight) {
     if (weight > 0) {
-        this->weight = weight;
+        weightGrams = std::max<int32_t>(1, toGrams(weight));
+        if (observer) {
+            observer->onWeightChanged(this, getWeight());
+        }
     }
 }
 
@@ -42,7 +79,21 @@ bool Animal::getHealthStatus() const {
 }
 
 void Animal::setHealthStatus(bool healthy) {
+    if (isHealthy == healthy) {
+        return;
+    }
     isHealthy = healthy;
+    if (observer) {
+        observer->onHealthChanged(this, healthy);
+    }
+}
+
+SpeciesId Animal::getSpeciesId() const {
+    return species;
+}
+
+uint32_t Animal::getId() const {
+    return id;
 }
 
 void Animal::sleep() const {
@@ -52,17 +103,41 @@ void Animal::sleep() const {
 void Animal::displayInfo() const {
     std::cout << "Name: " << name << std::endl;
     std::cout << "Age: " << age << " years" << std::endl;
-    std::cout << "Weight: " << weight << " kg" << std::endl;
+    std::cout << "Weight: " << getWeight() << " kg" << std::endl;
     std::cout << "Health Status: " << (isHealthy ? "Healthy" : "Needs Attention") << std::endl;
 }
 
 void Animal::performCheckup() {
     std::cout << "Performing checkup on " << name << "..." << std::endl;
-    // Basic checkup logic
-    isHealthy = true;
+    setHealthStatus(checkHealth());
+    if (observer) {
+        observer->onCheckup(this, isHealthy);
+    }
+}
+
+bool Animal::checkHealth() const {
+    return true;
 }
 
 double Animal::calculateFoodRequirement() const {
     // Base calculation: 5% of body weight
-    return weight * 0.05;
+    return getWeight() * 0.05;
+}
+
+void Animal::attachObserver(IAnimalObserver* owner, size_t ownerSlot) {
+    observer = owner;
+    slot = static_cast<uint32_t>(ownerSlot);
+}
+
+void Animal::detachObserver() {
+    observer = nullptr;
+    slot = 0;
+}
+
+void Animal::setSlot(size_t ownerSlot) {
+    slot = static_cast<uint32_t>(ownerSlot);
+}
+
+size_t Animal::getSlot() const {
+    return slot;
 }
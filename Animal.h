@@ -2,48 +2,88 @@
 #define ANIMAL_H
 
 #include "IAnimal.h"
+#include "IAnimalObserver.h"
+#include "Species.h"
 #include <string>
+#include <cstdint>
 
 /**
  * Abstract base class implementing common animal functionality
  * Demonstrates encapsulation with protected members and public interface
+ *
+ * Members are ordered hot-to-cold: the fields read by full-zoo scans sit
+ * right after the vtable pointer in the first 16 bytes, followed by the
+ * descriptive data. Narrow types keep the whole base in one cache line;
+ * the weight is held in whole grams, so getWeight() returns exactly the
+ * kilograms set, rounded to three decimals. Subclass measurements
+ * (wingspan, trunk length, ...) are floats and come back rounded to
+ * float precision, about seven significant digits. Constructors throw
+ * std::invalid_argument for values the narrow fields cannot hold.
  */
 class Animal : public IAnimal {
 protected:
-    std::string name;
-    int age;
-    double weight;
+    // Hot: read by scans and aggregates
+    int32_t weightGrams; // see getWeight
+    uint16_t age;        // years
+    SpeciesId species;   // set by the concrete class
     bool isHealthy;
+    uint32_t slot;       // index in the owning zoo
+    uint32_t id;         // see getId; fills what was padding
+
+    // Cold
+    IAnimalObserver* observer;
+    std::string name;
+
+    // Returns value if it is within [0, max], else throws invalid_argument
+    static int checkRange(int value, int max, const char* what);
+
+    // Verdict of a checkup, decided before performCheckup sets the health
+    // and notifies the observer, so the zoo sees one result per checkup
+    virtual bool checkHealth() const;
 
 public:
     Animal(std::string name, int age, double weight);
     virtual ~Animal();
 
     // Getters and setters (encapsulation)
-    std::string getName() const;
+    const std::string& getName() const;
     void setName(const std::string& name);
 
     int getAge() const;
     void setAge(int age);
 
+    // Kilograms, stored to the gram (up to about 2,147 tonnes); a positive
+    // weight under half a gram is kept as one gram
     double getWeight() const;
     void setWeight(double weight);
 
     bool getHealthStatus() const;
     void setHealthStatus(bool healthy);
 
+    SpeciesId getSpeciesId() const;
+
+    // Never reused within a process (up to 2^32 animals); unlike the
+    // name it survives renames and tells apart animals that share a name
+    uint32_t getId() const;
+
     // Common implementation
     void sleep() const override;
 
     // Abstract methods (to be implemented by derived classes)
     virtual void makeSound() const override = 0;
     virtual void eat() const override = 0;
-    virtual std::string getSpecies() const override = 0;
+    virtual const std::string& getSpecies() const override = 0;
 
     // New virtual methods for the sanctuary
     virtual void displayInfo() const;
     virtual void performCheckup();
     virtual double calculateFoodRequirement() const;
+
+    // Registration with the owning zoo's indexes
+    void attachObserver(IAnimalObserver* owner, size_t ownerSlot);
+    void detachObserver();
+    void setSlot(size_t ownerSlot);
+    size_t getSlot() const;
 };
 
 #endif // ANIMAL_H
@@ -8,6 +8,7 @@
 #include "Eagle.h"
 #include "Penguin.h"
 #include "Parrot.h"
+#include "AllocationTracker.h"
 #include <string>
 #include <memory>
 #include <stdexcept>
@@ -29,7 +30,7 @@ public:
                                   const std::string& name,
                                   int age,
                                   double weight) {
-        
+        AllocationScope scope(AllocRegion::Factory);
         std::string lowerSpecies = toLower(species);
         
         if (lowerSpecies == "lion") {
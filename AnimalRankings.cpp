@@ -0,0 +1,173 @@
+#include "AnimalRankings.h"
+#include "Animal.h"
+#include <queue>
+#include <utility>
+
+const char* rankByName(RankBy by) {
+    switch (by) {
+        case RankBy::Weight: return "weight";
+        case RankBy::Age: return "age";
+        case RankBy::Food: return "food";
+        default: return "unknown";
+    }
+}
+
+double AnimalRankings::keyOf(const Animal& animal, int order) {
+    switch (static_cast<RankBy>(order)) {
+        case RankBy::Weight: return animal.getWeight();
+        case RankBy::Age: return animal.getAge();
+        default: return animal.calculateFoodRequirement();
+    }
+}
+
+void AnimalRankings::place(int order, size_t index, const Entry& entry) {
+    heaps[order][index] = entry;
+    slots[entry.slot].at[order] = static_cast<uint32_t>(index);
+}
+
+void AnimalRankings::siftUp(int order, size_t index) {
+    std::vector<Entry>& heap = heaps[order];
+    Entry moving = heap[index];
+    while (index > 0) {
+        size_t parent = (index - 1) / 2;
+        if (!(heap[parent].key < moving.key)) {
+            break;
+        }
+        place(order, index, heap[parent]);
+        index = parent;
+    }
+    place(order, index, moving);
+}
+
+void AnimalRankings::siftDown(int order, size_t index) {
+    std::vector<Entry>& heap = heaps[order];
+    Entry moving = heap[index];
+    const size_t count = heap.size();
+    for (;;) {
+        size_t child = 2 * index + 1;
+        if (child >= count) {
+            break;
+        }
+        if (child + 1 < count && heap[child].key < heap[child + 1].key) {
+            ++child;
+        }
+        if (!(moving.key < heap[child].key)) {
+            break;
+        }
+        place(order, index, heap[child]);
+        index = child;
+    }
+    place(order, index, moving);
+}
+
+void AnimalRankings::update(int order, size_t index) {
+    if (index > 0 && heaps[order][(index - 1) / 2].key < heaps[order][index].key) {
+        siftUp(order, index);
+    } else {
+        siftDown(order, index);
+    }
+}
+
+void AnimalRankings::onAdded(Animal* animal, size_t slot) {
+    if (slot >= slots.size()) {
+        slots.resize(slot + 1);
+    }
+    for (int i = 0; i < ORDERS; ++i) {
+        heaps[i].push_back(Entry{ keyOf(*animal, i), static_cast<uint32_t>(slot), animal });
+        siftUp(i, heaps[i].size() - 1);
+    }
+}
+
+void AnimalRankings::onRemoved(Animal* animal, size_t slot) {
+    if (slot >= slots.size()) {
+        return;
+    }
+    for (int i = 0; i < ORDERS; ++i) {
+        std::vector<Entry>& heap = heaps[i];
+        size_t index = slots[slot].at[i];
+        if (index >= heap.size() || heap[index].animal != animal) {
+            continue;
+        }
+        // Fill the hole with the last entry and sift that into place
+        Entry last = heap.back();
+        heap.pop_back();
+        if (index < heap.size()) {
+            place(i, index, last);
+            update(i, index);
+        }
+    }
+}
+
+void AnimalRankings::onChanged(Animal* animal, size_t slot) {
+    if (slot >= slots.size()) {
+        return;
+    }
+    for (int i = 0; i < ORDERS; ++i) {
+        size_t index = slots[slot].at[i];
+        if (index >= heaps[i].size() || heaps[i][index].animal != animal) {
+            continue;
+        }
+        double key = keyOf(*animal, i);
+        if (heaps[i][index].key != key) {
+            heaps[i][index].key = key;
+            update(i, index);
+        }
+    }
+}
+
+void AnimalRankings::moveSlot(size_t from, size_t to) {
+    if (from >= slots.size() || to >= slots.size()) {
+        return;
+    }
+    slots[to] = slots[from];
+    for (int i = 0; i < ORDERS; ++i) {
+        size_t index = slots[to].at[i];
+        if (index < heaps[i].size() && heaps[i][index].slot == from) {
+            heaps[i][index].slot = static_cast<uint32_t>(to);
+        }
+    }
+}
+
+void AnimalRankings::resize(size_t slotCount) {
+    if (slotCount < slots.size()) {
+        slots.resize(slotCount);
+    }
+}
+
+void AnimalRankings::clear() {
+    for (std::vector<Entry>& heap : heaps) {
+        heap.clear();
+    }
+    slots.clear();
+}
+
+std::vector<Animal*> AnimalRankings::top(RankBy by, size_t k) const {
+    std::vector<Animal*> result;
+    if (by >= RankBy::COUNT) {
+        return result;
+    }
+    const std::vector<Entry>& heap = heaps[static_cast<int>(by)];
+    k = k < heap.size() ? k : heap.size();
+    result.reserve(k);
+
+    // Every entry outranks its children, so the next largest is always
+    // one of the children of what was taken so far
+    typedef std::pair<double, size_t> Candidate;
+    std::priority_queue<Candidate> frontier;
+    if (k > 0) {
+        frontier.push(Candidate(heap[0].key, 0));
+    }
+    while (result.size() < k) {
+        size_t index = frontier.top().second;
+        frontier.pop();
+        result.push_back(heap[index].animal);
+        for (size_t child = 2 * index + 1; child <= 2 * index + 2 && child < heap.size(); ++child) {
+            frontier.push(Candidate(heap[child].key, child));
+        }
+    }
+    return result;
+}
+
+size_t AnimalRankings::size() const {
+    return heaps[0].size();
+}
@@ -0,0 +1,77 @@
+#ifndef ANIMALRANKINGS_H
+#define ANIMALRANKINGS_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+class Animal;
+
+// What a top-K query orders by, largest first
+enum class RankBy : uint8_t {
+    Weight,
+    Age,
+    Food,       // daily food requirement
+    COUNT
+};
+
+const char* rankByName(RankBy by);
+
+/**
+ * Animals kept in order of weight, age and food requirement
+ * One indexed binary max-heap per order, in a flat array. Each zoo slot
+ * knows where its entries sit, so adds, removals and weight or age
+ * changes sift one entry in O(log n), and usually only a level or two.
+ * The top K are read by walking the heap from the root with a small
+ * frontier heap, in O(K log K) whatever the zoo size. Ties come out in
+ * no particular order.
+ *
+ * A red-black tree (std::set) per order was tried first: at a million
+ * animals its pointer chasing made each weight change over ten times
+ * slower than this.
+ *
+ * A Zoo builds one the first time it is asked for a top-K view (see
+ * Zoo::topAnimals) and keeps it current from then on.
+ */
+class AnimalRankings {
+private:
+    static const int ORDERS = static_cast<int>(RankBy::COUNT);
+
+    struct Entry {
+        double key;
+        uint32_t slot;
+        Animal* animal;
+    };
+
+    // Heap index of each slot's entry, per order
+    struct SlotPositions {
+        uint32_t at[ORDERS];
+    };
+
+    std::vector<Entry> heaps[ORDERS];
+    std::vector<SlotPositions> slots;
+
+    static double keyOf(const Animal& animal, int order);
+
+    void place(int order, size_t index, const Entry& entry);
+    void siftUp(int order, size_t index);
+    void siftDown(int order, size_t index);
+    void update(int order, size_t index);
+
+public:
+    void onAdded(Animal* animal, size_t slot);
+    void onRemoved(Animal* animal, size_t slot);
+    // Weight or age changed
+    void onChanged(Animal* animal, size_t slot);
+
+    // Slot bookkeeping, mirroring the zoo (see HealthBitmap::moveSlot)
+    void moveSlot(size_t from, size_t to);
+    void resize(size_t slotCount);
+    void clear();
+
+    // Up to k animals, largest first
+    std::vector<Animal*> top(RankBy by, size_t k) const;
+    size_t size() const;
+};
+
+#endif // ANIMALRANKINGS_H
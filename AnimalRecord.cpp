@@ -0,0 +1,249 @@
+#include "AnimalRecord.h"
+#include "Lion.h"
+#include "Elephant.h"
+#include "Monkey.h"
+#include "Eagle.h"
+#include "Penguin.h"
+#include "Parrot.h"
+#include "BinaryCodec.h"
+#include "Exceptions.h"
+
+AnimalRecord AnimalRecord::capture(const Animal& animal) {
+    AnimalRecord record;
+    record.species = animal.getSpeciesId();
+    record.name = animal.getName();
+    record.age = animal.getAge();
+    record.weight = animal.getWeight();
+    record.healthy = animal.getHealthStatus();
+
+    if (const Mammal* mammal = dynamic_cast<const Mammal*>(&animal)) {
+        record.hasFur = mammal->getHasFur();
+        record.furColor = mammal->getFurColor();
+        record.gestationPeriod = mammal->getGestationPeriod();
+    }
+    else if (const Bird* bird = dynamic_cast<const Bird*>(&animal)) {
+        record.wingspan = bird->getWingspan();
+        record.canFly = bird->getCanFly();
+        record.beakType = bird->getBeakType();
+    }
+
+    switch (record.species) {
+        case SpeciesId::Lion: {
+            const Lion& lion = static_cast<const Lion&>(animal);
+            record.maneSize = lion.getManeSize();
+            record.isAlpha = lion.getIsAlpha();
+            break;
+        }
+        case SpeciesId::Elephant: {
+            const Elephant& elephant = static_cast<const Elephant&>(animal);
+            record.trunkLength = elephant.getTrunkLength();
+            record.tuskLength = elephant.getTuskLength();
+            record.hasIvory = elephant.getHasIvory();
+            break;
+        }
+        case SpeciesId::Monkey: {
+            const Monkey& monkey = static_cast<const Monkey&>(animal);
+            record.tailLength = monkey.getTailLength();
+            record.isPrehensile = monkey.getIsPrehensile();
+            record.subSpecies = monkey.getMonkeyType();
+            break;
+        }
+        case SpeciesId::Eagle: {
+            const Eagle& eagle = static_cast<const Eagle&>(animal);
+            record.clawLength = eagle.getClawLength();
+            record.visionRange = eagle.getVisionRange();
+            record.isGoldenEagle = eagle.getIsGoldenEagle();
+            break;
+        }
+        case SpeciesId::Penguin: {
+            const Penguin& penguin = static_cast<const Penguin&>(animal);
+            record.swimSpeed = penguin.getSwimSpeed();
+            record.divingDepth = penguin.getDivingDepth();
+            record.subSpecies = penguin.getPenguinType();
+            break;
+        }
+        case SpeciesId::Parrot: {
+            const Parrot& parrot = static_cast<const Parrot&>(animal);
+            record.plumageColor = parrot.getPlumageColor();
+            record.intelligenceLevel = parrot.getIntelligenceLevel();
+            size_t words = parrot.getVocabularySize();
+            record.vocabulary.reserve(words);
+            for (size_t i = 0; i < words; ++i) {
+                record.vocabulary.push_back(parrot.getWord(i));
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    return record;
+}
+
+Animal* AnimalRecord::materialize() const {
+    Animal* animal = nullptr;
+    switch (species) {
+        case SpeciesId::Lion:
+            animal = new Lion(name, age, weight, hasFur, furColor, gestationPeriod, maneSize, isAlpha);
+            break;
+        case SpeciesId::Elephant:
+            animal = new Elephant(name, age, weight, hasFur, furColor, gestationPeriod,
+                                  trunkLength, tuskLength, hasIvory);
+            break;
+        case SpeciesId::Monkey:
+            animal = new Monkey(name, age, weight, hasFur, furColor, gestationPeriod,
+                                tailLength, isPrehensile, subSpecies);
+            break;
+        case SpeciesId::Eagle:
+            animal = new Eagle(name, age, weight, wingspan, canFly, beakType,
+                               clawLength, visionRange, isGoldenEagle);
+            break;
+        case SpeciesId::Penguin:
+            animal = new Penguin(name, age, weight, wingspan, canFly, beakType,
+                                 swimSpeed, divingDepth, subSpecies);
+            break;
+        case SpeciesId::Parrot: {
+            Parrot* parrot = new Parrot(name, age, weight, wingspan, canFly, beakType,
+                                        plumageColor, intelligenceLevel);
+            for (size_t i = WordPool::BASE_WORD_COUNT; i < vocabulary.size(); ++i) {
+                parrot->restoreWord(vocabulary[i]);
+            }
+            animal = parrot;
+            break;
+        }
+        default:
+            throw InvalidOperationException("Cannot materialize an animal of unknown species");
+    }
+    animal->setHealthStatus(healthy);
+    return animal;
+}
+
+void AnimalRecord::encode(std::string& out) const {
+    using namespace BinaryCodec;
+    putU8(out, static_cast<uint8_t>(species));
+    putText(out, name);
+    putVarint(out, static_cast<uint64_t>(age));
+    putF64(out, weight);
+    putU8(out, healthy ? 1 : 0);
+
+    switch (species) {
+        case SpeciesId::Lion:
+        case SpeciesId::Elephant:
+        case SpeciesId::Monkey:
+            putU8(out, hasFur ? 1 : 0);
+            putText(out, furColor);
+            putVarint(out, static_cast<uint64_t>(gestationPeriod));
+            break;
+        case SpeciesId::Eagle:
+        case SpeciesId::Penguin:
+        case SpeciesId::Parrot:
+            putF64(out, wingspan);
+            putU8(out, canFly ? 1 : 0);
+            putText(out, beakType);
+            break;
+        default:
+            break;
+    }
+
+    switch (species) {
+        case SpeciesId::Lion:
+            putVarint(out, static_cast<uint64_t>(maneSize));
+            putU8(out, isAlpha ? 1 : 0);
+            break;
+        case SpeciesId::Elephant:
+            putF64(out, trunkLength);
+            putVarint(out, static_cast<uint64_t>(tuskLength));
+            putU8(out, hasIvory ? 1 : 0);
+            break;
+        case SpeciesId::Monkey:
+            putText(out, subSpecies);
+            putF64(out, tailLength);
+            putU8(out, isPrehensile ? 1 : 0);
+            break;
+        case SpeciesId::Eagle:
+            putF64(out, clawLength);
+            putF64(out, visionRange);
+            putU8(out, isGoldenEagle ? 1 : 0);
+            break;
+        case SpeciesId::Penguin:
+            putText(out, subSpecies);
+            putF64(out, swimSpeed);
+            putF64(out, divingDepth);
+            break;
+        case SpeciesId::Parrot:
+            putText(out, plumageColor);
+            putVarint(out, static_cast<uint64_t>(intelligenceLevel));
+            putVarint(out, vocabulary.size());
+            for (const std::string& word : vocabulary) {
+                putText(out, word);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+AnimalRecord AnimalRecord::decode(const char* data, size_t size) {
+    BinaryCodec::Reader in(data, size);
+    AnimalRecord record;
+    uint8_t species = in.u8();
+    if (species >= SPECIES_COUNT) {
+        throw InvalidOperationException("Corrupt animal record");
+    }
+    record.species = static_cast<SpeciesId>(species);
+    record.name = in.text();
+    record.age = static_cast<int>(in.varint());
+    record.weight = in.f64();
+    record.healthy = in.u8() != 0;
+
+    switch (record.species) {
+        case SpeciesId::Lion:
+        case SpeciesId::Elephant:
+        case SpeciesId::Monkey:
+            record.hasFur = in.u8() != 0;
+            record.furColor = in.text();
+            record.gestationPeriod = static_cast<int>(in.varint());
+            break;
+        default:
+            record.wingspan = in.f64();
+            record.canFly = in.u8() != 0;
+            record.beakType = in.text();
+            break;
+    }
+
+    switch (record.species) {
+        case SpeciesId::Lion:
+            record.maneSize = static_cast<int>(in.varint());
+            record.isAlpha = in.u8() != 0;
+            break;
+        case SpeciesId::Elephant:
+            record.trunkLength = in.f64();
+            record.tuskLength = static_cast<int>(in.varint());
+            record.hasIvory = in.u8() != 0;
+            break;
+        case SpeciesId::Monkey:
+            record.subSpecies = in.text();
+            record.tailLength = in.f64();
+            record.isPrehensile = in.u8() != 0;
+            break;
+        case SpeciesId::Eagle:
+            record.clawLength = in.f64();
+            record.visionRange = in.f64();
+            record.isGoldenEagle = in.u8() != 0;
+            break;
+        case SpeciesId::Penguin:
+            record.subSpecies = in.text();
+            record.swimSpeed = in.f64();
+            record.divingDepth = in.f64();
+            break;
+        default: {
+            record.plumageColor = in.text();
+            record.intelligenceLevel = static_cast<int>(in.varint());
+            size_t words = static_cast<size_t>(in.varint());
+            for (size_t i = 0; i < words; ++i) {
+                record.vocabulary.push_back(in.text());
+            }
+            break;
+        }
+    }
+    return record;
+}
@@ -0,0 +1,73 @@
+#ifndef ANIMALRECORD_H
+#define ANIMALRECORD_H
+
+#include "Animal.h"
+#include <string>
+#include <vector>
+
+/**
+ * Flat copy of every attribute of an animal, including the fields of its
+ * concrete class. Fields that do not apply to the species keep their
+ * defaults. Used by exporters that need the whole record, not just the
+ * base Animal fields written by Zoo::saveToFile. materialize() and the
+ * binary encode()/decode() pair let archives round-trip an animal exactly.
+ */
+struct AnimalRecord {
+    SpeciesId species = SpeciesId::Unknown;
+    std::string name;
+    int age = 0;
+    double weight = 0.0;
+    bool healthy = true;
+
+    // Mammal
+    bool hasFur = false;
+    std::string furColor;
+    int gestationPeriod = 0;
+
+    // Bird
+    double wingspan = 0.0;
+    bool canFly = false;
+    std::string beakType;
+
+    // Lion
+    int maneSize = 0;
+    bool isAlpha = false;
+
+    // Elephant
+    double trunkLength = 0.0;
+    int tuskLength = 0;
+    bool hasIvory = false;
+
+    // Monkey
+    double tailLength = 0.0;
+    bool isPrehensile = false;
+
+    // Monkey and Penguin sub-species, e.g. "Capuchin" or "Emperor"
+    std::string subSpecies;
+
+    // Eagle
+    double clawLength = 0.0;
+    double visionRange = 0.0;
+    bool isGoldenEagle = false;
+
+    // Penguin
+    double swimSpeed = 0.0;
+    double divingDepth = 0.0;
+
+    // Parrot
+    std::string plumageColor;
+    int intelligenceLevel = 0;
+    std::vector<std::string> vocabulary;
+
+    static AnimalRecord capture(const Animal& animal);
+
+    // New animal of the recorded species with every recorded attribute
+    Animal* materialize() const;
+
+    // Compact binary form (see BinaryCodec.h); decode throws
+    // InvalidOperationException on corrupt input
+    void encode(std::string& out) const;
+    static AnimalRecord decode(const char* data, size_t size);
+};
+
+#endif // ANIMALRECORD_H
@@ -0,0 +1,106 @@
+#include "AnomalyDetector.h"
+#include "Veterinarian.h"
+#include <algorithm>
+#include <cmath>
+
+AnomalyDetector::Settings::Settings()
+    : alpha(0.1f), sigmas(4.0f), warmup(8), minWeightChange(0.02f) {
+}
+
+AnomalyDetector::AnomalyDetector(const Settings& settings)
+    : settings(settings), sigmasSquared(settings.sigmas * settings.sigmas),
+      weightAnomalies(0), healthAnomalies(0) {
+}
+
+void AnomalyDetector::attach(IHealthObserver* observer) {
+    observers.push_back(observer);
+}
+
+void AnomalyDetector::detach(IHealthObserver* observer) {
+    observers.erase(std::remove(observers.begin(), observers.end(), observer), observers.end());
+}
+
+AnomalyDetector::SlotState& AnomalyDetector::stateFor(size_t slot) {
+    if (slot >= slots.size()) {
+        // Value-initialised: zero mean, variance and count
+        slots.resize(slot + 1, SlotState());
+    }
+    return slots[slot];
+}
+
+void AnomalyDetector::update(Model& model, float diff) const {
+    float step = settings.alpha * diff;
+    model.mean += step;
+    model.variance = (1.0f - settings.alpha) * (model.variance + diff * step);
+    if (model.count != UINT32_MAX) {
+        ++model.count;
+    }
+}
+
+void AnomalyDetector::notify(Animal* animal) {
+    // Observers may react by changing the animal, which feeds new readings
+    // back in; that is fine because this slot's model is already updated
+    for (size_t i = 0; i < observers.size(); ++i) {
+        observers[i]->onAnimalSick(animal);
+    }
+}
+
+bool AnomalyDetector::observeWeight(Animal* animal, size_t slot, double weight) {
+    Model& model = stateFor(slot).weight;
+    float x = static_cast<float>(weight);
+    if (model.count == 0) {
+        // The first weighing is the baseline; health starts from "healthy"
+        model.mean = x;
+        model.variance = 0.0f;
+        model.count = 1;
+        return false;
+    }
+    float diff = x - model.mean;
+    bool anomaly = model.count >= settings.warmup
+        && diff * diff > sigmasSquared * model.variance
+        && std::fabs(diff) >= settings.minWeightChange * std::fabs(model.mean);
+    update(model, diff);
+    if (anomaly) {
+        ++weightAnomalies;
+        notify(animal);
+    }
+    return anomaly;
+}
+
+bool AnomalyDetector::observeHealth(Animal* animal, size_t slot, bool healthy) {
+    Model& model = stateFor(slot).health;
+    float x = healthy ? 0.0f : 1.0f;
+    float diff = x - model.mean;
+    bool anomaly = !healthy && diff * diff > sigmasSquared * model.variance;
+    update(model, diff);
+    if (anomaly) {
+        ++healthAnomalies;
+        notify(animal);
+    }
+    return anomaly;
+}
+
+void AnomalyDetector::moveSlot(size_t from, size_t to) {
+    SlotState moved = from < slots.size() ? slots[from] : SlotState();
+    if (from < slots.size() || to < slots.size()) {
+        stateFor(to) = moved;
+    }
+}
+
+void AnomalyDetector::resize(size_t slotCount) {
+    if (slotCount < slots.size()) {
+        slots.resize(slotCount);
+    }
+}
+
+void AnomalyDetector::clear() {
+    slots.clear();
+}
+
+unsigned long long AnomalyDetector::getWeightAnomalies() const {
+    return weightAnomalies;
+}
+
+unsigned long long AnomalyDetector::getHealthAnomalies() const {
+    return healthAnomalies;
+}
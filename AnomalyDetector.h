@@ -0,0 +1,82 @@
+#ifndef ANOMALYDETECTOR_H
+#define ANOMALYDETECTOR_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+class Animal;
+class IHealthObserver;
+
+/**
+ * Streaming anomaly detection on weight and health readings, per zoo slot
+ * Each slot keeps an exponentially weighted mean and variance for its
+ * weight and for its health (0 = healthy, 1 = sick). A reading further
+ * than SIGMAS standard deviations from the mean is an anomaly and every
+ * attached IHealthObserver gets onAnimalSick(). Updates are O(1) and touch
+ * one 24-byte slot record.
+ *
+ * Weight readings only alarm after WARMUP readings and when the change is
+ * at least MIN_WEIGHT_CHANGE of the mean, so the first few weighings and
+ * small wobbles on a very steady series stay quiet. Health starts from a
+ * "healthy" prior, so the first sick reading of a healthy animal alarms,
+ * while an animal that is often sick stops alarming on every reading.
+ */
+class AnomalyDetector {
+public:
+    struct Settings {
+        float alpha;              // weight of the newest reading
+        float sigmas;             // alarm threshold in standard deviations
+        uint32_t warmup;          // weight readings before alarms start
+        float minWeightChange;    // relative to the mean weight
+
+        Settings();
+    };
+
+private:
+    struct Model {
+        float mean;
+        float variance;
+        uint32_t count;
+    };
+
+    struct SlotState {
+        Model weight;
+        Model health;
+    };
+
+    Settings settings;
+    float sigmasSquared;
+    std::vector<SlotState> slots;
+    std::vector<IHealthObserver*> observers;
+    unsigned long long weightAnomalies;
+    unsigned long long healthAnomalies;
+
+    SlotState& stateFor(size_t slot);
+    void notify(Animal* animal);
+
+    // Moves model towards a reading; diff is the reading minus the mean
+    void update(Model& model, float diff) const;
+
+public:
+    explicit AnomalyDetector(const Settings& settings = Settings());
+
+    void attach(IHealthObserver* observer);
+    void detach(IHealthObserver* observer);
+
+    // Feed one reading; returns true if it was an anomaly (observers have
+    // been notified). animal is only passed on to the observers.
+    bool observeWeight(Animal* animal, size_t slot, double weight);
+    bool observeHealth(Animal* animal, size_t slot, bool healthy);
+
+    // Slot bookkeeping, mirroring the zoo (see HealthBitmap::moveSlot)
+    // resize only drops slots at or above slotCount; slots grow on use
+    void moveSlot(size_t from, size_t to);
+    void resize(size_t slotCount);
+    void clear();
+
+    unsigned long long getWeightAnomalies() const;
+    unsigned long long getHealthAnomalies() const;
+};
+
+#endif // ANOMALYDETECTOR_H
@@ -0,0 +1,121 @@
+#include "AtomicFileWriter.h"
+#include "Exceptions.h"
+#include <atomic>
+#include <cerrno>
+#include <utility>
+#ifdef _WIN32
+#include <io.h>
+#include <process.h>
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+    std::atomic<unsigned> nextTemp(0);
+
+    unsigned long processId() {
+#ifdef _WIN32
+        return static_cast<unsigned long>(_getpid());
+#else
+        return static_cast<unsigned long>(getpid());
+#endif
+    }
+}
+
+AtomicFileWriter::AtomicFileWriter(const std::string& path)
+    : path(path), file(nullptr), committed(false) {
+    // Every writer gets its own temp file next to path ("x": create only),
+    // so overlapping saves to one path never share one
+    for (int attempt = 0; attempt < 100 && !file; ++attempt) {
+        tempPath = path + ".tmp." + std::to_string(processId()) + "." + std::to_string(nextTemp++);
+        file = std::fopen(tempPath.c_str(), "wbx");
+        if (!file && errno != EEXIST) {
+            break;
+        }
+    }
+    if (!file) {
+        throw InvalidOperationException("Cannot open file for writing: " + path);
+    }
+    std::setvbuf(file, nullptr, _IONBF, 0);
+    current.reserve(BUFFER_SIZE + 4096);
+    spare.reserve(BUFFER_SIZE + 4096);
+}
+
+AtomicFileWriter::~AtomicFileWriter() {
+    if (pending.valid()) {
+        pending.wait();
+    }
+    if (file) {
+        std::fclose(file);
+    }
+    if (!committed) {
+        std::remove(tempPath.c_str());
+    }
+}
+
+void AtomicFileWriter::writeAll(const std::string& bytes) {
+    if (std::fwrite(bytes.data(), 1, bytes.size(), file) != bytes.size()) {
+        throw InvalidOperationException("Cannot write file: " + path);
+    }
+}
+
+void AtomicFileWriter::flush() {
+    // The previous buffer must be on its way to disk before it is reused
+    if (pending.valid()) {
+        pending.get();
+    }
+    std::swap(current, spare);
+    current.clear();
+    pending = std::async(std::launch::async, [this] { writeAll(spare); });
+}
+
+void AtomicFileWriter::flushIfFull() {
+    if (current.size() >= BUFFER_SIZE) {
+        flush();
+    }
+}
+
+void AtomicFileWriter::rewriteStart(const std::string& bytes) {
+    if (pending.valid()) {
+        pending.get();
+    }
+    writeAll(current);
+    current.clear();
+    if (std::fseek(file, 0, SEEK_SET) != 0) {
+        throw InvalidOperationException("Cannot write file: " + path);
+    }
+    writeAll(bytes);
+    if (std::fseek(file, 0, SEEK_END) != 0) {
+        throw InvalidOperationException("Cannot write file: " + path);
+    }
+}
+
+void AtomicFileWriter::commit() {
+    if (pending.valid()) {
+        pending.get();
+    }
+    writeAll(current);
+    current.clear();
+
+#ifdef _WIN32
+    bool synced = _commit(_fileno(file)) == 0;
+#else
+    bool synced = fsync(fileno(file)) == 0;
+#endif
+    bool closed = std::fclose(file) == 0;
+    file = nullptr;
+    if (!synced || !closed) {
+        throw InvalidOperationException("Cannot write file: " + path);
+    }
+
+#ifdef _WIN32
+    bool renamed = MoveFileExA(tempPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    bool renamed = std::rename(tempPath.c_str(), path.c_str()) == 0;
+#endif
+    if (!renamed) {
+        throw InvalidOperationException("Cannot replace file: " + path);
+    }
+    committed = true;
+}
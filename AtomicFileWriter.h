@@ -0,0 +1,54 @@
+#ifndef ATOMICFILEWRITER_H
+#define ATOMICFILEWRITER_H
+
+#include <cstdio>
+#include <future>
+#include <string>
+
+/**
+ * Writes a file through a temp file next to it and renames that over path
+ * on commit(). Readers of path see either the old file or the complete new
+ * one, never a partial write. Each writer has its own temp file, so
+ * overlapping writes of one path each install a whole file; the last
+ * commit wins. Callers append to buffer() and call flushIfFull();
+ * full buffers go to the OS in BUFFER_SIZE writes on a second thread
+ * while the next buffer fills (stdio buffering is off, so each is one
+ * write call). Without commit() the temp file is removed.
+ */
+class AtomicFileWriter {
+public:
+    static const size_t BUFFER_SIZE = size_t(1) << 20;
+
+private:
+    std::string path;
+    std::string tempPath;
+    std::FILE* file;
+    std::string current;          // being filled by the caller
+    std::string spare;            // being written by pending
+    std::future<void> pending;
+    bool committed;
+
+    void flush();
+    void writeAll(const std::string& bytes);
+
+public:
+    explicit AtomicFileWriter(const std::string& path);
+    ~AtomicFileWriter();
+
+    AtomicFileWriter(const AtomicFileWriter&) = delete;
+    AtomicFileWriter& operator=(const AtomicFileWriter&) = delete;
+
+    std::string& buffer() { return current; }
+    void flushIfFull();
+
+    // Writes out what is buffered, then overwrites the start of the file
+    // with bytes, for headers whose fields are only known at the end.
+    // bytes must not reach past what was written so far.
+    void rewriteStart(const std::string& bytes);
+
+    // Writes what is left, syncs the file to disk and renames it into place
+    // Throws InvalidOperationException if any write failed
+    void commit();
+};
+
+#endif // ATOMICFILEWRITER_H
@@ -0,0 +1,457 @@
+#include "BatchRunner.h"
+#include "Animal.h"
+#include "AnimalFactory.h"
+#include "Exceptions.h"
+#include "Veterinarian.h"
+#include "ColumnarExporter.h"
+#include "ZooDiff.h"
+#include "HistoryStore.h"
+#include "AnomalyDetector.h"
+#include "PopulationReport.h"
+#include "ZooSketches.h"
+#include "AtomicFileWriter.h"
+#include <iostream>
+#include <sstream>
+#include <fstream>
+#include <iterator>
+#include <vector>
+#include <chrono>
+#include <iomanip>
+#include <algorithm>
+#include <thread>
+
+namespace {
+
+/**
+ * Output buffer that only writes to its target when a block fills up
+ * sync() is a no-op so std::endl in animal messages does not force a
+ * write per line.
+ */
+class BlockBuffer : public std::streambuf {
+private:
+    std::streambuf* target;
+    std::vector<char> block;
+
+    void drain() {
+        std::streamsize pending = pptr() - pbase();
+        if (pending > 0) {
+            target->sputn(pbase(), pending);
+        }
+        setp(block.data(), block.data() + block.size());
+    }
+
+protected:
+    int_type overflow(int_type ch) override {
+        drain();
+        if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+            *pptr() = traits_type::to_char_type(ch);
+            pbump(1);
+        }
+        return traits_type::not_eof(ch);
+    }
+
+    int sync() override {
+        return 0;
+    }
+
+public:
+    BlockBuffer(std::streambuf* target, size_t size)
+        : target(target), block(size) {
+        setp(block.data(), block.data() + block.size());
+    }
+
+    ~BlockBuffer() override {
+        drain();
+        target->pubsync();
+    }
+};
+
+const size_t OUTPUT_BLOCK_SIZE = 1 << 20;
+
+// Lines of each kind printed by the diff command
+const size_t DIFF_LINE_LIMIT = 20;
+
+// Prints one line per anomaly reported by monitor-start
+class AlertPrinter : public IHealthObserver {
+public:
+    void onAnimalSick(Animal* animal) override {
+        std::cout << "alert " << animal->getName() << " weight=" << animal->getWeight()
+                  << (animal->getHealthStatus() ? " healthy" : " sick") << '\n';
+    }
+};
+
+} // namespace
+
+BatchRunner::BatchRunner(Zoo& zoo)
+    : zoo(zoo), linesRead(0), failedCommands(0) {
+}
+
+BatchRunner::~BatchRunner() {
+    if (history && zoo.getHistory() == history.get()) {
+        zoo.setHistory(nullptr);
+    }
+    if (monitor && zoo.getAnomalyDetector() == monitor.get()) {
+        zoo.setAnomalyDetector(nullptr);
+    }
+    if (sketches && zoo.getSketches() == sketches.get()) {
+        zoo.setSketches(nullptr);
+    }
+}
+
+HistoryStore& BatchRunner::requireHistory() {
+    if (!history) {
+        throw InvalidOperationException("history is off; run history-start first");
+    }
+    return *history;
+}
+
+unsigned long long BatchRunner::run(std::istream& script) {
+    std::streambuf* console = std::cout.rdbuf();
+    BlockBuffer buffer(console, OUTPUT_BLOCK_SIZE);
+    std::cout.rdbuf(&buffer);
+
+    std::string line;
+    std::istringstream args;
+    while (std::getline(script, line)) {
+        ++linesRead;
+        args.clear();
+        args.str(line);
+
+        std::string command;
+        if (!(args >> command) || command[0] == '#') {
+            continue;
+        }
+
+        CommandStats& entry = stats[command];
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        try {
+            execute(command, args);
+        }
+        catch (const std::exception& e) {
+            std::cout << "error line " << linesRead << ": " << e.what() << '\n';
+            ++entry.failures;
+            ++failedCommands;
+        }
+        std::chrono::duration<double, std::micro> elapsed =
+            std::chrono::steady_clock::now() - start;
+
+        ++entry.count;
+        entry.totalMicros += elapsed.count();
+        if (elapsed.count() > entry.maxMicros) {
+            entry.maxMicros = elapsed.count();
+        }
+    }
+
+    std::cout.rdbuf(console);
+    return failedCommands;
+}
+
+void BatchRunner::execute(const std::string& command, std::istream& args) {
+    if (command == "add") {
+        std::string species, name;
+        int age;
+        double weight;
+        if (!(args >> species >> name >> age >> weight)) {
+            throw InvalidOperationException("usage: add <species> <name> <age> <weight>");
+        }
+        IAnimal* animal = AnimalFactory::createAnimal(species, name, age, weight);
+        try {
+            zoo.addAnimal(animal);
+        } catch (...) {
+            delete animal;
+            throw;
+        }
+    }
+    else if (command == "remove") {
+        std::string name;
+        if (!(args >> name)) {
+            throw InvalidOperationException("usage: remove <name>");
+        }
+        zoo.removeAnimal(name);
+    }
+    else if (command == "find") {
+        std::string name;
+        if (!(args >> name)) {
+            throw InvalidOperationException("usage: find <name>");
+        }
+        // Owned by the zoo, even when just decoded from a lazy archive;
+        // not kept past this command, which may remove or reload it
+        const Animal* a = dynamic_cast<const Animal*>(zoo.tryFindAnimal(name));
+        if (a) {
+            std::cout << a->getName() << ' ' << a->getSpecies()
+                      << " age=" << a->getAge()
+                      << " weight=" << a->getWeight()
+                      << (a->getHealthStatus() ? " healthy" : " sick") << '\n';
+        } else {
+            std::cout << "not-found " << name << '\n';
+        }
+    }
+    else if (command == "count") {
+        std::cout << zoo.getAnimalCount() << '\n';
+    }
+    else if (command == "count-species") {
+        std::string species;
+        if (!(args >> species)) {
+            throw InvalidOperationException("usage: count-species <species>");
+        }
+        std::cout << zoo.countBySpecies(species) << '\n';
+    }
+    else if (command == "total-food") {
+        std::cout << zoo.calculateTotalFoodRequirement() << '\n';
+    }
+    else if (command == "top") {
+        std::string by;
+        size_t k = 0;
+        if (!(args >> by >> k)) {
+            throw InvalidOperationException("usage: top <weight|age|food> <k>");
+        }
+        RankBy rank = by == "weight" ? RankBy::Weight : by == "age" ? RankBy::Age
+                    : by == "food" ? RankBy::Food : RankBy::COUNT;
+        if (rank == RankBy::COUNT) {
+            throw InvalidOperationException("usage: top <weight|age|food> <k>");
+        }
+        for (const Animal* a : zoo.topAnimals(rank, k)) {
+            std::cout << a->getName() << ' ' << a->getSpecies()
+                      << " age=" << a->getAge()
+                      << " weight=" << a->getWeight()
+                      << " food=" << a->calculateFoodRequirement() << '\n';
+        }
+    }
+    else if (command == "complete") {
+        std::string prefix;
+        size_t limit = 20;
+        if (!(args >> prefix)) {
+            throw InvalidOperationException("usage: complete <prefix> [limit]");
+        }
+        args >> limit;
+        for (const std::string& name : zoo.completeName(prefix, limit)) {
+            std::cout << name << '\n';
+        }
+    }
+    else if (command == "report") {
+        PopulationReport report;
+        report.addZoo(zoo);
+        report.print(std::cout);
+    }
+    else if (command == "checkups") {
+        zoo.performDailyCheckups();
+    }
+    else if (command == "sick-count") {
+        std::cout << zoo.getSickCount() << '\n';
+    }
+    else if (command == "treat-sick") {
+        Veterinarian vet("Batch", "General");
+        std::cout << zoo.dispatchVeterinarian(vet) << '\n';
+    }
+    else if (command == "feed") {
+        zoo.feedAllAnimals();
+    }
+    else if (command == "display") {
+        zoo.displayAllAnimals();
+    }
+    else if (command == "save") {
+        std::string filename;
+        if (!(args >> filename)) {
+            throw InvalidOperationException("usage: save <file>");
+        }
+        zoo.saveToFile(filename);
+    }
+    else if (command == "load") {
+        std::string filename;
+        if (!(args >> filename)) {
+            throw InvalidOperationException("usage: load <file>");
+        }
+        zoo.loadFromFile(filename);
+    }
+    else if (command == "save-archive") {
+        std::string filename;
+        if (!(args >> filename)) {
+            throw InvalidOperationException("usage: save-archive <file>");
+        }
+        zoo.saveArchive(filename);
+    }
+    else if (command == "load-lazy") {
+        std::string filename;
+        if (!(args >> filename)) {
+            throw InvalidOperationException("usage: load-lazy <file>");
+        }
+        zoo.loadFromFile(filename, Zoo::LoadMode::Lazy);
+    }
+    else if (command == "export-columns") {
+        std::string filename;
+        if (!(args >> filename)) {
+            throw InvalidOperationException("usage: export-columns <file>");
+        }
+        ColumnarExporter exporter(ColumnarExporter::DEFAULT_ROW_GROUP_SIZE,
+                                  std::max(1u, std::thread::hardware_concurrency()));
+        ColumnarExporter::ExportStats exported = exporter.exportZoo(zoo, filename);
+        std::cout << exported.rows << " rows " << exported.bytes << " bytes\n";
+    }
+    else if (command == "diff") {
+        std::string before, after;
+        if (!(args >> before >> after)) {
+            throw InvalidOperationException("usage: diff <old-file|-> <new-file|->");
+        }
+        unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+        ZooSnapshot old = before == "-" ? ZooSnapshot::fromZoo(zoo, threads)
+                                        : ZooSnapshot::fromFile(before, threads);
+        ZooSnapshot now = after == "-" ? ZooSnapshot::fromZoo(zoo, threads)
+                                       : ZooSnapshot::fromFile(after, threads);
+        ZooDiff::compare(old, now, threads).print(std::cout, DIFF_LINE_LIMIT);
+    }
+    else if (command == "merge") {
+        std::string filename;
+        if (!(args >> filename)) {
+            throw InvalidOperationException("usage: merge <file>");
+        }
+        unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+        ZooDelta delta = ZooDiff::compare(ZooSnapshot::fromZoo(zoo, threads),
+                                          ZooSnapshot::fromFile(filename, threads), threads);
+        delta.apply(zoo);
+        delta.print(std::cout, 0);
+    }
+    else if (command == "history-start") {
+        size_t budgetMb = HistoryStore::DEFAULT_MEMORY_BUDGET >> 20;
+        args >> budgetMb;
+        history.reset(new HistoryStore(budgetMb << 20));
+        zoo.setHistory(history.get());
+    }
+    else if (command == "day") {
+        int32_t day;
+        if (!(args >> day)) {
+            throw InvalidOperationException("usage: day <days-since-1970>");
+        }
+        requireHistory().setDay(day);
+    }
+    else if (command == "weigh") {
+        std::string name;
+        double weight;
+        if (!(args >> name >> weight)) {
+            throw InvalidOperationException("usage: weigh <name> <kg>");
+        }
+        dynamic_cast<Animal*>(zoo.findAnimal(name))->setWeight(weight);
+    }
+    else if (command == "history") {
+        std::string name;
+        int32_t days;
+        if (!(args >> name >> days)) {
+            throw InvalidOperationException("usage: history <name> <days> [bucket-days]");
+        }
+        HistoryStore& store = requireHistory();
+        uint32_t animal = dynamic_cast<Animal*>(zoo.findAnimal(name))->getId();
+        int32_t last = store.currentDay();
+        int32_t bucketDays = 0;
+        if (args >> bucketDays) {
+            for (const HistoryBucket& b : store.rollup(animal, last - days + 1, last, bucketDays)) {
+                std::cout << "day " << b.firstDay << " samples=" << b.days
+                          << " min=" << b.minWeight << " mean=" << b.meanWeight
+                          << " max=" << b.maxWeight << " sick=" << b.sickDays << '\n';
+            }
+        } else {
+            for (const HistorySample& s : store.query(animal, last - days + 1, last)) {
+                std::cout << "day " << s.day << " weight=" << s.weight
+                          << (s.healthy ? " healthy" : " sick") << '\n';
+            }
+        }
+    }
+    else if (command == "monitor-start") {
+        AnomalyDetector::Settings settings;
+        args >> settings.sigmas;
+        zoo.setAnomalyDetector(nullptr);
+        monitor.reset(new AnomalyDetector(settings));
+        monitorOutput.reset(new AlertPrinter());
+        monitor->attach(monitorOutput.get());
+        zoo.setAnomalyDetector(monitor.get());
+    }
+    else if (command == "monitor") {
+        if (!monitor) {
+            throw InvalidOperationException("monitor is off; run monitor-start first");
+        }
+        std::cout << "weight-anomalies=" << monitor->getWeightAnomalies()
+                  << " health-anomalies=" << monitor->getHealthAnomalies() << '\n';
+    }
+    else if (command == "sketch-start") {
+        zoo.setSketches(nullptr);
+        sketches.reset(new ZooSketches());
+        zoo.setSketches(sketches.get());
+    }
+    else if (command == "sketch") {
+        // This zoo's sketch merged with any saved by sketch-save elsewhere
+        PopulationSketch merged;
+        if (sketches) {
+            merged = sketches->getSketch();
+        }
+        std::string filename;
+        while (args >> filename) {
+            std::ifstream in(filename, std::ios::binary);
+            if (!in) {
+                throw InvalidOperationException("Cannot open file for reading: " + filename);
+            }
+            std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+            merged.merge(PopulationSketch::decode(data));
+        }
+        merged.print(std::cout);
+    }
+    else if (command == "sketch-save") {
+        std::string filename;
+        if (!(args >> filename)) {
+            throw InvalidOperationException("usage: sketch-save <file>");
+        }
+        if (!sketches) {
+            throw InvalidOperationException("sketches are off; run sketch-start first");
+        }
+        AtomicFileWriter writer(filename);
+        writer.buffer() = sketches->getSketch().encode();
+        writer.commit();
+    }
+    else {
+        throw InvalidOperationException("unknown command '" + command + "'");
+    }
+}
+
+void BatchRunner::printTimings(std::ostream& report) const {
+    report << "\n=== Batch Timing ===" << std::endl;
+    report << std::left << std::setw(16) << "command"
+           << std::right << std::setw(12) << "count"
+           << std::setw(10) << "failed"
+           << std::setw(14) << "mean (us)"
+           << std::setw(14) << "max (us)" << std::endl;
+
+    double totalMicros = 0.0;
+    unsigned long long totalCount = 0;
+    for (const auto& entry : stats) {
+        const CommandStats& s = entry.second;
+        report << std::left << std::setw(16) << entry.first
+               << std::right << std::setw(12) << s.count
+               << std::setw(10) << s.failures
+               << std::setw(14) << std::fixed << std::setprecision(3)
+               << (s.count ? s.totalMicros / s.count : 0.0)
+               << std::setw(14) << s.maxMicros << std::endl;
+        totalMicros += s.totalMicros;
+        totalCount += s.count;
+    }
+    report.unsetf(std::ios::floatfield);
+    report << "Commands: " << totalCount << "  failed: " << failedCommands
+           << "  time: " << totalMicros / 1000.0 << " ms" << std::endl;
+}
+
+void BatchRunner::printCommands(std::ostream& out) {
+    out << "Batch commands:" << std::endl;
+    out << "  add <species> <name> <age> <weight>" << std::endl;
+    out << "  remove <name>" << std::endl;
+    out << "  find <name>" << std::endl;
+    out << "  count | count-species <species> | total-food | report" << std::endl;
+    out << "  top <weight|age|food> <k>   (heaviest, oldest, hungriest first)" << std::endl;
+    out << "  complete <prefix> [limit]   (names starting with prefix, default 20)" << std::endl;
+    out << "  checkups | feed | display" << std::endl;
+    out << "  sick-count | treat-sick" << std::endl;
+    out << "  save <file> | load <file>" << std::endl;
+    out << "  save-archive <file> | load-lazy <file>" << std::endl;
+    out << "  export-columns <file>" << std::endl;
+    out << "  diff <old-file|-> <new-file|->   (- is the zoo in memory)" << std::endl;
+    out << "  merge <file>   (apply the file's changes to the zoo)" << std::endl;
+    out << "  history-start [budget-mb] | day <n> | weigh <name> <kg>" << std::endl;
+    out << "  history <name> <days> [bucket-days]   (last days, raw or downsampled)" << std::endl;
+    out << "  monitor-start [sigmas] | monitor   (alert on unusual weight/health)" << std::endl;
+    out << "  sketch-start | sketch-save <file> | sketch [file...]   (approximate quantiles, merged)" << std::endl;
+}
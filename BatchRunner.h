@@ -0,0 +1,73 @@
+#ifndef BATCHRUNNER_H
+#define BATCHRUNNER_H
+
+#include "Zoo.h"
+#include <istream>
+#include <ostream>
+#include <string>
+#include <map>
+#include <memory>
+
+class HistoryStore;
+class AnomalyDetector;
+class IHealthObserver;
+class ZooSketches;
+
+/**
+ * Non-interactive command interpreter for scripted runs
+ * Reads one command per line, e.g.:
+ *   add lion Simba 5 190
+ *   find Simba
+ *   total-food
+ *   save zoo.txt
+ * Blank lines and lines starting with '#' are ignored.
+ * All output (including animal messages) is collected in a large block
+ * buffer and written out in chunks instead of being flushed per line.
+ */
+class BatchRunner {
+private:
+    struct CommandStats {
+        unsigned long long count;
+        unsigned long long failures;
+        double totalMicros;
+        double maxMicros;
+
+        CommandStats() : count(0), failures(0), totalMicros(0.0), maxMicros(0.0) {}
+    };
+
+    Zoo& zoo;
+    std::map<std::string, CommandStats> stats;
+    unsigned long long linesRead;
+    unsigned long long failedCommands;
+
+    // Created by history-start and attached to the zoo
+    std::unique_ptr<HistoryStore> history;
+
+    // Created by monitor-start; alerts are printed by monitorOutput
+    std::unique_ptr<AnomalyDetector> monitor;
+    std::unique_ptr<IHealthObserver> monitorOutput;
+
+    // Created by sketch-start and attached to the zoo
+    std::unique_ptr<ZooSketches> sketches;
+
+    HistoryStore& requireHistory();
+    void execute(const std::string& command, std::istream& args);
+
+public:
+    explicit BatchRunner(Zoo& zoo);
+    ~BatchRunner();
+
+    BatchRunner(const BatchRunner&) = delete;
+    BatchRunner& operator=(const BatchRunner&) = delete;
+
+    // Run every command in script, writing results to std::cout
+    // Returns the number of commands that failed
+    unsigned long long run(std::istream& script);
+
+    // Per-command count, failures and mean/max latency
+    void printTimings(std::ostream& report) const;
+
+    static void printCommands(std::ostream& out);
+};
+
+#endif // BATCHRUNNER_H
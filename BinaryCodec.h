@@ -0,0 +1,145 @@
+#ifndef BINARYCODEC_H
+#define BINARYCODEC_H
+
+#include "Exceptions.h"
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Little-endian byte encoding shared by the file formats
+ * (columnar export, zoo archive). Writers append to a std::string;
+ * Reader is bounds-checked and throws InvalidOperationException on
+ * truncated or corrupt input.
+ */
+namespace BinaryCodec {
+
+inline void putU8(std::string& out, uint8_t value) {
+    out.push_back(static_cast<char>(value));
+}
+
+inline void putU32(std::string& out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+inline void putU64(std::string& out, uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+inline void putVarint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+inline void putZigzag(std::string& out, int64_t value) {
+    putVarint(out, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+}
+
+inline void putF64(std::string& out, double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    putU64(out, bits);
+}
+
+inline void putText(std::string& out, const std::string& value) {
+    putVarint(out, value.size());
+    out.append(value);
+}
+
+// FNV-1a: stable across platforms, so it can be stored in files
+inline uint64_t hash64(const char* data, size_t size) {
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+class Reader {
+private:
+    const unsigned char* data;
+    size_t size;
+    size_t pos;
+
+    void need(size_t bytes) {
+        if (bytes > size - pos) {
+            throw InvalidOperationException("Corrupt or truncated data");
+        }
+    }
+
+public:
+    Reader(const char* data, size_t size)
+        : data(reinterpret_cast<const unsigned char*>(data)), size(size), pos(0) {}
+
+    explicit Reader(const std::string& data) : Reader(data.data(), data.size()) {}
+
+    uint8_t u8() {
+        need(1);
+        return data[pos++];
+    }
+
+    uint32_t u32() {
+        need(4);
+        uint32_t value = 0;
+        for (int i = 0; i < 4; ++i) {
+            value |= static_cast<uint32_t>(data[pos + i]) << (8 * i);
+        }
+        pos += 4;
+        return value;
+    }
+
+    uint64_t u64() {
+        need(8);
+        uint64_t value = 0;
+        for (int i = 0; i < 8; ++i) {
+            value |= static_cast<uint64_t>(data[pos + i]) << (8 * i);
+        }
+        pos += 8;
+        return value;
+    }
+
+    uint64_t varint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            uint8_t byte = u8();
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return value;
+        }
+        throw InvalidOperationException("Corrupt or truncated data");
+    }
+
+    int64_t zigzag() {
+        uint64_t raw = varint();
+        return static_cast<int64_t>(raw >> 1) ^ -static_cast<int64_t>(raw & 1);
+    }
+
+    double f64() {
+        uint64_t bits = u64();
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    std::string text() {
+        size_t length = static_cast<size_t>(varint());
+        need(length);
+        std::string value(reinterpret_cast<const char*>(data + pos), length);
+        pos += length;
+        return value;
+    }
+
+    bool atEnd() const { return pos == size; }
+};
+
+} // namespace BinaryCodec
+
+#endif // BINARYCODEC_H
@@ -3,8 +3,8 @@
 
 Bird::Bird(std::string name, int age, double weight,
            double wingspan, bool canFly, std::string beakType)
-    : Animal(name, age, weight), wingspan(wingspan), canFly(canFly),
-      beakType(beakType) {
+    : Animal(name, age, weight), beakType(beakType),
+      wingspan(static_cast<float>(wingspan)), canFly(canFly) {
 }
 
 void Bird::displayInfo() const {
@@ -39,6 +39,6 @@ bool Bird::getCanFly() const {
     return canFly;
 }
 
-std::string Bird::getBeakType() const {
+const std::string& Bird::getBeakType() const {
     return beakType;
 }
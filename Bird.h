@@ -2,6 +2,7 @@
 #define BIRD_H
 
 #include "Animal.h"
+#include "InternTable.h"
 
 /**
  * Level 1: Bird class inheriting from Animal
@@ -9,9 +10,9 @@
  */
 class Bird : public Animal {
 protected:
-    double wingspan;
+    InternedString beakType;
+    float wingspan; // meters
     bool canFly;
-    std::string beakType;
 
 public:
     Bird(std::string name, int age, double weight,
@@ -26,7 +27,7 @@ public:
 
     double getWingspan() const;
     bool getCanFly() const;
-    std::string getBeakType() const;
+    const std::string& getBeakType() const;
 };
 
 #endif // BIRD_H
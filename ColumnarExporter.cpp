@@ -0,0 +1,531 @@
+#include "ColumnarExporter.h"
+#include "AnimalRecord.h"
+#include "BinaryCodec.h"
+#include "Exceptions.h"
+#include "AtomicFileWriter.h"
+#include "Zoo.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace BinaryCodec;
+
+namespace {
+
+const char MAGIC[4] = { 'Z', 'C', 'O', 'L' };
+const uint8_t FORMAT_VERSION = 1;
+
+enum ColumnType : uint8_t {
+    COLUMN_INT = 0,
+    COLUMN_REAL = 1,
+    COLUMN_BOOL = 2,
+    COLUMN_STRING = 3,
+    COLUMN_STRING_LIST = 4
+};
+
+enum StringEncoding : uint8_t {
+    ENCODING_DICTIONARY = 0,
+    ENCODING_PLAIN = 1
+};
+
+const char* typeName(uint8_t type) {
+    switch (type) {
+        case COLUMN_INT: return "int";
+        case COLUMN_REAL: return "real";
+        case COLUMN_BOOL: return "bool";
+        case COLUMN_STRING: return "string";
+        case COLUMN_STRING_LIST: return "list<string>";
+        default: return "?";
+    }
+}
+
+// ---- Column chunks ----
+
+struct ColumnStats {
+    uint64_t values = 0;
+    bool hasRange = false;
+    int64_t minInt = 0;
+    int64_t maxInt = 0;
+    double minReal = 0.0;
+    double maxReal = 0.0;
+    std::string minText;
+    std::string maxText;
+
+    void addInt(int64_t value) {
+        minInt = hasRange ? std::min(minInt, value) : value;
+        maxInt = hasRange ? std::max(maxInt, value) : value;
+        hasRange = true;
+    }
+
+    void addReal(double value) {
+        minReal = hasRange ? std::min(minReal, value) : value;
+        maxReal = hasRange ? std::max(maxReal, value) : value;
+        hasRange = true;
+    }
+
+    void addText(const std::string& value) {
+        if (!hasRange || value < minText) minText = value;
+        if (!hasRange || value > maxText) maxText = value;
+        hasRange = true;
+    }
+
+    void merge(uint8_t type, const ColumnStats& other) {
+        values += other.values;
+        if (!other.hasRange) return;
+        if (type == COLUMN_REAL) {
+            addReal(other.minReal);
+            addReal(other.maxReal);
+        } else if (type == COLUMN_STRING) {
+            addText(other.minText);
+            addText(other.maxText);
+        } else {
+            addInt(other.minInt);
+            addInt(other.maxInt);
+        }
+    }
+
+    void write(std::string& out, uint8_t type) const {
+        putVarint(out, values);
+        putU8(out, hasRange ? 1 : 0);
+        if (!hasRange) return;
+        if (type == COLUMN_REAL) {
+            putF64(out, minReal);
+            putF64(out, maxReal);
+        } else if (type == COLUMN_STRING) {
+            putText(out, minText);
+            putText(out, maxText);
+        } else {
+            putZigzag(out, minInt);
+            putZigzag(out, maxInt);
+        }
+    }
+
+    void read(Reader& in, uint8_t type) {
+        values = in.varint();
+        hasRange = in.u8() != 0;
+        if (!hasRange) return;
+        if (type == COLUMN_REAL) {
+            minReal = in.f64();
+            maxReal = in.f64();
+        } else if (type == COLUMN_STRING) {
+            minText = in.text();
+            maxText = in.text();
+        } else {
+            minInt = in.zigzag();
+            maxInt = in.zigzag();
+        }
+    }
+};
+
+/**
+ * One column of one row group while it is being built
+ * Sparse columns record a presence bit per row and only store values
+ * for present rows. Bool stats are 0/1, list stats are list lengths.
+ */
+class ColumnChunk {
+private:
+    uint8_t type;
+    bool sparse;
+    size_t row;
+    std::vector<uint8_t> presence;
+    std::string values;
+    std::vector<uint8_t> bits;
+    size_t bitCount;
+    std::unordered_map<std::string, uint32_t> dictionary;
+    std::vector<const std::string*> entries;
+    std::vector<uint32_t> ids;
+    ColumnStats stats;
+
+    void present() {
+        if (sparse) {
+            presence[row / 8] |= static_cast<uint8_t>(1u << (row % 8));
+        }
+        ++row;
+        ++stats.values;
+    }
+
+    uint32_t idOf(const std::string& value) {
+        auto found = dictionary.find(value);
+        if (found != dictionary.end()) {
+            return found->second;
+        }
+        uint32_t id = static_cast<uint32_t>(entries.size());
+        entries.push_back(&dictionary.emplace(value, id).first->first);
+        return id;
+    }
+
+public:
+    ColumnChunk(uint8_t type, bool sparse, size_t rows)
+        : type(type), sparse(sparse), row(0),
+          presence(sparse ? (rows + 7) / 8 : 0, 0), bitCount(0) {
+    }
+
+    void skip() {
+        ++row;
+    }
+
+    void addInt(int64_t value) {
+        present();
+        putZigzag(values, value);
+        stats.addInt(value);
+    }
+
+    void addReal(double value) {
+        present();
+        putF64(values, value);
+        stats.addReal(value);
+    }
+
+    void addBool(bool value) {
+        present();
+        if (bitCount % 8 == 0) bits.push_back(0);
+        if (value) bits.back() |= static_cast<uint8_t>(1u << (bitCount % 8));
+        ++bitCount;
+        stats.addInt(value ? 1 : 0);
+    }
+
+    void addText(const std::string& value) {
+        present();
+        ids.push_back(idOf(value));
+        stats.addText(value);
+    }
+
+    void addList(const std::vector<std::string>& list) {
+        present();
+        putVarint(values, list.size());
+        for (const std::string& value : list) {
+            putVarint(values, idOf(value));
+        }
+        stats.addInt(static_cast<int64_t>(list.size()));
+    }
+
+    void encode(std::string& out) const {
+        putU8(out, sparse ? 1 : 0);
+        out.append(presence.begin(), presence.end());
+        if (type == COLUMN_STRING) {
+            // Mostly-unique columns (names) are cheaper without a dictionary
+            bool plain = entries.size() * 2 > ids.size();
+            putU8(out, plain ? ENCODING_PLAIN : ENCODING_DICTIONARY);
+            if (plain) {
+                for (uint32_t id : ids) {
+                    putText(out, *entries[id]);
+                }
+                return;
+            }
+        }
+        if (type == COLUMN_STRING || type == COLUMN_STRING_LIST) {
+            putVarint(out, entries.size());
+            for (const std::string* entry : entries) {
+                putText(out, *entry);
+            }
+        }
+        if (type == COLUMN_STRING) {
+            for (uint32_t id : ids) {
+                putVarint(out, id);
+            }
+        } else if (type == COLUMN_BOOL) {
+            out.append(bits.begin(), bits.end());
+        } else {
+            out.append(values);
+        }
+    }
+
+    const ColumnStats& getStats() const {
+        return stats;
+    }
+};
+
+// ---- Schema ----
+
+const uint32_t ALL_SPECIES = 0xFFFFFFFFu;
+
+constexpr uint32_t maskOf(SpeciesId species) {
+    return 1u << static_cast<int>(species);
+}
+
+const uint32_t MAMMALS = maskOf(SpeciesId::Lion) | maskOf(SpeciesId::Elephant) | maskOf(SpeciesId::Monkey);
+const uint32_t BIRDS = maskOf(SpeciesId::Eagle) | maskOf(SpeciesId::Penguin) | maskOf(SpeciesId::Parrot);
+
+struct ColumnDef {
+    const char* group;
+    const char* name;
+    uint8_t type;
+    uint32_t speciesMask;
+    void (*append)(const AnimalRecord& record, ColumnChunk& chunk);
+};
+
+const ColumnDef COLUMNS[] = {
+    { "animal", "species", COLUMN_STRING, ALL_SPECIES,
+      [](const AnimalRecord& r, ColumnChunk& c) { c.addText(speciesName(r.species)); } },
+    { "animal", "name", COLUMN_STRING, ALL_SPECIES,
+      [](const AnimalRecord& r, ColumnChunk& c) { c.addText(r.name); } },
+    { "animal", "age", COLUMN_INT, ALL_SPECIES,
+      [](const AnimalRecord& r, ColumnChunk& c) { c.addInt(r.age); } },
+    { "animal", "weight", COLUMN_REAL, ALL_SPECIES,
+      [](const AnimalRecord& r, ColumnChunk& c) { c.addReal(r.weight); } },
+    { "animal", "healthy", COLUMN_BOOL, ALL_SPECIES,
+      [](const AnimalRecord& r, ColumnChunk& c) { c.addBool(r.healthy); } },
+
+    { "mammal", "hasFur", COLUMN_BOOL, MAMMALS,
+      [](const AnimalRecord& r, ColumnChunk& c) { c.addBool(r.hasFur); } },
+    { "mammal", "furColor", COLUMN_STRING, MAMMALS,
+      [](const AnimalRecord& r, ColumnChunk& c) { c.addText(r.furColor); } },
+    { "mammal", "gestationPeriod", COLUMN_INT, MAMMALS,
+      [](const AnimalRecord& r, ColumnChunk& c) { c.addInt(r.gestationPeriod); } },
+
+    { "bird", "wingspan", COLUMN_REAL, BIRDS,
+      [](const AnimalRecord& r, ColumnChunk& c) { c.addReal(r.wingspan); } },
+    { "bird", "canFly", COLUMN_BOOL, BIRDS,
+      [](const AnimalRecord& r, ColumnChunk& c) { c.addBool(r.canFly); } },
+    { "bird", "beakType", COLUMN_STRING, BIRDS,
+      [](const AnimalRecord& r, ColumnChunk& c) { c.addText(r.beakType); } },
+
+    { "lion", "maneSize", COLUMN_INT, maskOf(SpeciesId::Lion),
+      [](const AnimalRecord& r, ColumnChunk& c) { c.addInt(r.maneSize); } },
+    { "lion", "isAlpha", COLUMN_BOOL, maskOf(SpeciesId::Lion),
+      [](const AnimalRecord& r, ColumnChunk& c) { c.addBool(r.isAlpha); } },
+
+    { "elephant", "trunkLength", COLUMN_REAL, maskOf(SpeciesId::Elephant),
+      [](const AnimalRecord& r, ColumnChunk& c) { c.addReal(r.trunkLength); } },
+    { "elephant", "tuskLength", COLUMN_INT, maskOf(SpeciesId::Elephant),
+      [](const AnimalRecord& r, ColumnChunk& c) { c.addInt(r.tuskLength); } },
+    { "elephant", "hasIvory", COLUMN_BOOL, maskOf(SpeciesId::Elephant),
+      [](const AnimalRecord& r, ColumnChunk& c) { c.addBool(r.hasIvory); } },
+
+    { "monkey", "monkeyType", COLUMN_STRING, maskOf(SpeciesId::Monkey),
+      [](const AnimalRecord& r, ColumnChunk& c) { c.addText(r.subSpecies); } },
+    { "monkey", "tailLength", COLUMN_REAL, maskOf(SpeciesId::Monkey),
+      [](const AnimalRecord& r, ColumnChunk& c) { c.addReal(r.tailLength); } },
+    { "monkey", "isPrehensile", COLUMN_BOOL, maskOf(SpeciesId::Monkey),
+      [](const AnimalRecord& r, ColumnChunk& c) { c.addBool(r.isPrehensile); } },
+
+    { "eagle", "clawLength", COLUMN_REAL, maskOf(SpeciesId::Eagle),
+      [](const AnimalRecord& r, ColumnChunk& c) { c.addReal(r.clawLength); } },
+    { "eagle", "visionRange", COLUMN_REAL, maskOf(SpeciesId::Eagle),
+      [](const AnimalRecord& r, ColumnChunk& c) { c.addReal(r.visionRange); } },
+    { "eagle", "isGoldenEagle", COLUMN_BOOL, maskOf(SpeciesId::Eagle),
+      [](const AnimalRecord& r, ColumnChunk& c) { c.addBool(r.isGoldenEagle); } },
+
+    { "penguin", "penguinType", COLUMN_STRING, maskOf(SpeciesId::Penguin),
+      [](const AnimalRecord& r, ColumnChunk& c) { c.addText(r.subSpecies); } },
+    { "penguin", "swimSpeed", COLUMN_REAL, maskOf(SpeciesId::Penguin),
+      [](const AnimalRecord& r, ColumnChunk& c) { c.addReal(r.swimSpeed); } },
+    { "penguin", "divingDepth", COLUMN_REAL, maskOf(SpeciesId::Penguin),
+      [](const AnimalRecord& r, ColumnChunk& c) { c.addReal(r.divingDepth); } },
+
+    { "parrot", "plumageColor", COLUMN_STRING, maskOf(SpeciesId::Parrot),
+      [](const AnimalRecord& r, ColumnChunk& c) { c.addText(r.plumageColor); } },
+    { "parrot", "intelligenceLevel", COLUMN_INT, maskOf(SpeciesId::Parrot),
+      [](const AnimalRecord& r, ColumnChunk& c) { c.addInt(r.intelligenceLevel); } },
+    { "parrot", "vocabulary", COLUMN_STRING_LIST, maskOf(SpeciesId::Parrot),
+      [](const AnimalRecord& r, ColumnChunk& c) { c.addList(r.vocabulary); } },
+};
+
+const size_t COLUMN_COUNT = sizeof(COLUMNS) / sizeof(COLUMNS[0]);
+
+// ---- Row groups ----
+
+struct ChunkMeta {
+    uint64_t offset;   // relative to the start of the row group
+    uint64_t length;
+    ColumnStats stats;
+};
+
+struct EncodedGroup {
+    std::string bytes;
+    uint64_t rows = 0;
+    std::vector<ChunkMeta> chunks;
+};
+
+void encodeGroup(const std::vector<IAnimal*>& animals, size_t begin, size_t end, EncodedGroup& group) {
+    std::vector<AnimalRecord> records;
+    records.reserve(end - begin);
+    for (size_t i = begin; i < end; ++i) {
+        const Animal* animal = dynamic_cast<const Animal*>(animals[i]);
+        if (animal) {
+            records.push_back(AnimalRecord::capture(*animal));
+        }
+    }
+
+    group.rows = records.size();
+    group.chunks.resize(COLUMN_COUNT);
+    for (size_t c = 0; c < COLUMN_COUNT; ++c) {
+        const ColumnDef& def = COLUMNS[c];
+        ColumnChunk chunk(def.type, def.speciesMask != ALL_SPECIES, records.size());
+        for (const AnimalRecord& record : records) {
+            if (def.speciesMask & maskOf(record.species)) {
+                def.append(record, chunk);
+            } else {
+                chunk.skip();
+            }
+        }
+        group.chunks[c].offset = group.bytes.size();
+        chunk.encode(group.bytes);
+        group.chunks[c].length = group.bytes.size() - group.chunks[c].offset;
+        group.chunks[c].stats = chunk.getStats();
+    }
+}
+
+void writeBytes(AtomicFileWriter& writer, const std::string& bytes) {
+    writer.buffer() += bytes;
+    writer.flushIfFull();
+}
+
+} // namespace
+
+ColumnarExporter::ColumnarExporter(size_t rowGroupSize, unsigned threads)
+    : rowGroupSize(std::max<size_t>(1, rowGroupSize)), threads(std::max(1u, threads)) {
+}
+
+ColumnarExporter::ExportStats ColumnarExporter::exportZoo(const Zoo& zoo, const std::string& path) const {
+    // Replaces path only once the whole file is on disk
+    AtomicFileWriter writer(path);
+
+    std::string header(MAGIC, sizeof(MAGIC));
+    putU8(header, FORMAT_VERSION);
+    writeBytes(writer, header);
+    uint64_t position = header.size();
+
+    // Footer is built as the row groups go out
+    std::string footer;
+    std::string groupIndex;
+    ExportStats result = { 0, 0, 0 };
+
+    const std::vector<IAnimal*>& animals = zoo.getAnimals();
+    size_t next = 0;
+    std::vector<EncodedGroup> wave;
+    while (next < animals.size()) {
+        // Encode up to `threads` row groups in parallel, then write them in order
+        size_t groups = std::min<size_t>(threads, (animals.size() - next + rowGroupSize - 1) / rowGroupSize);
+        wave.assign(groups, EncodedGroup());
+        std::vector<std::thread> workers;
+        for (size_t g = 0; g < groups; ++g) {
+            size_t begin = next + g * rowGroupSize;
+            size_t end = std::min(animals.size(), begin + rowGroupSize);
+            workers.emplace_back(encodeGroup, std::cref(animals), begin, end, std::ref(wave[g]));
+        }
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+        next = std::min(animals.size(), next + groups * rowGroupSize);
+
+        for (const EncodedGroup& group : wave) {
+            putU64(groupIndex, position);
+            putVarint(groupIndex, group.rows);
+            for (size_t c = 0; c < COLUMN_COUNT; ++c) {
+                putVarint(groupIndex, group.chunks[c].offset);
+                putVarint(groupIndex, group.chunks[c].length);
+                group.chunks[c].stats.write(groupIndex, COLUMNS[c].type);
+            }
+            writeBytes(writer, group.bytes);
+            position += group.bytes.size();
+            result.rows += group.rows;
+            ++result.rowGroups;
+        }
+    }
+
+    putVarint(footer, rowGroupSize);
+    putVarint(footer, COLUMN_COUNT);
+    for (const ColumnDef& def : COLUMNS) {
+        putText(footer, def.group);
+        putText(footer, def.name);
+        putU8(footer, def.type);
+        putVarint(footer, def.speciesMask);
+    }
+    putVarint(footer, result.rows);
+    putVarint(footer, result.rowGroups);
+    footer += groupIndex;
+    putU64(footer, position);
+    footer.append(MAGIC, sizeof(MAGIC));
+    writeBytes(writer, footer);
+    writer.commit();
+
+    result.bytes = position + footer.size();
+    return result;
+}
+
+void ColumnarExporter::describe(const std::string& path, std::ostream& out) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        throw InvalidOperationException("Cannot open file for reading: " + path);
+    }
+    const std::streamoff trailerSize = 8 + sizeof(MAGIC);
+    std::streamoff fileSize = file.tellg();
+    if (fileSize < static_cast<std::streamoff>(sizeof(MAGIC) + 1) + trailerSize) {
+        throw InvalidOperationException("Not a columnar zoo file: " + path);
+    }
+
+    std::string trailer(static_cast<size_t>(trailerSize), '\0');
+    file.seekg(fileSize - trailerSize);
+    file.read(&trailer[0], trailerSize);
+    if (std::memcmp(trailer.data() + 8, MAGIC, sizeof(MAGIC)) != 0) {
+        throw InvalidOperationException("Not a columnar zoo file: " + path);
+    }
+    uint64_t footerOffset = Reader(trailer).u64();
+    if (footerOffset > static_cast<uint64_t>(fileSize - trailerSize)) {
+        throw InvalidOperationException("Corrupt columnar file");
+    }
+
+    std::string footer(static_cast<size_t>(fileSize - trailerSize - static_cast<std::streamoff>(footerOffset)), '\0');
+    file.seekg(static_cast<std::streamoff>(footerOffset));
+    file.read(&footer[0], static_cast<std::streamsize>(footer.size()));
+
+    Reader in(footer);
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision(6);
+    out.unsetf(std::ios::floatfield);
+
+    uint64_t groupSize = in.varint();
+    size_t columns = static_cast<size_t>(in.varint());
+    std::vector<std::string> names(columns);
+    std::vector<uint8_t> types(columns);
+    for (size_t c = 0; c < columns; ++c) {
+        std::string group = in.text();
+        names[c] = group + "." + in.text();
+        types[c] = in.u8();
+        in.varint(); // species mask
+    }
+    uint64_t rows = in.varint();
+    uint64_t groups = in.varint();
+
+    std::vector<ColumnStats> totals(columns);
+    std::vector<uint64_t> bytes(columns, 0);
+    for (uint64_t g = 0; g < groups; ++g) {
+        in.u64();    // row group offset
+        in.varint(); // row count
+        for (size_t c = 0; c < columns; ++c) {
+            in.varint(); // chunk offset
+            bytes[c] += in.varint();
+            ColumnStats stats;
+            stats.read(in, types[c]);
+            totals[c].merge(types[c], stats);
+        }
+    }
+
+    out << "\n=== Columnar Export: " << path << " ===" << std::endl;
+    out << "Rows: " << rows << "  row groups: " << groups
+        << " (up to " << groupSize << " rows)  bytes: " << fileSize << std::endl;
+    out << std::left << std::setw(28) << "column" << std::setw(14) << "type"
+        << std::right << std::setw(10) << "values" << std::setw(12) << "bytes"
+        << "  min .. max" << std::endl;
+    for (size_t c = 0; c < columns; ++c) {
+        out << std::left << std::setw(28) << names[c] << std::setw(14) << typeName(types[c])
+            << std::right << std::setw(10) << totals[c].values << std::setw(12) << bytes[c] << "  ";
+        if (!totals[c].hasRange) {
+            out << "-";
+        } else if (types[c] == COLUMN_REAL) {
+            out << totals[c].minReal << " .. " << totals[c].maxReal;
+        } else if (types[c] == COLUMN_STRING) {
+            out << totals[c].minText << " .. " << totals[c].maxText;
+        } else {
+            out << totals[c].minInt << " .. " << totals[c].maxInt;
+        }
+        out << std::endl;
+    }
+    out.flags(flags);
+    out.precision(precision);
+}
@@ -0,0 +1,55 @@
+#ifndef COLUMNAREXPORTER_H
+#define COLUMNAREXPORTER_H
+
+#include <string>
+#include <ostream>
+#include <cstddef>
+#include <cstdint>
+
+class Zoo;
+
+/**
+ * Column-oriented export of a zoo for offline analysis
+ *
+ * File layout (all integers little-endian):
+ *   "ZCOL" version
+ *   row group 0 .. row group N-1
+ *   footer: schema, then per row group its offset, row count and, per
+ *           column, chunk offset/length, value count and min/max
+ *   footer offset (u64) "ZCOL"
+ *
+ * There is one column per attribute, including the fields of the concrete
+ * classes. Species-specific columns (e.g. lion.maneSize) are grouped by
+ * species and store a presence bitmap plus values only for the rows they
+ * apply to. Strings are dictionary-encoded per chunk (plain when most
+ * values are unique, e.g. names), integers are zigzag
+ * varints, doubles are raw IEEE-754 and booleans are bit-packed.
+ *
+ * The zoo is streamed one row group at a time: worker threads each encode
+ * a row group and the groups are written in order, so memory stays at
+ * about threads x rowGroupSize records regardless of zoo size.
+ */
+class ColumnarExporter {
+public:
+    struct ExportStats {
+        size_t rows;
+        size_t rowGroups;
+        uint64_t bytes;
+    };
+
+    ColumnarExporter(size_t rowGroupSize, unsigned threads);
+
+    // Writes the zoo to path; throws InvalidOperationException on I/O errors
+    ExportStats exportZoo(const Zoo& zoo, const std::string& path) const;
+
+    // Reads a file's footer and prints its schema and column statistics
+    static void describe(const std::string& path, std::ostream& out);
+
+    static constexpr size_t DEFAULT_ROW_GROUP_SIZE = 65536;
+
+private:
+    size_t rowGroupSize;
+    unsigned threads;
+};
+
+#endif // COLUMNAREXPORTER_H
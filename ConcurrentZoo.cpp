@@ -0,0 +1,70 @@
+#include "ConcurrentZoo.h"
+#include "Veterinarian.h"
+
+ConcurrentZoo::ConcurrentZoo(Zoo& zoo) : zoo(zoo) {
+    // Loading an archive and building the rankings and name index change
+    // the zoo from inside const members, so they must happen before
+    // readers run in parallel
+    zoo.getAnimals();
+    zoo.topAnimals(RankBy::Weight, 0);
+    zoo.completeName(std::string(), 0);
+}
+
+ZooStatus ConcurrentZoo::tryAddAnimal(IAnimal* animal) {
+    WriteLock lock(*this);
+    return zoo.tryAddAnimal(animal);
+}
+
+ZooStatus ConcurrentZoo::tryRemoveAnimal(const std::string& name) {
+    WriteLock lock(*this);
+    return zoo.tryRemoveAnimal(name);
+}
+
+bool ConcurrentZoo::setHealthStatus(const std::string& name, bool healthy) {
+    WriteLock lock(*this);
+    Animal* animal = dynamic_cast<Animal*>(zoo.tryFindAnimal(name));
+    if (!animal) {
+        return false;
+    }
+    animal->setHealthStatus(healthy);
+    return true;
+}
+
+bool ConcurrentZoo::notifyVeterinarian(Veterinarian& vet, const std::string& name) {
+    WriteLock lock(*this);
+    Animal* animal = dynamic_cast<Animal*>(zoo.tryFindAnimal(name));
+    if (!animal) {
+        return false;
+    }
+    vet.onAnimalSick(animal);
+    return true;
+}
+
+int ConcurrentZoo::dispatchVeterinarian(Veterinarian& vet) {
+    WriteLock lock(*this);
+    return zoo.dispatchVeterinarian(vet);
+}
+
+int ConcurrentZoo::getAnimalCount() const {
+    ReadLock lock(*this);
+    return zoo.getAnimalCount();
+}
+
+int ConcurrentZoo::getSickCount() const {
+    ReadLock lock(*this);
+    return zoo.getSickCount();
+}
+
+int ConcurrentZoo::getCapacity() const {
+    return zoo.getCapacity();
+}
+
+int ConcurrentZoo::countBySpecies(const std::string& species) const {
+    ReadLock lock(*this);
+    return zoo.countBySpecies(species);
+}
+
+double ConcurrentZoo::calculateTotalFoodRequirement() const {
+    ReadLock lock(*this);
+    return zoo.calculateTotalFoodRequirement();
+}
@@ -0,0 +1,100 @@
+#ifndef CONCURRENTZOO_H
+#define CONCURRENTZOO_H
+
+#include "Zoo.h"
+#include "Animal.h"
+#include <shared_mutex>
+#include <mutex>
+#include <string>
+
+class Veterinarian;
+
+/**
+ * Thread-safe front for a Zoo: readers share a lock, writers take it alone
+ * Zoo itself is single-threaded. Every call made through this class holds
+ * the lock for its whole duration, so readers always see a consistent
+ * zoo. Pointers to animals never leave the lock; readers get at an animal
+ * through a visitor instead.
+ *
+ * The zoo must not be used directly while a ConcurrentZoo is in use, and
+ * must not have an OperationRecorder attached (reads would record from
+ * several threads at once). Any lazily loaded archive is loaded up front,
+ * and so are the rankings and name index that Zoo::topAnimals and
+ * Zoo::completeName would otherwise build on first use; writers keep them
+ * current under the exclusive lock.
+ */
+class ConcurrentZoo {
+private:
+    Zoo& zoo;
+    mutable std::shared_mutex mutex;
+
+    // std::shared_mutex (pthread rwlocks) lets a steady stream of readers
+    // starve writers. A writer holds the turnstile while it waits and
+    // readers pass through it first, so a waiting writer holds back new
+    // readers.
+    mutable std::mutex turnstile;
+
+    class ReadLock {
+    private:
+        std::shared_lock<std::shared_mutex> lock;
+
+        static std::shared_mutex& enter(const ConcurrentZoo& owner) {
+            std::lock_guard<std::mutex> pass(owner.turnstile);
+            return owner.mutex;
+        }
+
+    public:
+        explicit ReadLock(const ConcurrentZoo& owner) : lock(enter(owner)) {}
+    };
+
+    class WriteLock {
+    private:
+        std::unique_lock<std::mutex> gate;
+        std::unique_lock<std::shared_mutex> lock;
+
+    public:
+        explicit WriteLock(ConcurrentZoo& owner) : gate(owner.turnstile), lock(owner.mutex) {}
+    };
+
+public:
+    explicit ConcurrentZoo(Zoo& zoo);
+
+    ConcurrentZoo(const ConcurrentZoo&) = delete;
+    ConcurrentZoo& operator=(const ConcurrentZoo&) = delete;
+
+    // Writers
+    ZooStatus tryAddAnimal(IAnimal* animal);
+    ZooStatus tryRemoveAnimal(const std::string& name);
+    bool setHealthStatus(const std::string& name, bool healthy);
+    bool notifyVeterinarian(Veterinarian& vet, const std::string& name);
+    int dispatchVeterinarian(Veterinarian& vet);
+
+    // Readers
+    int getAnimalCount() const;
+    int getSickCount() const;
+    int getCapacity() const;
+    int countBySpecies(const std::string& species) const;
+    double calculateTotalFoodRequirement() const;
+
+    // Calls visit(const Animal&) under the shared lock; false if not found
+    template <typename Visit>
+    bool visitAnimal(const std::string& name, Visit visit) const {
+        ReadLock lock(*this);
+        const Animal* animal = dynamic_cast<const Animal*>(zoo.tryFindAnimal(name));
+        if (!animal) {
+            return false;
+        }
+        visit(*animal);
+        return true;
+    }
+
+    // Runs read(const Zoo&) under the shared lock, for checks that need
+    // several calls to agree with each other
+    template <typename Read>
+    auto read(Read readZoo) const -> decltype(readZoo(zoo)) {
+        ReadLock lock(*this);
+        return readZoo(zoo);
+    }
+};
+
+#endif // CONCURRENTZOO_H
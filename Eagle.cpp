@@ -5,7 +5,9 @@ Eagle::Eagle(std::string name, int age, double weight,
              double wingspan, bool canFly, std::string beakType,
              double clawLength, double visionRange, bool isGoldenEagle)
     : Bird(name, age, weight, wingspan, canFly, beakType),
-      clawLength(clawLength), visionRange(visionRange), isGoldenEagle(isGoldenEagle) {
+      clawLength(static_cast<float>(clawLength)), visionRange(static_cast<float>(visionRange)),
+      isGoldenEagle(isGoldenEagle) {
+    species = SpeciesId::Eagle;
 }
 
 void Eagle::makeSound() const {
@@ -16,8 +18,10 @@ void Eagle::eat() const {
     std::cout << name << " is eating fresh fish and small mammals." << std::endl;
 }
 
-std::string Eagle::getSpecies() const {
-    return isGoldenEagle ? "Golden Eagle" : "Eagle";
+const std::string& Eagle::getSpecies() const {
+    static const InternedString golden("Golden Eagle");
+    static const InternedString eagle("Eagle");
+    return isGoldenEagle ? golden : eagle;
 }
 
 void Eagle::displayInfo() const {
@@ -36,7 +40,7 @@ void Eagle::performCheckup() {
 
 double Eagle::calculateFoodRequirement() const {
     // Eagles need about 10% of body weight in meat
-    return weight * 0.10;
+    return getWeight() * 0.10;
 }
 
 void Eagle::fly() {
@@ -62,3 +66,7 @@ double Eagle::getClawLength() const {
 double Eagle::getVisionRange() const {
     return visionRange;
 }
+
+bool Eagle::getIsGoldenEagle() const {
+    return isGoldenEagle;
+}
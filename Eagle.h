@@ -6,10 +6,10 @@
 /**
  * Level 2: Eagle class - predator with hunting behavior
  */
-class Eagle : public Bird {
+class Eagle final : public Bird {
 private:
-    double clawLength; // cm
-    double visionRange; // meters
+    float clawLength;  // cm
+    float visionRange; // meters
     bool isGoldenEagle;
 
 public:
@@ -20,7 +20,7 @@ public:
     // Implement pure virtual methods
     void makeSound() const override;
     void eat() const override;
-    std::string getSpecies() const override;
+    const std::string& getSpecies() const override;
 
     // Override virtual methods
     void displayInfo() const override;
@@ -35,6 +35,7 @@ public:
 
     double getClawLength() const;
     double getVisionRange() const;
+    bool getIsGoldenEagle() const;
 };
 
 #endif // EAGLE_H
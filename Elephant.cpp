@@ -5,7 +5,9 @@ Elephant::Elephant(std::string name, int age, double weight,
                    bool hasFur, std::string furColor, int gestationPeriod,
                    double trunkLength, int tuskLength, bool hasIvory)
     : Mammal(name, age, weight, hasFur, furColor, gestationPeriod),
-      trunkLength(trunkLength), tuskLength(tuskLength), hasIvory(hasIvory) {
+      trunkLength(static_cast<float>(trunkLength)),
+      tuskLength(static_cast<uint16_t>(checkRange(tuskLength, UINT16_MAX, "Tusk length"))), hasIvory(hasIvory) {
+    species = SpeciesId::Elephant;
 }
 
 void Elephant::makeSound() const {
@@ -16,8 +18,9 @@ void Elephant::eat() const {
     std::cout << name << " is munching on hay, leaves, and fruits." << std::endl;
 }
 
-std::string Elephant::getSpecies() const {
-    return "Elephant";
+const std::string& Elephant::getSpecies() const {
+    static const InternedString species("Elephant");
+    return species;
 }
 
 void Elephant::displayInfo() const {
@@ -36,7 +39,7 @@ void Elephant::performCheckup() {
 
 double Elephant::calculateFoodRequirement() const {
     // Elephants need about 4-5% of body weight in vegetation
-    return weight * 0.045;
+    return getWeight() * 0.045;
 }
 
 void Elephant::trumpet() const {
@@ -58,3 +61,7 @@ double Elephant::getTrunkLength() const {
 int Elephant::getTuskLength() const {
     return tuskLength;
 }
+
+bool Elephant::getHasIvory() const {
+    return hasIvory;
+}
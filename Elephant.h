@@ -6,10 +6,10 @@
 /**
  * Level 2: Elephant class - herbivore with trunk behavior
  */
-class Elephant : public Mammal {
+class Elephant final : public Mammal {
 private:
-    double trunkLength; // meters
-    int tuskLength;     // cm
+    float trunkLength;   // meters
+    uint16_t tuskLength; // cm
     bool hasIvory;
 
 public:
@@ -20,7 +20,7 @@ public:
     // Implement pure virtual methods
     void makeSound() const override;
     void eat() const override;
-    std::string getSpecies() const override;
+    const std::string& getSpecies() const override;
 
     // Override virtual methods
     void displayInfo() const override;
@@ -34,6 +34,7 @@ public:
 
     double getTrunkLength() const;
     int getTuskLength() const;
+    bool getHasIvory() const;
 };
 
 #endif // ELEPHANT_H
@@ -2,6 +2,8 @@
 #define ENCLOSURE_H
 
 #include "Animal.h"
+#include "OperationTrace.h"
+#include "AllocationTracker.h"
 #include <vector>
 #include <string>
 #include <type_traits>
@@ -22,10 +24,11 @@ private:
     std::string enclosureName;
     int capacity;
     std::vector<T*> animals;
+    OperationRecorder* recorder;   // not owned, see setRecorder
 
 public:
     Enclosure(const std::string& name, int cap) 
-        : enclosureName(name), capacity(cap) {
+        : enclosureName(name), capacity(cap), recorder(nullptr) {
         std::cout << "Creating " << name << " enclosure (Capacity: " << capacity << ")" << std::endl;
     }
 
@@ -38,6 +41,10 @@ public:
 
     // Add animal to enclosure
     void addAnimal(T* animal) {
+        AllocationScope scope(AllocRegion::Enclosure);
+        if (recorder && animal) {
+            recorder->recordAnimal(TraceOp::EnclosureAdd, enclosureName, *animal);
+        }
         if (animals.size() >= static_cast<size_t>(capacity)) {
             throw std::runtime_error("Enclosure is full!");
         }
@@ -50,6 +57,10 @@ public:
 
     // Remove animal by name
     void removeAnimal(const std::string& name) {
+        AllocationScope scope(AllocRegion::Enclosure);
+        if (recorder) {
+            recorder->record(TraceOp::EnclosureRemove, enclosureName, name);
+        }
         auto it = std::find_if(animals.begin(), animals.end(),
             [&name](T* animal) {
                 return animal->getName() == name;
@@ -95,6 +106,11 @@ public:
         return enclosureName;
     }
 
+    // Log adds and removals to recorder (nullptr stops)
+    void setRecorder(OperationRecorder* newRecorder) {
+        recorder = newRecorder;
+    }
+
     // Calculate total food requirement for all animals in enclosure
     double calculateTotalFoodRequirement() const {
         double total = 0.0;
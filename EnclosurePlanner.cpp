@@ -0,0 +1,312 @@
+#include "EnclosurePlanner.h"
+#include "Zoo.h"
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <thread>
+
+namespace {
+
+const size_t NOT_FOUND = static_cast<size_t>(-1);
+const size_t MIN_BINS_PER_SHARD = 256;
+
+/**
+ * Remaining room of every enclosure, indexed like the spec list
+ * Shards only ever touch their own enclosures, so no locking is needed.
+ */
+struct Room {
+    std::vector<double> weight;
+    std::vector<int> count;
+};
+
+/**
+ * Max-tree over the remaining weight of a set of enclosures
+ * Full enclosures (no head-count left) are stored as -1 so firstFit()
+ * skips them.
+ */
+class BinTree {
+private:
+    const std::vector<size_t>& bins;
+    Room& room;
+    std::vector<double> tree;
+    size_t leaves;
+
+    double value(size_t position) const {
+        size_t bin = bins[position];
+        return room.count[bin] > 0 ? room.weight[bin] : -1.0;
+    }
+
+    void update(size_t position) {
+        size_t node = position + leaves;
+        tree[node] = value(position);
+        for (node /= 2; node >= 1; node /= 2) {
+            tree[node] = std::max(tree[2 * node], tree[2 * node + 1]);
+        }
+    }
+
+public:
+    BinTree(const std::vector<size_t>& bins, Room& room)
+        : bins(bins), room(room), leaves(1) {
+        while (leaves < bins.size()) leaves *= 2;
+        tree.assign(2 * leaves, -1.0);
+        for (size_t i = 0; i < bins.size(); ++i) {
+            tree[leaves + i] = value(i);
+        }
+        for (size_t node = leaves - 1; node >= 1; --node) {
+            tree[node] = std::max(tree[2 * node], tree[2 * node + 1]);
+        }
+    }
+
+    // Leftmost position whose enclosure can still take weight
+    size_t firstFit(double weight) const {
+        if (bins.empty() || tree[1] < weight) return NOT_FOUND;
+        size_t node = 1;
+        while (node < leaves) {
+            node = tree[2 * node] >= weight ? 2 * node : 2 * node + 1;
+        }
+        return node - leaves;
+    }
+
+    void place(size_t position, double weight) {
+        size_t bin = bins[position];
+        room.weight[bin] -= weight;
+        room.count[bin] -= 1;
+        update(position);
+    }
+
+    void unplace(size_t position, double weight) {
+        size_t bin = bins[position];
+        room.weight[bin] += weight;
+        room.count[bin] += 1;
+        update(position);
+    }
+
+    // Temporarily hide an enclosure from firstFit()
+    void close(size_t position, int& savedCount) {
+        savedCount = room.count[bins[position]];
+        room.count[bins[position]] = 0;
+        update(position);
+    }
+
+    void reopen(size_t position, int savedCount) {
+        room.count[bins[position]] = savedCount;
+        update(position);
+    }
+};
+
+bool heavierFirst(const Animal* a, const Animal* b) {
+    return a->getWeight() > b->getWeight();
+}
+
+/**
+ * First-fit-decreasing of animals (already sorted) into bins
+ * Animals that fit nowhere are appended to leftovers
+ */
+void firstFitDecreasing(const std::vector<Animal*>& animals, const std::vector<size_t>& bins,
+                        Room& room, EnclosurePlan& plan, std::vector<Animal*>& leftovers) {
+    BinTree tree(bins, room);
+    for (Animal* animal : animals) {
+        double weight = animal->getWeight();
+        size_t position = tree.firstFit(weight);
+        if (position == NOT_FOUND) {
+            leftovers.push_back(animal);
+            continue;
+        }
+        tree.place(position, weight);
+        plan.members[bins[position]].push_back(animal);
+    }
+}
+
+/**
+ * Local improvement: try to empty lightly used enclosures by moving
+ * every animal in them into other enclosures of the same species
+ */
+void consolidate(const std::vector<size_t>& bins, const std::vector<EnclosureSpec>& specs,
+                 Room& room, EnclosurePlan& plan) {
+    BinTree tree(bins, room);
+
+    std::vector<size_t> candidates;
+    for (size_t position = 0; position < bins.size(); ++position) {
+        size_t used = plan.members[bins[position]].size();
+        if (used > 0 && static_cast<int>(used) * 2 <= specs[bins[position]].capacity) {
+            candidates.push_back(position);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [&](size_t a, size_t b) {
+        return plan.members[bins[a]].size() < plan.members[bins[b]].size();
+    });
+
+    std::vector<size_t> targets;
+    for (size_t position : candidates) {
+        std::vector<Animal*>& source = plan.members[bins[position]];
+        if (source.empty()) continue;
+
+        int savedCount;
+        tree.close(position, savedCount);
+        targets.clear();
+        bool moved = true;
+        for (Animal* animal : source) {
+            size_t target = tree.firstFit(animal->getWeight());
+            if (target == NOT_FOUND) {
+                moved = false;
+                break;
+            }
+            tree.place(target, animal->getWeight());
+            plan.members[bins[target]].push_back(animal);
+            targets.push_back(target);
+        }
+
+        if (moved) {
+            // Enclosure is now empty; keep it closed so nothing moves back in
+            room.weight[bins[position]] = specs[bins[position]].maxTotalWeight > 0
+                ? specs[bins[position]].maxTotalWeight
+                : std::numeric_limits<double>::infinity();
+            source.clear();
+            savedCount = specs[bins[position]].capacity;
+            continue;
+        }
+
+        // Roll back in reverse order
+        for (size_t i = targets.size(); i-- > 0;) {
+            Animal* animal = plan.members[bins[targets[i]]].back();
+            plan.members[bins[targets[i]]].pop_back();
+            tree.unplace(targets[i], animal->getWeight());
+        }
+        tree.reopen(position, savedCount);
+    }
+}
+
+void runParallel(size_t tasks, unsigned threads, const std::function<void(size_t)>& task) {
+    std::atomic<size_t> next(0);
+    std::vector<std::thread> workers;
+    unsigned count = std::max(1u, std::min<unsigned>(threads, static_cast<unsigned>(tasks)));
+    for (unsigned t = 0; t < count; ++t) {
+        workers.emplace_back([&]() {
+            for (size_t i = next++; i < tasks; i = next++) {
+                task(i);
+            }
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+} // namespace
+
+EnclosurePlanner::EnclosurePlanner(const std::vector<EnclosureSpec>& specs)
+    : specs(specs) {
+}
+
+const std::vector<EnclosureSpec>& EnclosurePlanner::getSpecs() const {
+    return specs;
+}
+
+EnclosurePlan EnclosurePlanner::plan(const Zoo& zoo, unsigned threads) const {
+    EnclosurePlan result;
+    result.members.resize(specs.size());
+    result.totalWeight.assign(specs.size(), 0.0);
+    result.enclosuresUsed = 0;
+    threads = std::max(1u, threads);
+
+    Room room;
+    room.weight.resize(specs.size());
+    room.count.resize(specs.size());
+    std::vector<std::vector<size_t>> binsBySpecies(SPECIES_COUNT + 1);
+    for (size_t i = 0; i < specs.size(); ++i) {
+        room.weight[i] = specs[i].maxTotalWeight > 0
+            ? specs[i].maxTotalWeight : std::numeric_limits<double>::infinity();
+        room.count[i] = std::max(0, specs[i].capacity);
+        binsBySpecies[static_cast<int>(specs[i].species)].push_back(i);
+    }
+
+    std::vector<std::vector<Animal*>> animalsBySpecies(SPECIES_COUNT + 1);
+    for (IAnimal* animal : zoo.getAnimals()) {
+        Animal* a = dynamic_cast<Animal*>(animal);
+        if (a) {
+            animalsBySpecies[static_cast<int>(a->getSpeciesId())].push_back(a);
+        }
+    }
+
+    // Phase 1: sort each species by weight, split into shards
+    struct Shard {
+        std::vector<size_t> bins;
+        std::vector<Animal*> animals;
+        std::vector<Animal*> leftovers;
+        int species;
+    };
+    runParallel(animalsBySpecies.size(), threads, [&](size_t s) {
+        std::sort(animalsBySpecies[s].begin(), animalsBySpecies[s].end(), heavierFirst);
+    });
+
+    std::vector<Shard> shards;
+    for (int s = 0; s <= SPECIES_COUNT; ++s) {
+        const std::vector<size_t>& bins = binsBySpecies[s];
+        if (bins.empty()) {
+            result.unassigned.insert(result.unassigned.end(),
+                                     animalsBySpecies[s].begin(), animalsBySpecies[s].end());
+            continue;
+        }
+        size_t shardCount = std::max<size_t>(1, std::min<size_t>(threads, bins.size() / MIN_BINS_PER_SHARD));
+        size_t first = shards.size();
+        shards.resize(first + shardCount);
+        for (size_t k = 0; k < shardCount; ++k) {
+            shards[first + k].species = s;
+        }
+        // Round-robin keeps every shard's weight mix similar
+        for (size_t i = 0; i < bins.size(); ++i) {
+            shards[first + i % shardCount].bins.push_back(bins[i]);
+        }
+        const std::vector<Animal*>& animals = animalsBySpecies[s];
+        for (size_t i = 0; i < animals.size(); ++i) {
+            shards[first + i % shardCount].animals.push_back(animals[i]);
+        }
+    }
+
+    // Phase 2: first-fit-decreasing per shard, in parallel
+    runParallel(shards.size(), threads, [&](size_t k) {
+        firstFitDecreasing(shards[k].animals, shards[k].bins, room, result, shards[k].leftovers);
+    });
+
+    // Phase 3: per species, place shard leftovers anywhere, then consolidate
+    std::vector<std::vector<Animal*>> unplaced(SPECIES_COUNT + 1);
+    runParallel(binsBySpecies.size(), threads, [&](size_t s) {
+        if (binsBySpecies[s].empty()) return;
+        std::vector<Animal*> leftovers;
+        for (const Shard& shard : shards) {
+            if (shard.species == static_cast<int>(s)) {
+                leftovers.insert(leftovers.end(), shard.leftovers.begin(), shard.leftovers.end());
+            }
+        }
+        std::sort(leftovers.begin(), leftovers.end(), heavierFirst);
+        firstFitDecreasing(leftovers, binsBySpecies[s], room, result, unplaced[s]);
+        consolidate(binsBySpecies[s], specs, room, result);
+    });
+
+    for (const std::vector<Animal*>& rest : unplaced) {
+        result.unassigned.insert(result.unassigned.end(), rest.begin(), rest.end());
+    }
+    for (size_t i = 0; i < specs.size(); ++i) {
+        for (const Animal* animal : result.members[i]) {
+            result.totalWeight[i] += animal->getWeight();
+        }
+        if (!result.members[i].empty()) {
+            ++result.enclosuresUsed;
+        }
+    }
+    return result;
+}
+
+void EnclosurePlan::printSummary(std::ostream& out, const std::vector<EnclosureSpec>& specs) const {
+    out << "\n=== Enclosure Plan ===" << std::endl;
+    for (size_t i = 0; i < specs.size() && i < members.size(); ++i) {
+        if (members[i].empty()) continue;
+        out << specs[i].name << " (" << speciesName(specs[i].species) << "): "
+            << members[i].size() << "/" << specs[i].capacity << " animals, "
+            << totalWeight[i] << " kg" << std::endl;
+    }
+    out << "Enclosures used: " << enclosuresUsed << " of " << specs.size() << std::endl;
+    out << "Unassigned animals: " << unassigned.size() << std::endl;
+}
@@ -0,0 +1,57 @@
+#ifndef ENCLOSUREPLANNER_H
+#define ENCLOSUREPLANNER_H
+
+#include "Animal.h"
+#include <string>
+#include <vector>
+#include <ostream>
+
+class Zoo;
+
+/**
+ * Definition of an enclosure to be filled by the planner
+ * maxTotalWeight <= 0 means no weight limit
+ */
+struct EnclosureSpec {
+    std::string name;
+    SpeciesId species;
+    int capacity;
+    double maxTotalWeight;
+};
+
+/**
+ * Result of EnclosurePlanner::plan()
+ * members[i] holds the animals assigned to specs[i]
+ */
+struct EnclosurePlan {
+    std::vector<std::vector<Animal*>> members;
+    std::vector<double> totalWeight;
+    std::vector<Animal*> unassigned;
+    int enclosuresUsed;
+
+    void printSummary(std::ostream& out, const std::vector<EnclosureSpec>& specs) const;
+};
+
+/**
+ * Packs the animals of a zoo into enclosures (bin packing)
+ * Respects species, head-count capacity and total weight limits.
+ * Each species is packed with first-fit-decreasing by weight, using a
+ * max-tree over remaining weight so each placement is O(log enclosures).
+ * A local improvement pass then tries to empty lightly used enclosures
+ * by moving their animals elsewhere. Species with many enclosures are
+ * split into shards that are packed on separate threads; whatever a
+ * shard cannot place gets a final pass over all enclosures of its species.
+ */
+class EnclosurePlanner {
+private:
+    std::vector<EnclosureSpec> specs;
+
+public:
+    explicit EnclosurePlanner(const std::vector<EnclosureSpec>& specs);
+
+    EnclosurePlan plan(const Zoo& zoo, unsigned threads) const;
+
+    const std::vector<EnclosureSpec>& getSpecs() const;
+};
+
+#endif // ENCLOSUREPLANNER_H
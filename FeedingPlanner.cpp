@@ -0,0 +1,217 @@
+#include "FeedingPlanner.h"
+#include "Zoo.h"
+#include <iostream>
+#include <iomanip>
+#include <thread>
+#include <cmath>
+
+namespace {
+
+struct DietShare {
+    FoodType food;
+    double share;
+};
+
+struct Diet {
+    int components;
+    DietShare shares[2];
+};
+
+// Indexed by SpeciesId; follows what each species' eat() says it eats
+const Diet DIETS[] = {
+    { 1, { { FoodType::Meat, 1.0 }, { FoodType::Meat, 0.0 } } },      // Lion
+    { 2, { { FoodType::Hay, 0.7 }, { FoodType::Fruit, 0.3 } } },       // Elephant
+    { 2, { { FoodType::Fruit, 0.7 }, { FoodType::Insects, 0.3 } } },   // Monkey
+    { 2, { { FoodType::Fish, 0.5 }, { FoodType::Meat, 0.5 } } },       // Eagle
+    { 1, { { FoodType::Fish, 1.0 }, { FoodType::Fish, 0.0 } } },       // Penguin
+    { 2, { { FoodType::Seeds, 0.5 }, { FoodType::Fruit, 0.5 } } },     // Parrot
+    { 2, { { FoodType::Hay, 0.5 }, { FoodType::Fruit, 0.5 } } }        // Unknown
+};
+
+const Diet& dietFor(SpeciesId species) {
+    return DIETS[static_cast<int>(species)];
+}
+
+int64_t toGrams(double kg) {
+    return static_cast<int64_t>(std::llround(kg * 1000.0));
+}
+
+} // namespace
+
+const char* foodTypeName(FoodType food) {
+    switch (food) {
+        case FoodType::Meat: return "Meat";
+        case FoodType::Fish: return "Fish";
+        case FoodType::Hay: return "Hay & leaves";
+        case FoodType::Fruit: return "Fruit";
+        case FoodType::Seeds: return "Seeds & nuts";
+        case FoodType::Insects: return "Insects";
+        default: return "Unknown";
+    }
+}
+
+FoodAmounts::FoodAmounts() {
+    for (double& amount : kg) {
+        amount = 0.0;
+    }
+}
+
+double FoodAmounts::total() const {
+    double sum = 0.0;
+    for (double amount : kg) {
+        sum += amount;
+    }
+    return sum;
+}
+
+FoodAmounts& FoodAmounts::operator+=(const FoodAmounts& other) {
+    for (int i = 0; i < FOOD_TYPE_COUNT; ++i) {
+        kg[i] += other.kg[i];
+    }
+    return *this;
+}
+
+FoodInventory::FoodInventory() {
+    for (std::atomic<int64_t>& level : grams) {
+        level.store(0);
+    }
+}
+
+void FoodInventory::restock(FoodType food, double kg) {
+    grams[static_cast<int>(food)].fetch_add(toGrams(kg));
+}
+
+bool FoodInventory::tryConsume(FoodType food, double kg) {
+    int64_t wanted = toGrams(kg);
+    std::atomic<int64_t>& level = grams[static_cast<int>(food)];
+    int64_t current = level.load(std::memory_order_relaxed);
+    while (current >= wanted) {
+        if (level.compare_exchange_weak(current, current - wanted, std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+double FoodInventory::level(FoodType food) const {
+    return grams[static_cast<int>(food)].load() / 1000.0;
+}
+
+FoodAmounts FeedingPlanner::dailyNeeds(const Animal& animal) {
+    FoodAmounts needs;
+    const Diet& diet = dietFor(animal.getSpeciesId());
+    double requirement = animal.calculateFoodRequirement();
+    for (int i = 0; i < diet.components; ++i) {
+        needs.kg[static_cast<int>(diet.shares[i].food)] += requirement * diet.shares[i].share;
+    }
+    return needs;
+}
+
+void FeedingPlanner::addAnimal(const Animal& animal, Group& group) {
+    FoodAmounts needs = dailyNeeds(animal);
+    group.daily += needs;
+    totals += needs;
+    ++group.animals;
+}
+
+void FeedingPlanner::addZoo(const Zoo& zoo) {
+    Group group = { zoo.getZooName(), 0, FoodAmounts() };
+    for (const IAnimal* animal : zoo.getAnimals()) {
+        const Animal* a = dynamic_cast<const Animal*>(animal);
+        if (a) {
+            addAnimal(*a, group);
+        }
+    }
+    groups.push_back(group);
+}
+
+const std::vector<FeedingPlanner::Group>& FeedingPlanner::getGroups() const {
+    return groups;
+}
+
+const FoodAmounts& FeedingPlanner::getTotals() const {
+    return totals;
+}
+
+std::vector<FeedingPlanner::ProcurementLine>
+FeedingPlanner::projectProcurement(const FoodInventory& stock, int days) const {
+    std::vector<ProcurementLine> lines;
+    for (int i = 0; i < FOOD_TYPE_COUNT; ++i) {
+        FoodType food = static_cast<FoodType>(i);
+        ProcurementLine line;
+        line.food = food;
+        line.dailyKg = totals.kg[i];
+        line.stockKg = stock.level(food);
+        line.daysCovered = line.dailyKg > 0.0 ? line.stockKg / line.dailyKg : 0.0;
+        double needed = line.dailyKg * days - line.stockKg;
+        line.toOrderKg = needed > 0.0 ? needed : 0.0;
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+FeedingPlanner::FeedingResult
+FeedingPlanner::feedInParallel(const Zoo& zoo, FoodInventory& stock, unsigned threads) {
+    const std::vector<IAnimal*>& animals = zoo.getAnimals();
+    if (threads == 0) {
+        threads = 1;
+    }
+
+    std::atomic<long> fed(0);
+    std::atomic<long> shortages(0);
+    std::vector<std::thread> workers;
+    size_t chunk = (animals.size() + threads - 1) / threads;
+
+    for (unsigned t = 0; t < threads; ++t) {
+        size_t begin = t * chunk;
+        size_t end = begin + chunk < animals.size() ? begin + chunk : animals.size();
+        if (begin >= end) break;
+
+        workers.emplace_back([&animals, &stock, &fed, &shortages, begin, end]() {
+            long localFed = 0;
+            long localShort = 0;
+            for (size_t i = begin; i < end; ++i) {
+                const Animal* a = dynamic_cast<const Animal*>(animals[i]);
+                if (!a) continue;
+                const Diet& diet = dietFor(a->getSpeciesId());
+                double requirement = a->calculateFoodRequirement();
+                for (int c = 0; c < diet.components; ++c) {
+                    if (!stock.tryConsume(diet.shares[c].food, requirement * diet.shares[c].share)) {
+                        ++localShort;
+                    }
+                }
+                ++localFed;
+            }
+            fed += localFed;
+            shortages += localShort;
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    FeedingResult result = { fed.load(), shortages.load() };
+    return result;
+}
+
+void FeedingPlanner::printPlan(std::ostream& out, const FoodInventory& stock, int days) const {
+    out << "\n=== Daily Feeding Plan ===" << std::endl;
+    for (const Group& group : groups) {
+        out << group.name << " (" << group.animals << " animals): "
+            << group.daily.total() << " kg/day" << std::endl;
+        for (int i = 0; i < FOOD_TYPE_COUNT; ++i) {
+            if (group.daily.kg[i] > 0.0) {
+                out << "  " << std::left << std::setw(14) << foodTypeName(static_cast<FoodType>(i))
+                    << std::right << group.daily.kg[i] << " kg" << std::endl;
+            }
+        }
+    }
+
+    out << "\n=== " << days << "-Day Procurement ===" << std::endl;
+    for (const ProcurementLine& line : projectProcurement(stock, days)) {
+        if (line.dailyKg <= 0.0 && line.stockKg <= 0.0) continue;
+        out << "  " << std::left << std::setw(14) << foodTypeName(line.food) << std::right
+            << "daily " << line.dailyKg << " kg, stock " << line.stockKg
+            << " kg (" << line.daysCovered << " days), order " << line.toOrderKg << " kg" << std::endl;
+    }
+}
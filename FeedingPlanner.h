@@ -0,0 +1,117 @@
+#ifndef FEEDINGPLANNER_H
+#define FEEDINGPLANNER_H
+
+#include "Animal.h"
+#include "Enclosure.h"
+#include <atomic>
+#include <string>
+#include <vector>
+#include <ostream>
+#include <cstdint>
+
+class Zoo;
+
+enum class FoodType : uint8_t {
+    Meat,
+    Fish,
+    Hay,
+    Fruit,
+    Seeds,
+    Insects
+};
+
+const int FOOD_TYPE_COUNT = 6;
+
+const char* foodTypeName(FoodType food);
+
+/**
+ * Kilograms per food type
+ */
+struct FoodAmounts {
+    double kg[FOOD_TYPE_COUNT];
+
+    FoodAmounts();
+    double total() const;
+    FoodAmounts& operator+=(const FoodAmounts& other);
+};
+
+/**
+ * Food stock shared by concurrent feeders
+ * Levels are kept in whole grams in atomic counters, so feeding threads
+ * can draw from the same inventory without a lock.
+ */
+class FoodInventory {
+private:
+    std::atomic<int64_t> grams[FOOD_TYPE_COUNT];
+
+public:
+    FoodInventory();
+
+    void restock(FoodType food, double kg);
+    // Takes kg of food if that much is in stock; never goes negative
+    bool tryConsume(FoodType food, double kg);
+    double level(FoodType food) const;
+};
+
+/**
+ * Diet-aware feeding planner
+ * Maps each species to a diet (share of its daily requirement per food
+ * type) and aggregates daily needs per feeding group (the whole zoo or
+ * an enclosure) and per food type in a single pass over the animals.
+ */
+class FeedingPlanner {
+public:
+    struct Group {
+        std::string name;
+        int animals;
+        FoodAmounts daily;
+    };
+
+    struct ProcurementLine {
+        FoodType food;
+        double dailyKg;
+        double stockKg;
+        double daysCovered;
+        double toOrderKg;
+    };
+
+    struct FeedingResult {
+        long animalsFed;
+        long shortages;     // diet components that could not be served
+    };
+
+private:
+    std::vector<Group> groups;
+    FoodAmounts totals;
+
+    void addAnimal(const Animal& animal, Group& group);
+
+public:
+    // Daily requirement of animal split by its diet
+    static FoodAmounts dailyNeeds(const Animal& animal);
+
+    void addZoo(const Zoo& zoo);
+
+    template <typename T>
+    void addEnclosure(const Enclosure<T>& enclosure) {
+        Group group = { enclosure.getName(), 0, FoodAmounts() };
+        for (const T* animal : enclosure.getAnimals()) {
+            addAnimal(*animal, group);
+        }
+        groups.push_back(group);
+    }
+
+    const std::vector<Group>& getGroups() const;
+    const FoodAmounts& getTotals() const;
+
+    // Stock needed to feed every planned group for the given number of days
+    std::vector<ProcurementLine> projectProcurement(const FoodInventory& stock, int days) const;
+
+    // Serve one day of food to every animal in the zoo from stock, using
+    // several threads. Does not print per-animal messages.
+    static FeedingResult feedInParallel(const Zoo& zoo, FoodInventory& stock, unsigned threads);
+
+    void printPlan(std::ostream& out, const FoodInventory& stock, int days) const;
+};
+
+#endif // FEEDINGPLANNER_H
@@ -0,0 +1,68 @@
+#include "HealthBitmap.h"
+#include <bitset>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+HealthBitmap::HealthBitmap() : slotCount(0) {
+}
+
+unsigned HealthBitmap::lowestBit(uint64_t word) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctzll(word));
+#endif
+}
+
+void HealthBitmap::resize(size_t slots) {
+    words.resize((slots + 63) / 64, 0);
+    // Bits past the end must stay clear so count() is exact
+    if (slots < slotCount && slots % 64 != 0) {
+        words.back() &= (uint64_t(1) << (slots % 64)) - 1;
+    }
+    slotCount = slots;
+}
+
+void HealthBitmap::clear() {
+    words.clear();
+    slotCount = 0;
+}
+
+void HealthBitmap::set(size_t slot, bool value) {
+    uint64_t mask = uint64_t(1) << (slot % 64);
+    if (value) {
+        words[slot / 64] |= mask;
+    } else {
+        words[slot / 64] &= ~mask;
+    }
+}
+
+bool HealthBitmap::test(size_t slot) const {
+    return (words[slot / 64] >> (slot % 64)) & 1;
+}
+
+void HealthBitmap::moveSlot(size_t from, size_t to) {
+    set(to, test(from));
+}
+
+size_t HealthBitmap::count() const {
+    size_t total = 0;
+    for (uint64_t word : words) {
+        // std::bitset::count compiles to a popcnt instruction where available
+        total += std::bitset<64>(word).count();
+    }
+    return total;
+}
+
+size_t HealthBitmap::size() const {
+    return slotCount;
+}
+
+std::vector<size_t> HealthBitmap::setSlots() const {
+    std::vector<size_t> slots;
+    forEachSet([&slots](size_t slot) { slots.push_back(slot); });
+    return slots;
+}
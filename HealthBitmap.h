@@ -0,0 +1,54 @@
+#ifndef HEALTHBITMAP_H
+#define HEALTHBITMAP_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * One bit per zoo slot, set while the animal in that slot needs attention
+ * Counting uses popcount and iteration skips whole 64-slot words that
+ * have no bits set, so the cost follows the number of sick animals
+ * rather than the size of the zoo.
+ */
+class HealthBitmap {
+private:
+    std::vector<uint64_t> words;
+    size_t slotCount;
+
+    static unsigned lowestBit(uint64_t word);
+
+public:
+    HealthBitmap();
+
+    void resize(size_t slots);
+    void clear();
+
+    void set(size_t slot, bool value);
+    bool test(size_t slot) const;
+
+    // Copy the bit of slot 'from' into slot 'to' (used when slots are compacted)
+    void moveSlot(size_t from, size_t to);
+
+    size_t count() const;
+    size_t size() const;
+
+    // Slots with their bit set, in ascending order
+    std::vector<size_t> setSlots() const;
+
+    // Calls visit(slot) for each set bit. Each word is read before its
+    // slots are visited, so visit may clear bits (e.g. when treating)
+    template <typename Visitor>
+    void forEachSet(Visitor visit) const {
+        for (size_t w = 0; w < words.size(); ++w) {
+            uint64_t word = words[w];
+            while (word != 0) {
+                unsigned bit = lowestBit(word);
+                visit(w * 64 + bit);
+                word &= word - 1;
+            }
+        }
+    }
+};
+
+#endif // HEALTHBITMAP_H
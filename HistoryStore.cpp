@@ -0,0 +1,390 @@
+#include "HistoryStore.h"
+#include "BinaryCodec.h"
+#include "Exceptions.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <map>
+
+using namespace BinaryCodec;
+
+namespace {
+
+// Rough cost of one unordered_map node
+const size_t INDEX_NODE_OVERHEAD = 32;
+
+int32_t bucketStart(int32_t day, int32_t width) {
+    int32_t quotient = day / width;
+    if (day % width < 0) --quotient;
+    return quotient * width;
+}
+
+int32_t toGrams(double weight) {
+    return static_cast<int32_t>(std::lround(weight * 1000.0));
+}
+
+// One sample as deltas from the previous one, which it then becomes
+void encodeSample(std::string& out, int32_t& previousDay, int32_t& previousGrams,
+                  int32_t day, int32_t grams, bool healthy) {
+    putVarint(out, (static_cast<uint64_t>(day - previousDay) << 1) | (healthy ? 1 : 0));
+    putZigzag(out, static_cast<int64_t>(grams) - previousGrams);
+    previousDay = day;
+    previousGrams = grams;
+}
+
+struct Accumulator {
+    uint32_t days = 0;
+    uint32_t sickDays = 0;
+    double minWeight = std::numeric_limits<double>::max();
+    double maxWeight = std::numeric_limits<double>::lowest();
+    double weightSum = 0.0;
+
+    void add(uint32_t count, uint32_t sick, double low, double high, double mean) {
+        days += count;
+        sickDays += sick;
+        minWeight = std::min(minWeight, low);
+        maxWeight = std::max(maxWeight, high);
+        weightSum += mean * count;
+    }
+};
+
+} // namespace
+
+HistoryStore::Series::Series(uint32_t animal)
+    : animal(animal), lastDay(0), lastGrams(0), pendingDay(0), pendingGrams(0),
+      pendingHealthy(true), hasPending(false) {
+}
+
+HistoryStore::HistoryStore(size_t memoryBudget)
+    : memoryBudget(memoryBudget), memoryUsage(0), rawSamples(0),
+      oldestDay(0), newestDay(0), rawFromDay(0), rollupFromDay(0),
+      clockDay(0), clockSet(false) {
+}
+
+HistoryStore::Series* HistoryStore::find(uint32_t animal) {
+    auto it = index.find(animal);
+    return it == index.end() ? nullptr : &series[it->second];
+}
+
+const HistoryStore::Series* HistoryStore::find(uint32_t animal) const {
+    auto it = index.find(animal);
+    return it == index.end() ? nullptr : &series[it->second];
+}
+
+size_t HistoryStore::seriesMemory(const Series& s) const {
+    return s.bytes.capacity() + s.chunks.capacity() * sizeof(Chunk)
+         + s.rollups.capacity() * sizeof(Rollup) + INDEX_NODE_OVERHEAD;
+}
+
+template <typename Visit>
+void HistoryStore::forEachSample(const Series& s, const Chunk& chunk, Visit visit) {
+    size_t end = &chunk == &s.chunks.back()
+        ? s.bytes.size()
+        : (&chunk + 1)->offset;
+    Reader in(s.bytes.data() + chunk.offset, end - chunk.offset);
+    int32_t day = chunk.firstDay;
+    int32_t grams = chunk.firstGrams;
+    for (uint32_t i = 0; i < chunk.count; ++i) {
+        uint64_t tagged = in.varint();
+        day += static_cast<int32_t>(tagged >> 1);
+        grams += static_cast<int32_t>(in.zigzag());
+        visit(day, grams, (tagged & 1) != 0);
+    }
+}
+
+void HistoryStore::flushPending(Series& s) {
+    if (!s.hasPending) {
+        return;
+    }
+    size_t before = s.bytes.capacity() + s.chunks.capacity() * sizeof(Chunk);
+
+    if (s.chunks.empty() || s.chunks.back().count == CHUNK_SAMPLES) {
+        Chunk chunk;
+        chunk.firstDay = s.pendingDay;
+        chunk.lastDay = s.pendingDay;
+        chunk.firstGrams = s.pendingGrams;
+        chunk.offset = static_cast<uint32_t>(s.bytes.size());
+        chunk.count = 0;
+        s.chunks.push_back(chunk);
+        s.lastDay = s.pendingDay;
+        s.lastGrams = s.pendingGrams;
+    }
+    Chunk& chunk = s.chunks.back();
+    encodeSample(s.bytes, s.lastDay, s.lastGrams, s.pendingDay, s.pendingGrams, s.pendingHealthy);
+    chunk.lastDay = s.pendingDay;
+    ++chunk.count;
+    s.hasPending = false;
+    ++rawSamples;
+
+    memoryUsage += s.bytes.capacity() + s.chunks.capacity() * sizeof(Chunk) - before;
+}
+
+void HistoryStore::record(uint32_t animal, int32_t day, double weight, bool healthy) {
+    Series* s = find(animal);
+    if (!s) {
+        index.emplace(animal, static_cast<uint32_t>(series.size()));
+        series.emplace_back(animal);
+        s = &series.back();
+        memoryUsage += INDEX_NODE_OVERHEAD;
+        if (series.size() == 1) {
+            oldestDay = newestDay = day;
+            rawFromDay = rollupFromDay = bucketStart(day, ROLLUP_DAYS);
+        }
+    }
+
+    if (s->hasPending && day < s->pendingDay) {
+        throw InvalidOperationException("History of animal #" + std::to_string(animal)
+                                        + " is append-only: day "
+                                        + std::to_string(day) + " is before day "
+                                        + std::to_string(s->pendingDay));
+    }
+    if (s->hasPending && day != s->pendingDay) {
+        flushPending(*s);
+    }
+    s->pendingDay = day;
+    s->pendingGrams = toGrams(weight);
+    s->pendingHealthy = healthy;
+    s->hasPending = true;
+
+    oldestDay = std::min(oldestDay, day);
+    newestDay = std::max(newestDay, day);
+    if (getMemoryUsage() > memoryBudget) {
+        enforceBudget();
+    }
+}
+
+void HistoryStore::recordNow(uint32_t animal, double weight, bool healthy) {
+    record(animal, currentDay(), weight, healthy);
+}
+
+void HistoryStore::forget(uint32_t animal) {
+    auto it = index.find(animal);
+    if (it == index.end()) {
+        return;
+    }
+    uint32_t position = it->second;
+    index.erase(it);
+    Series& s = series[position];
+    for (const Chunk& chunk : s.chunks) {
+        rawSamples -= chunk.count;
+    }
+    memoryUsage -= seriesMemory(s);
+
+    // Fill the hole with the last series, as the zoo does with its slots
+    if (position + 1 != series.size()) {
+        s = std::move(series.back());
+        index[s.animal] = position;
+    }
+    series.pop_back();
+}
+
+void HistoryStore::rollUpBefore(int32_t cutoff) {
+    std::string keptBytes;
+    std::vector<Chunk> keptChunks;
+    for (Series& s : series) {
+        if (s.hasPending && s.pendingDay < cutoff) {
+            flushPending(s);
+        }
+        if (s.chunks.empty() || s.chunks.front().firstDay >= cutoff) {
+            continue;
+        }
+        size_t before = s.bytes.capacity() + s.chunks.capacity() * sizeof(Chunk)
+                      + s.rollups.capacity() * sizeof(Rollup);
+
+        auto roll = [&s](int32_t day, int32_t grams, bool healthy) {
+            int32_t first = bucketStart(day, ROLLUP_DAYS);
+            float weight = static_cast<float>(grams / 1000.0);
+            if (s.rollups.empty() || s.rollups.back().firstDay != first) {
+                Rollup r;
+                r.firstDay = first;
+                r.days = 0;
+                r.sickDays = 0;
+                r.minWeight = r.maxWeight = r.meanWeight = weight;
+                s.rollups.push_back(r);
+            }
+            Rollup& r = s.rollups.back();
+            r.meanWeight += (weight - r.meanWeight) / static_cast<float>(r.days + 1);
+            r.minWeight = std::min(r.minWeight, weight);
+            r.maxWeight = std::max(r.maxWeight, weight);
+            ++r.days;
+            r.sickDays += healthy ? 0 : 1;
+        };
+
+        // Whole chunks before the cutoff are rolled up, whole chunks after it
+        // are kept as they are, and the chunk straddling it is re-encoded
+        // from its first kept sample
+        keptBytes.clear();
+        keptChunks.clear();
+        for (const Chunk& chunk : s.chunks) {
+            size_t end = &chunk == &s.chunks.back() ? s.bytes.size() : (&chunk + 1)->offset;
+            if (chunk.firstDay >= cutoff) {
+                Chunk kept = chunk;
+                kept.offset = static_cast<uint32_t>(keptBytes.size());
+                keptBytes.append(s.bytes, chunk.offset, end - chunk.offset);
+                keptChunks.push_back(kept);
+                continue;
+            }
+            Chunk split = chunk;
+            split.count = 0;
+            int32_t previousDay = 0;
+            int32_t previousGrams = 0;
+            forEachSample(s, chunk, [&](int32_t day, int32_t grams, bool healthy) {
+                if (day < cutoff) {
+                    roll(day, grams, healthy);
+                    --rawSamples;
+                    return;
+                }
+                if (split.count == 0) {
+                    split.firstDay = previousDay = day;
+                    split.firstGrams = previousGrams = grams;
+                    split.offset = static_cast<uint32_t>(keptBytes.size());
+                }
+                encodeSample(keptBytes, previousDay, previousGrams, day, grams, healthy);
+                ++split.count;
+            });
+            if (split.count > 0) {
+                keptChunks.push_back(split);
+            }
+        }
+
+        s.bytes.assign(keptBytes);
+        s.bytes.shrink_to_fit();
+        s.chunks.assign(keptChunks.begin(), keptChunks.end());
+        s.chunks.shrink_to_fit();
+        s.rollups.shrink_to_fit();
+
+        memoryUsage += s.bytes.capacity() + s.chunks.capacity() * sizeof(Chunk)
+                     + s.rollups.capacity() * sizeof(Rollup);
+        memoryUsage -= before;
+    }
+}
+
+void HistoryStore::dropRollupsBefore(int32_t cutoff) {
+    for (Series& s : series) {
+        auto keep = std::find_if(s.rollups.begin(), s.rollups.end(),
+                                 [cutoff](const Rollup& r) { return r.firstDay >= cutoff; });
+        if (keep == s.rollups.begin()) {
+            continue;
+        }
+        size_t before = s.rollups.capacity() * sizeof(Rollup);
+        s.rollups.erase(s.rollups.begin(), keep);
+        s.rollups.shrink_to_fit();
+        memoryUsage += s.rollups.capacity() * sizeof(Rollup);
+        memoryUsage -= before;
+    }
+}
+
+void HistoryStore::enforceBudget() {
+    // Compact down to 90% of the budget so the next pass is not one sample away
+    size_t target = memoryBudget - memoryBudget / 10;
+    int32_t newestMonth = bucketStart(newestDay, ROLLUP_DAYS);
+    while (getMemoryUsage() > target && rawFromDay < newestMonth) {
+        rawFromDay += ROLLUP_DAYS;
+        rollUpBefore(rawFromDay);
+    }
+    while (getMemoryUsage() > target && rollupFromDay < rawFromDay) {
+        rollupFromDay += ROLLUP_DAYS;
+        dropRollupsBefore(rollupFromDay);
+    }
+}
+
+std::vector<HistorySample> HistoryStore::query(uint32_t animal, int32_t fromDay,
+                                               int32_t toDay) const {
+    std::vector<HistorySample> samples;
+    const Series* s = find(animal);
+    if (!s) {
+        return samples;
+    }
+    auto collect = [&](int32_t day, int32_t grams, bool healthy) {
+        if (day >= fromDay && day <= toDay) {
+            HistorySample sample;
+            sample.day = day;
+            sample.weight = grams / 1000.0;
+            sample.healthy = healthy;
+            samples.push_back(sample);
+        }
+    };
+    for (const Chunk& chunk : s->chunks) {
+        if (chunk.lastDay >= fromDay && chunk.firstDay <= toDay) {
+            forEachSample(*s, chunk, collect);
+        }
+    }
+    if (s->hasPending) {
+        collect(s->pendingDay, s->pendingGrams, s->pendingHealthy);
+    }
+    return samples;
+}
+
+std::vector<HistoryBucket> HistoryStore::rollup(uint32_t animal, int32_t fromDay,
+                                                int32_t toDay, int32_t bucketDays) const {
+    if (bucketDays <= 0) {
+        throw InvalidOperationException("Bucket size must be positive");
+    }
+    std::vector<HistoryBucket> buckets;
+    const Series* s = find(animal);
+    if (!s) {
+        return buckets;
+    }
+
+    std::map<int32_t, Accumulator> totals;
+    for (const Rollup& r : s->rollups) {
+        if (r.firstDay + ROLLUP_DAYS > fromDay && r.firstDay <= toDay) {
+            totals[bucketStart(r.firstDay, bucketDays)].add(r.days, r.sickDays, r.minWeight,
+                                                            r.maxWeight, r.meanWeight);
+        }
+    }
+    for (const HistorySample& sample : query(animal, fromDay, toDay)) {
+        totals[bucketStart(sample.day, bucketDays)].add(1, sample.healthy ? 0 : 1, sample.weight,
+                                                        sample.weight, sample.weight);
+    }
+
+    buckets.reserve(totals.size());
+    for (const auto& entry : totals) {
+        HistoryBucket bucket;
+        bucket.firstDay = entry.first;
+        bucket.days = entry.second.days;
+        bucket.sickDays = entry.second.sickDays;
+        bucket.minWeight = entry.second.minWeight;
+        bucket.maxWeight = entry.second.maxWeight;
+        bucket.meanWeight = entry.second.weightSum / entry.second.days;
+        buckets.push_back(bucket);
+    }
+    return buckets;
+}
+
+void HistoryStore::setDay(int32_t day) {
+    clockDay = day;
+    clockSet = true;
+}
+
+int32_t HistoryStore::currentDay() const {
+    return clockSet ? clockDay : today();
+}
+
+int32_t HistoryStore::today() {
+    std::chrono::hours sinceEpoch = std::chrono::duration_cast<std::chrono::hours>(
+        std::chrono::system_clock::now().time_since_epoch());
+    return static_cast<int32_t>(sinceEpoch.count() / 24);
+}
+
+size_t HistoryStore::getMemoryUsage() const {
+    return memoryUsage + series.capacity() * sizeof(Series)
+         + index.bucket_count() * sizeof(void*);
+}
+
+size_t HistoryStore::getMemoryBudget() const {
+    return memoryBudget;
+}
+
+size_t HistoryStore::getSeriesCount() const {
+    return series.size();
+}
+
+uint64_t HistoryStore::getRawSampleCount() const {
+    return rawSamples;
+}
+
+int32_t HistoryStore::getRawFromDay() const {
+    return rawFromDay;
+}
@@ -0,0 +1,140 @@
+#ifndef HISTORYSTORE_H
+#define HISTORYSTORE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+// One day of an animal's history
+struct HistorySample {
+    int32_t day;        // days since 1970-01-01
+    double weight;      // kg, stored to the gram
+    bool healthy;
+};
+
+// Downsampled history: every sample whose day falls in the bucket
+struct HistoryBucket {
+    int32_t firstDay;
+    uint32_t days;      // samples in the bucket
+    uint32_t sickDays;
+    double minWeight;
+    double maxWeight;
+    double meanWeight;
+};
+
+/**
+ * Append-only weight and health history per animal
+ * Series are keyed by Animal::getId, so they follow an animal through
+ * renames and never mix animals that share a name. Every animal keeps at
+ * most one sample per day (the last state recorded
+ * that day). Samples are packed into chunks of CHUNK_SAMPLES as varint
+ * day and zigzag weight deltas, so a daily series costs about 2-3 bytes
+ * per day.
+ *
+ * Memory is capped by a budget. When it is exceeded, the oldest raw days
+ * of every animal are folded into ROLLUP_DAYS rollups (min/max/mean
+ * weight, sick days), one month at a time, and the latest month always
+ * stays raw. If rollups alone still exceed the budget, the oldest ones
+ * are dropped. query() returns raw days only; rollup() combines both.
+ */
+class HistoryStore {
+public:
+    static const int32_t ROLLUP_DAYS = 30;
+    static const uint32_t CHUNK_SAMPLES = 128;
+    static const size_t DEFAULT_MEMORY_BUDGET = size_t(1) << 30;
+
+private:
+    struct Chunk {
+        int32_t firstDay;
+        int32_t lastDay;
+        int32_t firstGrams;
+        uint32_t offset;     // into Series::bytes
+        uint32_t count;
+    };
+
+    struct Rollup {
+        int32_t firstDay;
+        uint16_t days;
+        uint16_t sickDays;
+        float minWeight;
+        float maxWeight;
+        float meanWeight;
+    };
+
+    struct Series {
+        uint32_t animal;                 // key in index
+        std::string bytes;
+        std::vector<Chunk> chunks;       // the last one is still being appended to
+        std::vector<Rollup> rollups;
+        int32_t lastDay;                 // last encoded sample, base of the next delta
+        int32_t lastGrams;
+        int32_t pendingDay;              // today's sample, encoded once the day is over
+        int32_t pendingGrams;
+        bool pendingHealthy;
+        bool hasPending;
+
+        explicit Series(uint32_t animal);
+    };
+
+    std::unordered_map<uint32_t, uint32_t> index;   // animal id -> series
+    std::vector<Series> series;
+    size_t memoryBudget;
+    size_t memoryUsage;
+    uint64_t rawSamples;
+    int32_t oldestDay;
+    int32_t newestDay;
+    int32_t rawFromDay;      // days before this exist only as rollups
+    int32_t rollupFromDay;   // rollups before this were dropped
+    int32_t clockDay;        // set by setDay(); otherwise today()
+    bool clockSet;
+
+    Series* find(uint32_t animal);
+    const Series* find(uint32_t animal) const;
+    size_t seriesMemory(const Series& s) const;
+    void flushPending(Series& s);
+    void rollUpBefore(int32_t cutoff);
+    void dropRollupsBefore(int32_t cutoff);
+    void enforceBudget();
+
+    template <typename Visit>
+    static void forEachSample(const Series& s, const Chunk& chunk, Visit visit);
+
+public:
+    explicit HistoryStore(size_t memoryBudget = DEFAULT_MEMORY_BUDGET);
+
+    HistoryStore(const HistoryStore&) = delete;
+    HistoryStore& operator=(const HistoryStore&) = delete;
+
+    // Days must not go backwards for one animal; a second sample on the
+    // same day replaces the first
+    void record(uint32_t animal, int32_t day, double weight, bool healthy);
+    void recordNow(uint32_t animal, double weight, bool healthy);
+
+    // Drops the animal's whole series, for an animal that left the zoo
+    void forget(uint32_t animal);
+
+    // Raw samples with fromDay <= day <= toDay (rolled-up days are skipped)
+    std::vector<HistorySample> query(uint32_t animal, int32_t fromDay, int32_t toDay) const;
+
+    // Buckets of bucketDays aligned to day 0, from raw samples and rollups
+    // Rolled-up months that overlap the range count whole, in the bucket
+    // holding their first day, so bucketDays should be a multiple of
+    // ROLLUP_DAYS for ranges that were rolled up
+    std::vector<HistoryBucket> rollup(uint32_t animal, int32_t fromDay, int32_t toDay,
+                                      int32_t bucketDays) const;
+
+    // Simulated clock for recordNow(); defaults to the wall clock
+    void setDay(int32_t day);
+    int32_t currentDay() const;
+    static int32_t today();
+
+    size_t getMemoryUsage() const;
+    size_t getMemoryBudget() const;
+    size_t getSeriesCount() const;
+    uint64_t getRawSampleCount() const;
+    int32_t getRawFromDay() const;
+};
+
+#endif // HISTORYSTORE_H
@@ -12,7 +12,7 @@ public:
     virtual void makeSound() const = 0;
     virtual void eat() const = 0;
     virtual void sleep() const = 0;
-    virtual std::string getSpecies() const = 0;
+    virtual const std::string& getSpecies() const = 0;
     virtual ~IAnimal() = default;
 };
 
@@ -0,0 +1,26 @@
+#ifndef IANIMALOBSERVER_H
+#define IANIMALOBSERVER_H
+
+#include <cstddef>
+#include <string>
+
+class Animal;
+
+/**
+ * Observer interface for state changes of a single animal
+ * The owning Zoo attaches itself so its indexes stay in sync with
+ * changes made directly through the Animal (or by a Veterinarian)
+ */
+class IAnimalObserver {
+public:
+    virtual void onHealthChanged(Animal* animal, bool healthy) = 0;
+    virtual void onNameChanged(Animal* animal, const std::string& oldName) = 0;
+
+    // Measurements, for observers that keep history (see HistoryStore)
+    virtual void onWeightChanged(Animal*, double) {}
+    virtual void onAgeChanged(Animal*, int) {}
+    virtual void onCheckup(Animal*, bool) {}
+    virtual ~IAnimalObserver() = default;
+};
+
+#endif // IANIMALOBSERVER_H
@@ -0,0 +1,53 @@
+#include "InternTable.h"
+
+InternTable::InternTable() : characterBytes(0) {
+}
+
+InternTable& InternTable::global() {
+    static InternTable table;
+    return table;
+}
+
+const std::string* InternTable::intern(std::string_view text) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = strings.find(text);
+    if (it != strings.end()) {
+        return it->second.get();
+    }
+    // The key views the owned copy, so it stays valid as the map grows
+    std::unique_ptr<std::string> owned(new std::string(text));
+    const std::string* canonical = owned.get();
+    strings.emplace(std::string_view(*canonical), std::move(owned));
+    characterBytes += canonical->capacity() + 1;
+    return canonical;
+}
+
+size_t InternTable::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return strings.size();
+}
+
+size_t InternTable::memoryUsage() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t perEntry = sizeof(std::string)                         // owned string object
+                    + sizeof(std::string_view) + sizeof(void*) * 3 // hash node
+                    + sizeof(void*);                               // bucket
+    return strings.size() * perEntry + characterBytes;
+}
+
+InternedString::InternedString() {
+    static const std::string* empty = InternTable::global().intern(std::string_view());
+    value = empty;
+}
+
+InternedString::InternedString(std::string_view text)
+    : value(InternTable::global().intern(text)) {
+}
+
+InternedString::InternedString(const std::string& text)
+    : value(InternTable::global().intern(text)) {
+}
+
+InternedString::InternedString(const char* text)
+    : value(InternTable::global().intern(text)) {
+}
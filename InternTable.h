@@ -0,0 +1,67 @@
+#ifndef INTERNTABLE_H
+#define INTERNTABLE_H
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <cstddef>
+
+/**
+ * Process-wide table of unique strings
+ * Each distinct value is stored once and never freed, so handles to it
+ * stay valid for the lifetime of the program. Interning takes a lock;
+ * reading an interned value does not.
+ */
+class InternTable {
+private:
+    mutable std::mutex mutex;
+    std::unordered_map<std::string_view, std::unique_ptr<std::string>> strings;
+    size_t characterBytes;
+
+    InternTable();
+
+public:
+    InternTable(const InternTable&) = delete;
+    InternTable& operator=(const InternTable&) = delete;
+
+    static InternTable& global();
+
+    // Returns the canonical copy of text, adding it if needed
+    const std::string* intern(std::string_view text);
+
+    size_t size() const;
+    // Approximate heap used by the table itself (strings plus hash nodes)
+    size_t memoryUsage() const;
+};
+
+/**
+ * Handle to an interned string: one pointer wide, compared by address
+ * Used for attribute values that repeat across many animals
+ * (fur colour, beak type, sub-species names, ...)
+ */
+class InternedString {
+private:
+    const std::string* value;
+
+public:
+    InternedString();
+    InternedString(std::string_view text);
+    InternedString(const std::string& text);
+    InternedString(const char* text);
+
+    const std::string& str() const { return *value; }
+    std::string_view view() const { return *value; }
+    operator const std::string&() const { return *value; }
+
+    bool operator==(const InternedString& other) const { return value == other.value; }
+    bool operator!=(const InternedString& other) const { return value != other.value; }
+};
+
+inline std::ostream& operator<<(std::ostream& out, const InternedString& text) {
+    return out << text.str();
+}
+
+#endif // INTERNTABLE_H
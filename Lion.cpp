@@ -5,7 +5,8 @@ Lion::Lion(std::string name, int age, double weight,
            bool hasFur, std::string furColor, int gestationPeriod,
            int maneSize, bool isAlpha)
     : Mammal(name, age, weight, hasFur, furColor, gestationPeriod),
-      maneSize(maneSize), isAlpha(isAlpha) {
+      maneSize(static_cast<uint16_t>(checkRange(maneSize, UINT16_MAX, "Mane size"))), isAlpha(isAlpha) {
+    species = SpeciesId::Lion;
 }
 
 void Lion::makeSound() const {
@@ -16,8 +17,9 @@ void Lion::eat() const {
     std::cout << name << " is eating fresh meat." << std::endl;
 }
 
-std::string Lion::getSpecies() const {
-    return "Lion";
+const std::string& Lion::getSpecies() const {
+    static const InternedString species("Lion");
+    return species;
 }
 
 void Lion::displayInfo() const {
@@ -35,7 +37,7 @@ void Lion::performCheckup() {
 
 double Lion::calculateFoodRequirement() const {
     // Lions need about 5% of their body weight in meat
-    return weight * 0.05;
+    return getWeight() * 0.05;
 }
 
 void Lion::roar() const {
@@ -6,9 +6,9 @@
 /**
  * Level 2: Lion class - carnivore with pride behavior
  */
-class Lion : public Mammal {
+class Lion final : public Mammal {
 private:
-    int maneSize; // cm
+    uint16_t maneSize; // cm
     bool isAlpha;
 
 public:
@@ -19,7 +19,7 @@ public:
     // Implement pure virtual methods
     void makeSound() const override;
     void eat() const override;
-    std::string getSpecies() const override;
+    const std::string& getSpecies() const override;
 
     // Override virtual methods
     void displayInfo() const override;
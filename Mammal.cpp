@@ -3,8 +3,8 @@
 
 Mammal::Mammal(std::string name, int age, double weight,
                bool hasFur, std::string furColor, int gestationPeriod)
-    : Animal(name, age, weight), hasFur(hasFur), furColor(furColor),
-      gestationPeriod(gestationPeriod) {
+    : Animal(name, age, weight), furColor(furColor),
+      gestationPeriod(static_cast<uint16_t>(checkRange(gestationPeriod, UINT16_MAX, "Gestation period"))), hasFur(hasFur) {
 }
 
 
@@ -26,7 +26,7 @@ void Mammal::nurse() {
     std::cout << name << " is nursing its young." << std::endl;
 }
 
-std::string Mammal::getFurColor() const {
+const std::string& Mammal::getFurColor() const {
     return furColor;
 }
 
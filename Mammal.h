@@ -2,6 +2,7 @@
 #define MAMMAL_H
 
 #include "Animal.h"
+#include "InternTable.h"
 
 /**
  * Level 1: Mammal class inheriting from Animal
@@ -9,9 +10,9 @@
  */
 class Mammal : public Animal {
 protected:
+    InternedString furColor;
+    uint16_t gestationPeriod; // in days
     bool hasFur;
-    std::string furColor;
-    int gestationPeriod; // in days
 
 public:
     Mammal(std::string name, int age, double weight,
@@ -23,7 +24,7 @@ public:
 
     // Mammal-specific methods
     virtual void nurse();
-    std::string getFurColor() const;
+    const std::string& getFurColor() const;
     bool getHasFur() const;
     int getGestationPeriod() const;
 };
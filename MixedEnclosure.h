@@ -0,0 +1,167 @@
+#ifndef MIXEDENCLOSURE_H
+#define MIXEDENCLOSURE_H
+
+#include "Animal.h"
+#include "Lion.h"
+#include "Elephant.h"
+#include "Eagle.h"
+#include "Parrot.h"
+#include <vector>
+#include <tuple>
+#include <string>
+#include <type_traits>
+#include <iostream>
+#include <stdexcept>
+
+/**
+ * Enclosure for a closed set of species, e.g. MixedEnclosure<Lion, Elephant>
+ * Each type lives by value in its own contiguous std::vector, so iteration
+ * walks flat arrays instead of chasing IAnimal* pointers. Visitation is
+ * resolved at compile time: forEach() calls the visitor once per type with
+ * the concrete T&, and because the leaf classes are final the compiler
+ * can call their overrides directly instead of through the vtable.
+ *
+ * References returned by addAnimal() and get<T>() are invalidated when
+ * more animals of the same type are added (use reserve<T>() up front).
+ */
+template <typename... Ts>
+class MixedEnclosure {
+    static_assert(sizeof...(Ts) > 0, "MixedEnclosure needs at least one type");
+    static_assert((std::is_base_of<Animal, Ts>::value && ...),
+                  "All types must derive from Animal");
+
+private:
+    std::string enclosureName;
+    int capacity;
+    std::tuple<std::vector<Ts>...> animals;
+
+    template <typename T, typename U, typename... Us>
+    static constexpr size_t indexOf() {
+        if constexpr (std::is_same<T, U>::value) {
+            return 0;
+        } else {
+            static_assert(sizeof...(Us) > 0, "Type is not held by this MixedEnclosure");
+            return 1 + indexOf<T, Us...>();
+        }
+    }
+
+public:
+    // True if T is one of the enclosure's types (usable in static_assert)
+    template <typename T>
+    static constexpr bool holds() {
+        return (std::is_same<T, Ts>::value || ...);
+    }
+
+    static constexpr size_t typeCount() {
+        return sizeof...(Ts);
+    }
+
+    MixedEnclosure(const std::string& name, int cap)
+        : enclosureName(name), capacity(cap) {
+        std::cout << "Creating " << name << " enclosure (Capacity: " << capacity << ")" << std::endl;
+    }
+
+    // Construct an animal of type T in place
+    template <typename T, typename... Args>
+    T& addAnimal(Args&&... args) {
+        static_assert(holds<T>(), "Type is not held by this MixedEnclosure");
+        if (getAnimalCount() >= capacity) {
+            throw std::runtime_error("Enclosure is full!");
+        }
+        std::vector<T>& list = get<T>();
+        list.emplace_back(std::forward<Args>(args)...);
+        return list.back();
+    }
+
+    template <typename T>
+    void reserve(size_t count) {
+        get<T>().reserve(count);
+    }
+
+    // Remove animal by name (order within a type is not preserved)
+    void removeAnimal(const std::string& name) {
+        bool removed = false;
+        auto removeFrom = [&](auto& list) {
+            for (size_t i = 0; !removed && i < list.size(); ++i) {
+                if (list[i].getName() == name) {
+                    std::swap(list[i], list.back());
+                    list.pop_back();
+                    removed = true;
+                }
+            }
+        };
+        std::apply([&](auto&... lists) { (removeFrom(lists), ...); }, animals);
+        if (!removed) {
+            throw std::runtime_error("Animal not found in enclosure");
+        }
+    }
+
+    template <typename T>
+    std::vector<T>& get() {
+        return std::get<indexOf<T, Ts...>()>(animals);
+    }
+
+    template <typename T>
+    const std::vector<T>& get() const {
+        return std::get<indexOf<T, Ts...>()>(animals);
+    }
+
+    // Call visitor(T&) for every animal, one type at a time
+    template <typename Visitor>
+    void forEach(Visitor&& visitor) {
+        std::apply([&](auto&... lists) {
+            ((void)[&] { for (auto& animal : lists) visitor(animal); }(), ...);
+        }, animals);
+    }
+
+    template <typename Visitor>
+    void forEach(Visitor&& visitor) const {
+        std::apply([&](const auto&... lists) {
+            ((void)[&] { for (const auto& animal : lists) visitor(animal); }(), ...);
+        }, animals);
+    }
+
+    int getAnimalCount() const {
+        return static_cast<int>(std::apply([](const auto&... lists) {
+            return (lists.size() + ...);
+        }, animals));
+    }
+
+    std::string getName() const {
+        return enclosureName;
+    }
+
+    double calculateTotalFoodRequirement() const {
+        double total = 0.0;
+        forEach([&total](const auto& animal) { total += animal.calculateFoodRequirement(); });
+        return total;
+    }
+
+    void displayAnimals() const {
+        std::cout << "\n=== " << enclosureName << " ===" << std::endl;
+        std::cout << "Animals: " << getAnimalCount() << "/" << capacity << std::endl;
+        int index = 0;
+        forEach([&index](const auto& animal) {
+            std::cout << "\n[" << ++index << "] ";
+            animal.displayInfo();
+        });
+    }
+
+    void makeAllSounds() const {
+        std::cout << "\n=== Animals in " << enclosureName << " making sounds ===" << std::endl;
+        forEach([](const auto& animal) { animal.makeSound(); });
+    }
+
+    void feedAll() const {
+        std::cout << "\n=== Feeding animals in " << enclosureName << " ===" << std::endl;
+        forEach([](const auto& animal) { animal.eat(); });
+    }
+};
+
+typedef MixedEnclosure<Lion, Elephant> Savanna;
+typedef MixedEnclosure<Eagle, Parrot> Aviary;
+
+static_assert(Savanna::holds<Lion>() && !Savanna::holds<Eagle>(), "Savanna holds mammals only");
+static_assert(Aviary::holds<Parrot>() && !Aviary::holds<Lion>(), "Aviary holds birds only");
+
+#endif // MIXEDENCLOSURE_H
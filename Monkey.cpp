@@ -5,7 +5,9 @@ Monkey::Monkey(std::string name, int age, double weight,
                bool hasFur, std::string furColor, int gestationPeriod,
                double tailLength, bool isPrehensile, std::string species)
     : Mammal(name, age, weight, hasFur, furColor, gestationPeriod),
-      tailLength(tailLength), isPrehensile(isPrehensile), species(species) {
+      monkeyType(species), speciesLabel("Monkey (" + species + ")"),
+      tailLength(static_cast<float>(tailLength)), isPrehensile(isPrehensile) {
+    this->species = SpeciesId::Monkey;
 }
 
 void Monkey::makeSound() const {
@@ -16,14 +18,14 @@ void Monkey::eat() const {
     std::cout << name << " is eating bananas, fruits, and insects." << std::endl;
 }
 
-std::string Monkey::getSpecies() const {
-    return "Monkey (" + species + ")";
+const std::string& Monkey::getSpecies() const {
+    return speciesLabel;
 }
 
 void Monkey::displayInfo() const {
     std::cout << "\n=== MONKEY ===" << std::endl;
     Mammal::displayInfo();
-    std::cout << "Species: " << species << std::endl;
+    std::cout << "Species: " << monkeyType << std::endl;
     std::cout << "Tail Length: " << tailLength << " cm" << std::endl;
     std::cout << "Prehensile Tail: " << (isPrehensile ? "Yes" : "No") << std::endl;
 }
@@ -36,7 +38,7 @@ void Monkey::performCheckup() {
 
 double Monkey::calculateFoodRequirement() const {
     // Monkeys need about 3% of body weight in mixed diet
-    return weight * 0.03;
+    return getWeight() * 0.03;
 }
 
 void Monkey::climb() const {
@@ -58,3 +60,7 @@ double Monkey::getTailLength() const {
 bool Monkey::getIsPrehensile() const {
     return isPrehensile;
 }
+
+const std::string& Monkey::getMonkeyType() const {
+    return monkeyType;
+}
@@ -6,11 +6,12 @@
 /**
  * Level 2: Monkey class - omnivore with climbing behavior
  */
-class Monkey : public Mammal {
+class Monkey final : public Mammal {
 private:
-    double tailLength; // cm
+    InternedString monkeyType;   // e.g., "Capuchin", "Spider Monkey"
+    InternedString speciesLabel; // "Monkey (<type>)", built once
+    float tailLength;  // cm
     bool isPrehensile; // can use tail for grasping
-    std::string species; // e.g., "Capuchin", "Spider Monkey"
 
 public:
     Monkey(std::string name, int age, double weight,
@@ -20,7 +21,7 @@ public:
     // Implement pure virtual methods
     void makeSound() const override;
     void eat() const override;
-    std::string getSpecies() const override;
+    const std::string& getSpecies() const override;
 
     // Override virtual methods
     void displayInfo() const override;
@@ -34,6 +35,7 @@ public:
 
     double getTailLength() const;
     bool getIsPrehensile() const;
+    const std::string& getMonkeyType() const;
 };
 
 #endif // MONKEY_H
@@ -0,0 +1,178 @@
+#include "NamePrefixIndex.h"
+#include "Exceptions.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    const size_t MIN_RECENT = 256;
+
+    bool startsWith(std::string_view value, std::string_view prefix) {
+        return value.substr(0, prefix.size()) == prefix;
+    }
+}
+
+NamePrefixIndex::NamePrefixIndex() : removedCount(0), liveBytes(0) {
+}
+
+bool NamePrefixIndex::hasRoom(std::string_view name) const {
+    return text.size() + name.size() < REMOVED;
+}
+
+NamePrefixIndex::Ref NamePrefixIndex::store(std::string_view name) {
+    Ref ref{ static_cast<uint32_t>(text.size()), static_cast<uint32_t>(name.size()) };
+    text.append(name.data(), name.size());
+    liveBytes += name.size();
+    return ref;
+}
+
+void NamePrefixIndex::sortRecent() {
+    std::sort(recent.begin(), recent.end(),
+              [this](Ref a, Ref b) { return view(a) < view(b); });
+}
+
+void NamePrefixIndex::mergeIfDue() {
+    // Keeping the small run near sqrt(2n) balances its insertion cost
+    // against how often the main run is rewritten
+    size_t recentLimit = std::max(MIN_RECENT, static_cast<size_t>(std::sqrt(2.0 * sorted.size())));
+    if (recent.size() > recentLimit || removedCount > std::max(MIN_RECENT, sorted.size() / 4)) {
+        merge();
+    }
+}
+
+void NamePrefixIndex::merge() {
+    if (removedCount > 0) {
+        sorted.erase(std::remove_if(sorted.begin(), sorted.end(),
+                                    [](Ref r) { return (r.length & REMOVED) != 0; }),
+                     sorted.end());
+    }
+
+    // Merge in place from the back. Binary search places each recent
+    // name; the main-run stretches between them move without their names
+    // being read
+    size_t mainSize = sorted.size();
+    sorted.resize(mainSize + recent.size());
+    std::vector<Ref>::iterator end = sorted.begin() + mainSize;
+    std::vector<Ref>::iterator out = sorted.end();
+    for (auto it = recent.rbegin(); it != recent.rend(); ++it) {
+        std::vector<Ref>::iterator stop = std::upper_bound(sorted.begin(), end, view(*it),
+            [this](std::string_view key, Ref r) { return key < view(r); });
+        out = std::move_backward(stop, end, out);
+        *--out = *it;
+        end = stop;
+    }
+
+    recent.clear();
+    removedCount = 0;
+    if (text.size() > 2 * liveBytes + MIN_RECENT) {
+        compactText();
+    }
+}
+
+void NamePrefixIndex::compactText() {
+    std::string compacted;
+    compacted.reserve(liveBytes);
+    for (Ref& ref : sorted) {
+        std::string_view name = view(ref);
+        ref.offset = static_cast<uint32_t>(compacted.size());
+        compacted.append(name.data(), name.size());
+    }
+    text.swap(compacted);
+}
+
+bool NamePrefixIndex::add(std::string_view name) {
+    if (!hasRoom(name)) {
+        // Removed names still take up the buffer until it is compacted
+        merge();
+        compactText();
+        if (!hasRoom(name)) {
+            return false;
+        }
+    }
+    Ref ref = store(name);
+    auto at = std::upper_bound(recent.begin(), recent.end(), name,
+                               [this](std::string_view key, Ref r) { return key < view(r); });
+    recent.insert(at, ref);
+    mergeIfDue();
+    return true;
+}
+
+void NamePrefixIndex::addAll(const std::vector<std::string_view>& names) {
+    size_t bytes = 0;
+    for (std::string_view name : names) {
+        bytes += name.size();
+    }
+    if (text.size() + bytes >= REMOVED) {
+        throw InvalidOperationException("Too many names to index");
+    }
+    recent.reserve(recent.size() + names.size());
+    for (std::string_view name : names) {
+        recent.push_back(store(name));
+    }
+    sortRecent();
+    merge();
+    // Matches for a prefix then sit next to each other in memory
+    compactText();
+}
+
+bool NamePrefixIndex::remove(std::string_view name) {
+    auto lessThan = [this](Ref r, std::string_view key) { return view(r) < key; };
+
+    // The name's bytes stay in the buffer until the next merge
+    auto at = std::lower_bound(recent.begin(), recent.end(), name, lessThan);
+    if (at != recent.end() && view(*at) == name) {
+        liveBytes -= at->length;
+        recent.erase(at);
+        return true;
+    }
+    for (auto it = std::lower_bound(sorted.begin(), sorted.end(), name, lessThan);
+         it != sorted.end() && view(*it) == name; ++it) {
+        if (!(it->length & REMOVED)) {
+            liveBytes -= it->length;
+            it->length |= REMOVED;
+            ++removedCount;
+            mergeIfDue();
+            return true;
+        }
+    }
+    return false;
+}
+
+void NamePrefixIndex::clear() {
+    text.clear();
+    sorted.clear();
+    recent.clear();
+    removedCount = 0;
+    liveBytes = 0;
+}
+
+std::vector<std::string> NamePrefixIndex::complete(std::string_view prefix, size_t limit) const {
+    auto lessThan = [this](Ref r, std::string_view key) { return view(r) < key; };
+    auto a = std::lower_bound(sorted.begin(), sorted.end(), prefix, lessThan);
+    auto b = std::lower_bound(recent.begin(), recent.end(), prefix, lessThan);
+
+    std::vector<std::string> result;
+    while (result.size() < limit) {
+        while (a != sorted.end() && (a->length & REMOVED)) {
+            ++a;
+        }
+        bool fromMain = a != sorted.end() && startsWith(view(*a), prefix);
+        bool fromRecent = b != recent.end() && startsWith(view(*b), prefix);
+        if (!fromMain && !fromRecent) {
+            break;
+        }
+        if (fromMain && (!fromRecent || !(view(*b) < view(*a)))) {
+            result.emplace_back(view(*a++));
+        } else {
+            result.emplace_back(view(*b++));
+        }
+    }
+    return result;
+}
+
+size_t NamePrefixIndex::size() const {
+    return sorted.size() - removedCount + recent.size();
+}
+
+size_t NamePrefixIndex::memoryUsage() const {
+    return text.capacity() + (sorted.capacity() + recent.capacity()) * sizeof(Ref);
+}
@@ -0,0 +1,73 @@
+#ifndef NAMEPREFIXINDEX_H
+#define NAMEPREFIXINDEX_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Animal names in byte order, for prefix search and autocomplete
+ * Names live back to back in one character buffer, referenced by 8-byte
+ * offset/length pairs in two sorted runs: a large main run and a small
+ * run of recent adds. An add goes into the small run; once that holds
+ * more than about sqrt(2n) names it is merged into the main run in
+ * place, which moves references but reads few names. A removal marks
+ * its main-run entry, and enough marks trigger the same merge. Once over
+ * half the buffer is removed names, it is rewritten in name order.
+ *
+ * A lookup is one binary search per run, then a walk over the matches,
+ * so it costs O(log n + matches) at any size. Several animals may share
+ * a name; each one is listed. The buffer holds up to 2 GiB of names
+ * (offsets are 32-bit and the top bit of a length marks a removal).
+ */
+class NamePrefixIndex {
+private:
+    struct Ref {
+        uint32_t offset;
+        uint32_t length;        // REMOVED is set on dropped main-run names
+    };
+    static const uint32_t REMOVED = 0x80000000u;
+
+    std::string text;
+    std::vector<Ref> sorted;
+    std::vector<Ref> recent;
+    size_t removedCount;
+    size_t liveBytes;
+
+    std::string_view view(Ref ref) const {
+        return std::string_view(text.data() + ref.offset, ref.length & ~REMOVED);
+    }
+    bool hasRoom(std::string_view name) const;
+    Ref store(std::string_view name);
+    void sortRecent();
+    void mergeIfDue();
+    void merge();
+    void compactText();
+
+public:
+    NamePrefixIndex();
+
+    // Whether names totalling this many bytes can be indexed
+    static bool fits(size_t nameBytes) { return nameBytes < REMOVED; }
+
+    // False, leaving the index as it was, if the buffer has no room for
+    // name even after dropping removed names
+    bool add(std::string_view name);
+    // Takes every name at once: one sort instead of a merge per sqrt(n)
+    // adds. Throws InvalidOperationException if they do not fit.
+    void addAll(const std::vector<std::string_view>& names);
+    // Drops one occurrence of name; false if it is not indexed
+    bool remove(std::string_view name);
+    void clear();
+
+    // Up to limit names starting with prefix, in byte order
+    std::vector<std::string> complete(std::string_view prefix, size_t limit) const;
+
+    size_t size() const;
+    // Heap held by the buffer and both runs
+    size_t memoryUsage() const;
+};
+
+#endif // NAMEPREFIXINDEX_H
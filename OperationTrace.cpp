@@ -0,0 +1,194 @@
+#include "OperationTrace.h"
+#include "AnimalRecord.h"
+#include "BinaryCodec.h"
+#include "Exceptions.h"
+#include <iterator>
+
+namespace {
+
+const char MAGIC[4] = { 'Z', 'T', 'R', 'C' };
+const uint32_t FORMAT_VERSION = 1;
+
+// Fields stored for each op
+enum : uint8_t { SCOPE = 1, NAME = 2, VALUE = 4, ANIMAL = 8 };
+
+struct OpInfo {
+    const char* name;
+    uint8_t fields;
+};
+
+const OpInfo OPS[] = {
+    { "zoo-open", SCOPE | VALUE },
+    { "zoo-seed", ANIMAL },
+    { "add", ANIMAL },
+    { "remove", NAME },
+    { "find", NAME },
+    { "count-species", NAME },
+    { "total-food", 0 },
+    { "feed", 0 },
+    { "checkups", 0 },
+    { "sick-checkups", 0 },
+    { "dispatch-vet", SCOPE },
+    { "set-weight", NAME | VALUE },
+    { "set-health", NAME | VALUE },
+    { "vet-notified", SCOPE | NAME },
+    { "vet-treat", SCOPE | NAME },
+    { "vet-checkup", SCOPE | NAME },
+    { "enclosure-add", SCOPE | ANIMAL },
+    { "enclosure-remove", SCOPE | NAME },
+    { "remove-animal", ANIMAL },
+};
+
+static_assert(sizeof(OPS) / sizeof(OPS[0]) == static_cast<size_t>(TraceOp::COUNT),
+              "every TraceOp needs an OPS entry");
+
+} // namespace
+
+const char* traceOpName(TraceOp op) {
+    return op < TraceOp::COUNT ? OPS[static_cast<size_t>(op)].name : "unknown";
+}
+
+// ---- OperationRecorder ----
+
+OperationRecorder::Pause::Pause(OperationRecorder* recorder) : recorder(recorder) {
+    if (recorder) {
+        ++recorder->paused;
+    }
+}
+
+OperationRecorder::Pause::~Pause() {
+    if (recorder) {
+        --recorder->paused;
+    }
+}
+
+OperationRecorder::OperationRecorder(const std::string& path)
+    : file(path, std::ios::binary | std::ios::trunc), path(path),
+      start(std::chrono::steady_clock::now()), lastMicros(0), eventCount(0),
+      bytesWritten(0), paused(0) {
+    if (!file) {
+        throw InvalidOperationException("Cannot open file for writing: " + path);
+    }
+    buffer.reserve(FLUSH_SIZE + 1024);
+    buffer.append(MAGIC, sizeof(MAGIC));
+    BinaryCodec::putU32(buffer, FORMAT_VERSION);
+}
+
+OperationRecorder::~OperationRecorder() {
+    try {
+        flush();
+    } catch (const InvalidOperationException&) {
+        // Nothing to report to from a destructor; call flush() to find out
+    }
+}
+
+bool OperationRecorder::begin(TraceOp op) {
+    if (paused > 0) {
+        return false;
+    }
+    uint64_t now = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count());
+    BinaryCodec::putU8(buffer, static_cast<uint8_t>(op));
+    BinaryCodec::putVarint(buffer, now - lastMicros);
+    lastMicros = now;
+    ++eventCount;
+    return true;
+}
+
+void OperationRecorder::record(TraceOp op) {
+    if (begin(op) && buffer.size() >= FLUSH_SIZE) {
+        flush();
+    }
+}
+
+void OperationRecorder::record(TraceOp op, const std::string& scope, const std::string& name) {
+    record(op, scope, name, 0.0);
+}
+
+void OperationRecorder::record(TraceOp op, const std::string& scope, const std::string& name,
+                               double value) {
+    if (!begin(op)) {
+        return;
+    }
+    uint8_t fields = OPS[static_cast<size_t>(op)].fields;
+    if (fields & SCOPE) BinaryCodec::putText(buffer, scope);
+    if (fields & NAME) BinaryCodec::putText(buffer, name);
+    if (fields & VALUE) BinaryCodec::putF64(buffer, value);
+    if (buffer.size() >= FLUSH_SIZE) {
+        flush();
+    }
+}
+
+void OperationRecorder::recordAnimal(TraceOp op, const std::string& scope, const Animal& animal) {
+    if (!begin(op)) {
+        return;
+    }
+    if (OPS[static_cast<size_t>(op)].fields & SCOPE) {
+        BinaryCodec::putText(buffer, scope);
+    }
+    std::string bytes;
+    AnimalRecord::capture(animal).encode(bytes);
+    BinaryCodec::putText(buffer, bytes);
+    if (buffer.size() >= FLUSH_SIZE) {
+        flush();
+    }
+}
+
+void OperationRecorder::flush() {
+    if (buffer.empty()) {
+        return;
+    }
+    file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    file.flush();
+    if (!file) {
+        throw InvalidOperationException("Cannot write trace: " + path);
+    }
+    bytesWritten += buffer.size();
+    buffer.clear();
+}
+
+uint64_t OperationRecorder::getEventCount() const {
+    return eventCount;
+}
+
+uint64_t OperationRecorder::getByteCount() const {
+    return bytesWritten + buffer.size();
+}
+
+// ---- Reading ----
+
+std::vector<TraceEvent> readTrace(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw InvalidOperationException("Cannot open trace: " + path);
+    }
+    std::string bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    if (bytes.size() < sizeof(MAGIC) + 4 || bytes.compare(0, sizeof(MAGIC), MAGIC, sizeof(MAGIC)) != 0) {
+        throw InvalidOperationException("Not a zoo trace: " + path);
+    }
+    BinaryCodec::Reader in(bytes.data() + sizeof(MAGIC), bytes.size() - sizeof(MAGIC));
+    if (in.u32() != FORMAT_VERSION) {
+        throw InvalidOperationException("Unsupported trace version: " + path);
+    }
+
+    std::vector<TraceEvent> events;
+    uint64_t at = 0;
+    while (!in.atEnd()) {
+        TraceEvent event;
+        uint8_t op = in.u8();
+        if (op >= static_cast<uint8_t>(TraceOp::COUNT)) {
+            throw InvalidOperationException("Corrupt trace: " + path);
+        }
+        event.op = static_cast<TraceOp>(op);
+        at += in.varint();
+        event.atMicros = at;
+        uint8_t fields = OPS[op].fields;
+        if (fields & SCOPE) event.scope = in.text();
+        if (fields & NAME) event.name = in.text();
+        if (fields & VALUE) event.value = in.f64();
+        if (fields & ANIMAL) event.animal = in.text();
+        events.push_back(std::move(event));
+    }
+    return events;
+}
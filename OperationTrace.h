@@ -0,0 +1,122 @@
+#ifndef OPERATIONTRACE_H
+#define OPERATIONTRACE_H
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+class Animal;
+
+/**
+ * Compact binary traces of the calls made on a Zoo, its animals,
+ * Veterinarians and Enclosures, for replaying a real workload later
+ * (see TraceReplayer.h)
+ *
+ * File layout (integers in BinaryCodec varint form):
+ *   header: "ZTRC" version(u32)
+ *   events: op(u8) microseconds since the previous event, then the fields
+ *           the op uses, in the order scope, name, value (f64), animal
+ *           (AnimalRecord::encode() bytes, length-prefixed)
+ *
+ * Only calls made from outside are recorded. Work a call does internally
+ * (the checkups inside performDailyCheckups, the treatments inside
+ * dispatchVeterinarian, the health changes they cause) is redone by the
+ * replay, so it runs under an OperationRecorder::Pause.
+ */
+enum class TraceOp : uint8_t {
+    ZooOpen,            // scope = zoo name, value = capacity
+    ZooSeed,            // animal already in the zoo when recording started
+    ZooAdd,
+    ZooRemove,
+    ZooFind,
+    ZooCountSpecies,    // name = species
+    ZooTotalFood,
+    ZooFeed,
+    ZooDailyCheckups,
+    ZooSickCheckups,
+    ZooDispatchVet,     // scope = vet name
+    SetWeight,          // name = animal, value = kg
+    SetHealth,          // name = animal, value = 1 healthy / 0 sick
+    VetNotified,        // scope = vet, name = animal
+    VetTreat,
+    VetCheckup,
+    EnclosureAdd,       // scope = enclosure, animal
+    EnclosureRemove,    // scope = enclosure, name = animal
+    ZooRemoveAnimal,    // animal = the one removed, matched by its whole record
+    COUNT
+};
+
+const char* traceOpName(TraceOp op);
+
+struct TraceEvent {
+    TraceOp op;
+    uint64_t atMicros;      // since the recording started
+    std::string scope;
+    std::string name;
+    double value;
+    std::string animal;     // AnimalRecord::encode() bytes
+
+    TraceEvent() : op(TraceOp::ZooOpen), atMicros(0), value(0.0) {}
+};
+
+/**
+ * Appends events to a trace file through a 64 KiB buffer
+ * Attach one recorder to the zoo, vets and enclosures of one thread with
+ * their setRecorder(); it must outlive them or be detached first.
+ */
+class OperationRecorder {
+public:
+    static const size_t FLUSH_SIZE = size_t(1) << 16;
+
+    /**
+     * Suspends recording for its lifetime; nests, and accepts nullptr
+     */
+    class Pause {
+    private:
+        OperationRecorder* recorder;
+
+    public:
+        explicit Pause(OperationRecorder* recorder);
+        ~Pause();
+
+        Pause(const Pause&) = delete;
+        Pause& operator=(const Pause&) = delete;
+    };
+
+private:
+    std::ofstream file;
+    std::string path;
+    std::string buffer;
+    std::chrono::steady_clock::time_point start;
+    uint64_t lastMicros;
+    uint64_t eventCount;
+    uint64_t bytesWritten;
+    int paused;
+
+    bool begin(TraceOp op);
+
+public:
+    explicit OperationRecorder(const std::string& path);
+    ~OperationRecorder();
+
+    OperationRecorder(const OperationRecorder&) = delete;
+    OperationRecorder& operator=(const OperationRecorder&) = delete;
+
+    void record(TraceOp op);
+    void record(TraceOp op, const std::string& scope, const std::string& name);
+    void record(TraceOp op, const std::string& scope, const std::string& name, double value);
+    void recordAnimal(TraceOp op, const std::string& scope, const Animal& animal);
+
+    // Writes buffered events to the file; throws InvalidOperationException
+    void flush();
+
+    uint64_t getEventCount() const;
+    uint64_t getByteCount() const;
+};
+
+// Reads a whole trace; throws InvalidOperationException if it is not one
+std::vector<TraceEvent> readTrace(const std::string& path);
+
+#endif // OPERATIONTRACE_H
@@ -0,0 +1,106 @@
+#ifndef PARALLELREDUCE_H
+#define PARALLELREDUCE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+/**
+ * Running sum with a compensation term (Neumaier's variant of Kahan)
+ * Keeps the rounding error lost by each addition and adds it back at the
+ * end, so a million terms lose about as much as two.
+ */
+struct CompensatedSum {
+    double sum;
+    double compensation;
+
+    CompensatedSum() : sum(0.0), compensation(0.0) {}
+
+    void add(double value) {
+        double next = sum + value;
+        if (std::fabs(sum) >= std::fabs(value)) {
+            compensation += (sum - next) + value;
+        } else {
+            compensation += (value - next) + sum;
+        }
+        sum = next;
+    }
+
+    CompensatedSum& operator+=(const CompensatedSum& other) {
+        add(other.sum);
+        compensation += other.compensation;
+        return *this;
+    }
+
+    double value() const {
+        return sum + compensation;
+    }
+};
+
+/**
+ * Deterministic parallel reduction over the indexes [0, count)
+ * The range is cut into blocks of REDUCE_BLOCK items whatever the thread
+ * count. Each block is folded in index order into its own result, then
+ * the block results are merged pairwise in a fixed tree (0+1, 2+3, then
+ * 0+2, ...). Threads only decide who computes a block, never the shape,
+ * so floating-point results are bit-identical for any thread count.
+ *
+ * accumulate(Result&, size_t index) folds one item in; combine(Result&,
+ * const Result&) merges a neighbouring block. Both must be safe to call
+ * from several threads on different results. Ranges of one block run on
+ * the calling thread without allocating.
+ */
+const size_t REDUCE_BLOCK = 4096;
+
+template <typename Result, typename Accumulate, typename Combine>
+Result parallelReduce(size_t count, unsigned threads, const Result& identity,
+                      Accumulate accumulate, Combine combine) {
+    const size_t blocks = (count + REDUCE_BLOCK - 1) / REDUCE_BLOCK;
+    if (blocks <= 1) {
+        Result result = identity;
+        for (size_t i = 0; i < count; ++i) {
+            accumulate(result, i);
+        }
+        return result;
+    }
+
+    std::vector<Result> partial(blocks, identity);
+    std::atomic<size_t> nextBlock(0);
+    auto work = [&]() {
+        for (size_t block = nextBlock++; block < blocks; block = nextBlock++) {
+            // Fold into a local and store once: neighbouring partials share
+            // cache lines, and writing them per item bounces those lines
+            // between cores
+            size_t end = std::min(count, (block + 1) * REDUCE_BLOCK);
+            Result result = identity;
+            for (size_t i = block * REDUCE_BLOCK; i < end; ++i) {
+                accumulate(result, i);
+            }
+            partial[block] = result;
+        }
+    };
+
+    // Blocks are claimed one at a time, so uneven items still balance
+    size_t helpers = std::min<size_t>(threads > 0 ? threads - 1 : 0, blocks - 1);
+    std::vector<std::thread> workers;
+    workers.reserve(helpers);
+    for (size_t t = 0; t < helpers; ++t) {
+        workers.emplace_back(work);
+    }
+    work();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    for (size_t width = 1; width < blocks; width *= 2) {
+        for (size_t i = 0; i + width < blocks; i += 2 * width) {
+            combine(partial[i], partial[i + width]);
+        }
+    }
+    return partial[0];
+}
+
+#endif // PARALLELREDUCE_H
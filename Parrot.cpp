@@ -1,14 +1,15 @@
 #include "Parrot.h"
+#include "ZooRandom.h"
 #include <iostream>
 
 Parrot::Parrot(std::string name, int age, double weight,
                double wingspan, bool canFly, std::string beakType,
                std::string plumageColor, int intelligenceLevel)
     : Bird(name, age, weight, wingspan, canFly, beakType),
-      plumageColor(plumageColor), intelligenceLevel(intelligenceLevel) {
-    // Initialize with basic vocabulary
-    vocabulary.push_back("Hello!");
-    vocabulary.push_back("Pretty bird!");
+      plumageColor(plumageColor),
+      intelligenceLevel(static_cast<uint8_t>(checkRange(intelligenceLevel, UINT8_MAX, "Intelligence level"))) {
+    species = SpeciesId::Parrot;
+    // Every parrot knows the pool's base words; nothing to store yet
 }
 
 void Parrot::makeSound() const {
@@ -19,16 +20,17 @@ void Parrot::eat() const {
     std::cout << name << " is eating seeds, nuts, and fruits." << std::endl;
 }
 
-std::string Parrot::getSpecies() const {
-    return "Parrot";
+const std::string& Parrot::getSpecies() const {
+    static const InternedString species("Parrot");
+    return species;
 }
 
 void Parrot::displayInfo() const {
     std::cout << "\n=== PARROT ===" << std::endl;
     Bird::displayInfo();
     std::cout << "Plumage Color: " << plumageColor << std::endl;
-    std::cout << "Intelligence Level: " << intelligenceLevel << "/10" << std::endl;
-    std::cout << "Vocabulary Size: " << vocabulary.size() << " words" << std::endl;
+    std::cout << "Intelligence Level: " << static_cast<int>(intelligenceLevel) << "/10" << std::endl;
+    std::cout << "Vocabulary Size: " << getVocabularySize() << " words" << std::endl;
 }
 
 void Parrot::performCheckup() {
@@ -39,7 +41,7 @@ void Parrot::performCheckup() {
 
 double Parrot::calculateFoodRequirement() const {
     // Parrots need about 8% of body weight in seeds and fruits
-    return weight * 0.08;
+    return getWeight() * 0.08;
 }
 
 void Parrot::mimic(const std::string& phrase) {
@@ -47,27 +49,41 @@ void Parrot::mimic(const std::string& phrase) {
 }
 
 void Parrot::learnWord(const std::string& word) {
-    vocabulary.push_back(word);
+    restoreWord(word);
     std::cout << name << " learned a new word: \"" << word << "\"" << std::endl;
 }
 
+void Parrot::restoreWord(const std::string& word) {
+    learnedWords.push_back(WordPool::global().add(word));
+}
+
 void Parrot::showVocabulary() const {
     std::cout << name << "'s vocabulary: ";
-    for (size_t i = 0; i < vocabulary.size(); ++i) {
-        std::cout << vocabulary[i];
-        if (i < vocabulary.size() - 1) std::cout << ", ";
+    size_t size = getVocabularySize();
+    for (size_t i = 0; i < size; ++i) {
+        std::cout << getWord(i);
+        if (i < size - 1) std::cout << ", ";
     }
     std::cout << std::endl;
 }
 
 void Parrot::talk() const {
-    if (!vocabulary.empty()) {
-        int randomIndex = rand() % vocabulary.size();
-        std::cout << name << " says: \"" << vocabulary[randomIndex] << "\"" << std::endl;
+    size_t randomIndex = ZooRandom::below(getVocabularySize());
+    std::cout << name << " says: \"" << getWord(randomIndex) << "\"" << std::endl;
+}
+
+size_t Parrot::getVocabularySize() const {
+    return WordPool::BASE_WORD_COUNT + learnedWords.size();
+}
+
+const std::string& Parrot::getWord(size_t index) const {
+    if (index < WordPool::BASE_WORD_COUNT) {
+        return WordPool::global().word(static_cast<WordPool::WordId>(index));
     }
+    return WordPool::global().word(learnedWords.at(index - WordPool::BASE_WORD_COUNT));
 }
 
-std::string Parrot::getPlumageColor() const {
+const std::string& Parrot::getPlumageColor() const {
     return plumageColor;
 }
 
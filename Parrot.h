@@ -2,16 +2,18 @@
 #define PARROT_H
 
 #include "Bird.h"
+#include "WordPool.h"
 #include <vector>
 
 /**
  * Level 2: Parrot class - can mimic sounds
  */
-class Parrot : public Bird {
+class Parrot final : public Bird {
 private:
-    std::vector<std::string> vocabulary;
-    std::string plumageColor;
-    int intelligenceLevel; // 1-10
+    // Words learned beyond the pool's base words (ids into WordPool)
+    std::vector<WordPool::WordId> learnedWords;
+    InternedString plumageColor;
+    uint8_t intelligenceLevel; // 1-10
 
 public:
     Parrot(std::string name, int age, double weight,
@@ -21,7 +23,7 @@ public:
     // Implement pure virtual methods
     void makeSound() const override;
     void eat() const override;
-    std::string getSpecies() const override;
+    const std::string& getSpecies() const override;
 
     // Override virtual methods
     void displayInfo() const override;
@@ -31,10 +33,14 @@ public:
     // Parrot-specific methods
     void mimic(const std::string& phrase);
     void learnWord(const std::string& word);
+    void restoreWord(const std::string& word); // learnWord without the message
     void showVocabulary() const;
     void talk() const;
 
-    std::string getPlumageColor() const;
+    size_t getVocabularySize() const;
+    const std::string& getWord(size_t index) const;
+
+    const std::string& getPlumageColor() const;
     int getIntelligenceLevel() const;
 };
 
@@ -5,7 +5,9 @@ Penguin::Penguin(std::string name, int age, double weight,
                  double wingspan, bool canFly, std::string beakType,
                  double swimSpeed, double divingDepth, std::string species)
     : Bird(name, age, weight, wingspan, canFly, beakType),
-      swimSpeed(swimSpeed), divingDepth(divingDepth), species(species) {
+      penguinType(species), speciesLabel("Penguin (" + species + ")"),
+      swimSpeed(static_cast<float>(swimSpeed)), divingDepth(static_cast<float>(divingDepth)) {
+    this->species = SpeciesId::Penguin;
 }
 
 void Penguin::makeSound() const {
@@ -16,14 +18,14 @@ void Penguin::eat() const {
     std::cout << name << " is eating fresh fish and krill." << std::endl;
 }
 
-std::string Penguin::getSpecies() const {
-    return "Penguin (" + species + ")";
+const std::string& Penguin::getSpecies() const {
+    return speciesLabel;
 }
 
 void Penguin::displayInfo() const {
     std::cout << "\n=== PENGUIN ===" << std::endl;
     Bird::displayInfo();
-    std::cout << "Species: " << species << std::endl;
+    std::cout << "Species: " << penguinType << std::endl;
     std::cout << "Swim Speed: " << swimSpeed << " km/h" << std::endl;
     std::cout << "Diving Depth: " << divingDepth << " meters" << std::endl;
 }
@@ -31,17 +33,20 @@ void Penguin::displayInfo() const {
 void Penguin::performCheckup() {
     Bird::performCheckup();
     std::cout << "Checking waterproofing of feathers and flipper strength..." << std::endl;
-    if (weight < 10) {
-        isHealthy = false;
+    if (!isHealthy) {
         std::cout << name << " needs vitamin supplements!" << std::endl;
     } else {
         std::cout << "Penguin " << name << " is healthy!" << std::endl;
     }
 }
 
+bool Penguin::checkHealth() const {
+    return getWeight() >= 10;
+}
+
 double Penguin::calculateFoodRequirement() const {
     // Penguins need about 10% of body weight in fish
-    return weight * 0.10;
+    return getWeight() * 0.10;
 }
 
 void Penguin::fly() {
@@ -71,3 +76,7 @@ double Penguin::getSwimSpeed() const {
 double Penguin::getDivingDepth() const {
     return divingDepth;
 }
+
+const std::string& Penguin::getPenguinType() const {
+    return penguinType;
+}
@@ -6,11 +6,14 @@
 /**
  * Level 2: Penguin class - cannot fly, swimming behavior
  */
-class Penguin : public Bird {
+class Penguin final : public Bird {
 private:
-    double swimSpeed; // km/h
-    double divingDepth; // meters
-    std::string species; // e.g., "Emperor", "Adelie"
+    InternedString penguinType;  // e.g., "Emperor", "Adelie"
+    InternedString speciesLabel; // "Penguin (<type>)", built once
+    float swimSpeed;   // km/h
+    float divingDepth; // meters
+
+    bool checkHealth() const override; // under 10 kg needs supplements
 
 public:
     Penguin(std::string name, int age, double weight,
@@ -20,7 +23,7 @@ public:
     // Implement pure virtual methods
     void makeSound() const override;
     void eat() const override;
-    std::string getSpecies() const override;
+    const std::string& getSpecies() const override;
 
     // Override virtual methods
     void displayInfo() const override;
@@ -36,6 +39,7 @@ public:
 
     double getSwimSpeed() const;
     double getDivingDepth() const;
+    const std::string& getPenguinType() const;
 };
 
 #endif // PENGUIN_H
@@ -0,0 +1,124 @@
+#include "PopulationReport.h"
+#include "Zoo.h"
+#include "ParallelReduce.h"
+#include <iomanip>
+#include <algorithm>
+#include <limits>
+#include <sstream>
+#include <string>
+
+PopulationStats::PopulationStats()
+    : count(0), sick(0), totalFood(0.0), totalAge(0.0), totalWeight(0.0),
+      minAge(std::numeric_limits<int>::max()), maxAge(0),
+      minWeight(std::numeric_limits<double>::max()), maxWeight(0.0) {}
+
+void PopulationStats::add(const Animal& animal, double food) {
+    int age = animal.getAge();
+    double weight = animal.getWeight();
+    ++count;
+    sick += !animal.getHealthStatus();
+    totalFood += food;
+    totalAge += age;
+    totalWeight += weight;
+    minAge = std::min(minAge, age);
+    maxAge = std::max(maxAge, age);
+    minWeight = std::min(minWeight, weight);
+    maxWeight = std::max(maxWeight, weight);
+}
+
+PopulationStats& PopulationStats::operator+=(const PopulationStats& other) {
+    count += other.count;
+    sick += other.sick;
+    totalFood += other.totalFood;
+    totalAge += other.totalAge;
+    totalWeight += other.totalWeight;
+    minAge = std::min(minAge, other.minAge);
+    maxAge = std::max(maxAge, other.maxAge);
+    minWeight = std::min(minWeight, other.minWeight);
+    maxWeight = std::max(maxWeight, other.maxWeight);
+    return *this;
+}
+
+double PopulationStats::meanFood() const {
+    return count ? totalFood / count : 0.0;
+}
+
+double PopulationStats::meanAge() const {
+    return count ? totalAge / count : 0.0;
+}
+
+double PopulationStats::meanWeight() const {
+    return count ? totalWeight / count : 0.0;
+}
+
+void PopulationReport::add(const Animal& animal) {
+    bySpecies[static_cast<int>(animal.getSpeciesId())].add(animal, animal.calculateFoodRequirement());
+}
+
+PopulationReport& PopulationReport::operator+=(const PopulationReport& other) {
+    for (int i = 0; i <= SPECIES_COUNT; ++i) {
+        bySpecies[i] += other.bySpecies[i];
+    }
+    return *this;
+}
+
+void PopulationReport::addZoo(const Zoo& zoo, unsigned threads) {
+    const std::vector<IAnimal*>& animals = zoo.getAnimals();
+    *this += parallelReduce(animals.size(), threads, PopulationReport(),
+        [&animals](PopulationReport& report, size_t i) {
+            const Animal* a = dynamic_cast<const Animal*>(animals[i]);
+            if (a) {
+                report.add(*a);
+            }
+        },
+        [](PopulationReport& report, const PopulationReport& other) { report += other; });
+}
+
+const PopulationStats& PopulationReport::getSpecies(SpeciesId species) const {
+    return bySpecies[std::min(static_cast<int>(species), SPECIES_COUNT)];
+}
+
+PopulationStats PopulationReport::getTotal() const {
+    PopulationStats total;
+    for (const PopulationStats& stats : bySpecies) {
+        total += stats;
+    }
+    return total;
+}
+
+void PopulationReport::print(std::ostream& out) const {
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+
+    out << "\n=== Population Report ===" << std::endl;
+    out << std::left << std::setw(10) << "Species" << std::right
+        << std::setw(8) << "Count" << std::setw(6) << "Sick"
+        << std::setw(12) << "Food kg" << std::setw(10) << "kg/anim"
+        << std::setw(15) << "Age avg/range" << std::setw(24) << "Weight avg/range" << std::endl;
+
+    auto row = [&out](const char* label, const PopulationStats& stats) {
+        out << std::left << std::setw(10) << label << std::right
+            << std::setw(8) << stats.count << std::setw(6) << stats.sick
+            << std::fixed << std::setprecision(1)
+            << std::setw(12) << stats.totalFood << std::setw(10) << stats.meanFood();
+        if (stats.count == 0) {
+            out << std::endl;
+            return;
+        }
+        std::string ages = std::to_string(stats.minAge) + "-" + std::to_string(stats.maxAge);
+        std::ostringstream weights;
+        weights << std::fixed << std::setprecision(1) << stats.minWeight << "-" << stats.maxWeight;
+        out << std::setw(7) << stats.meanAge() << std::setw(8) << ages
+            << std::setw(10) << stats.meanWeight() << std::setw(14) << weights.str() << std::endl;
+    };
+
+    for (int i = 0; i <= SPECIES_COUNT; ++i) {
+        if (bySpecies[i].count > 0) {
+            row(speciesName(static_cast<SpeciesId>(i)), bySpecies[i]);
+        }
+    }
+    row("Total", getTotal());
+
+    out.flags(flags);
+    out.precision(precision);
+}
@@ -0,0 +1,75 @@
+#ifndef POPULATIONREPORT_H
+#define POPULATIONREPORT_H
+
+#include "Animal.h"
+#include "Enclosure.h"
+#include "Species.h"
+#include <ostream>
+#include <cstddef>
+
+class Zoo;
+
+/**
+ * Count, food, age, weight and health figures for a group of animals
+ */
+struct PopulationStats {
+    size_t count;
+    size_t sick;
+    double totalFood;   // kg per day
+    double totalAge;
+    double totalWeight;
+    int minAge;
+    int maxAge;
+    double minWeight;
+    double maxWeight;
+
+    PopulationStats();
+
+    void add(const Animal& animal, double food);
+    PopulationStats& operator+=(const PopulationStats& other);
+
+    // Zero for an empty group
+    double meanFood() const;
+    double meanAge() const;
+    double meanWeight() const;
+};
+
+/**
+ * Management report built in a single pass over the animals
+ * Replaces one scan per statistic (getAnimalCount, countBySpecies for
+ * each species, calculateTotalFoodRequirement, hand-written loops for
+ * averages). Each animal is read once: its species tag, age, weight and
+ * health sit in the hot first cache line, plus one virtual call for its
+ * food requirement. Animals are grouped by SpeciesId, so a "Capuchin
+ * Monkey" counts as a Monkey, unlike Zoo::countBySpecies. Several zoos
+ * and enclosures can be added to the same report.
+ */
+class PopulationReport {
+private:
+    // One entry per SpeciesId, Unknown included
+    PopulationStats bySpecies[SPECIES_COUNT + 1];
+
+public:
+    void add(const Animal& animal);
+    PopulationReport& operator+=(const PopulationReport& other);
+
+    // Splits the zoo across threads; see parallelReduce for why the
+    // figures do not depend on the thread count
+    void addZoo(const Zoo& zoo, unsigned threads = 1);
+
+    template <typename T>
+    void addEnclosure(const Enclosure<T>& enclosure) {
+        for (const T* animal : enclosure.getAnimals()) {
+            add(*animal);
+        }
+    }
+
+    const PopulationStats& getSpecies(SpeciesId species) const;
+    // Sum over every species
+    PopulationStats getTotal() const;
+
+    // Table with one row per species present and a total row
+    void print(std::ostream& out) const;
+};
+
+#endif // POPULATIONREPORT_H
@@ -0,0 +1,35 @@
+#ifndef SPECIES_H
+#define SPECIES_H
+
+#include <cstdint>
+
+/**
+ * Compact species tag stored in every Animal
+ * Lets scans group and filter animals without a virtual getSpecies()
+ * call or a string comparison.
+ */
+enum class SpeciesId : uint8_t {
+    Lion,
+    Elephant,
+    Monkey,
+    Eagle,
+    Penguin,
+    Parrot,
+    Unknown
+};
+
+const int SPECIES_COUNT = 6;
+
+inline const char* speciesName(SpeciesId id) {
+    switch (id) {
+        case SpeciesId::Lion: return "Lion";
+        case SpeciesId::Elephant: return "Elephant";
+        case SpeciesId::Monkey: return "Monkey";
+        case SpeciesId::Eagle: return "Eagle";
+        case SpeciesId::Penguin: return "Penguin";
+        case SpeciesId::Parrot: return "Parrot";
+        default: return "Unknown";
+    }
+}
+
+#endif // SPECIES_H
@@ -0,0 +1,286 @@
+#include "TraceReplayer.h"
+#include "AnimalRecord.h"
+#include "Veterinarian.h"
+#include "Zoo.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <streambuf>
+#include <thread>
+
+namespace {
+
+// Swallows everything written to it
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize count) override { return count; }
+};
+
+// Points std::cout at a NullBuffer for its lifetime
+class SilenceConsole {
+private:
+    NullBuffer discard;
+    std::streambuf* console;
+
+public:
+    SilenceConsole() : console(std::cout.rdbuf(&discard)) {}
+    ~SilenceConsole() { std::cout.rdbuf(console); }
+};
+
+const int UNLIMITED = std::numeric_limits<int>::max();
+
+Animal* materialize(const std::string& bytes) {
+    return AnimalRecord::decode(bytes.data(), bytes.size()).materialize();
+}
+
+} // namespace
+
+TraceReplayer::TraceReplayer(const std::string& tracePath)
+    : events(readTrace(tracePath)) {
+}
+
+TraceReplayer::~TraceReplayer() {
+}
+
+Zoo& TraceReplayer::requireZoo() {
+    if (!zoo) {
+        zoo.reset(new Zoo("Replay", UNLIMITED));
+        zoo->setVerbose(false);
+    }
+    return *zoo;
+}
+
+Veterinarian& TraceReplayer::vet(const std::string& name) {
+    std::unique_ptr<Veterinarian>& slot = vets[name];
+    if (!slot) {
+        slot.reset(new Veterinarian(name, "Replay"));
+    }
+    return *slot;
+}
+
+Enclosure<Animal>& TraceReplayer::enclosure(const std::string& name) {
+    std::unique_ptr<Enclosure<Animal>>& slot = enclosures[name];
+    if (!slot) {
+        slot.reset(new Enclosure<Animal>(name, UNLIMITED));
+    }
+    return *slot;
+}
+
+Animal* TraceReplayer::findAnimal(const std::string& name) {
+    if (Animal* animal = dynamic_cast<Animal*>(requireZoo().tryFindAnimal(name))) {
+        return animal;
+    }
+    for (const auto& entry : enclosures) {
+        for (Animal* animal : entry.second->getAnimals()) {
+            if (animal->getName() == name) {
+                return animal;
+            }
+        }
+    }
+    return nullptr;
+}
+
+bool TraceReplayer::apply(const TraceEvent& event) {
+    switch (event.op) {
+        case TraceOp::ZooOpen:
+            zoo.reset(new Zoo(event.scope, static_cast<int>(event.value)));
+            zoo->setVerbose(false);
+            return true;
+
+        case TraceOp::ZooSeed:
+        case TraceOp::ZooAdd: {
+            Animal* animal = materialize(event.animal);
+            if (requireZoo().tryAddAnimal(animal) != ZooStatus::Ok) {
+                delete animal;
+                return false;
+            }
+            return true;
+        }
+
+        case TraceOp::ZooRemove:
+            return requireZoo().tryRemoveAnimal(event.name) == ZooStatus::Ok;
+
+        case TraceOp::ZooRemoveAnimal: {
+            AnimalRecord record = AnimalRecord::decode(event.animal.data(), event.animal.size());
+            std::string encoded;
+            for (IAnimal* candidate : requireZoo().findAllNamed(record.name)) {
+                encoded.clear();
+                AnimalRecord::capture(*static_cast<Animal*>(candidate)).encode(encoded);
+                if (encoded == event.animal) {
+                    return requireZoo().tryRemoveAnimal(candidate) == ZooStatus::Ok;
+                }
+            }
+            return false;
+        }
+
+        case TraceOp::ZooFind:
+            return requireZoo().tryFindAnimal(event.name) != nullptr;
+
+        case TraceOp::ZooCountSpecies:
+            requireZoo().countBySpecies(event.name);
+            return true;
+
+        case TraceOp::ZooTotalFood:
+            requireZoo().calculateTotalFoodRequirement();
+            return true;
+
+        case TraceOp::ZooFeed:
+            requireZoo().feedAllAnimals();
+            return true;
+
+        case TraceOp::ZooDailyCheckups:
+            requireZoo().performDailyCheckups();
+            return true;
+
+        case TraceOp::ZooSickCheckups:
+            requireZoo().performSickCheckups();
+            return true;
+
+        case TraceOp::ZooDispatchVet:
+            requireZoo().dispatchVeterinarian(vet(event.scope));
+            return true;
+
+        case TraceOp::EnclosureAdd: {
+            Animal* animal = materialize(event.animal);
+            try {
+                enclosure(event.scope).addAnimal(animal);
+            } catch (const std::runtime_error&) {
+                delete animal;
+                return false;
+            }
+            return true;
+        }
+
+        case TraceOp::EnclosureRemove:
+            try {
+                enclosure(event.scope).removeAnimal(event.name);
+            } catch (const std::runtime_error&) {
+                return false;
+            }
+            return true;
+
+        default:
+            break;
+    }
+
+    // The rest act on one animal, wherever it lives
+    Animal* animal = findAnimal(event.name);
+    if (!animal) {
+        return false;
+    }
+    switch (event.op) {
+        case TraceOp::SetWeight:
+            animal->setWeight(event.value);
+            break;
+        case TraceOp::SetHealth:
+            animal->setHealthStatus(event.value != 0.0);
+            break;
+        case TraceOp::VetNotified:
+            vet(event.scope).onAnimalSick(animal);
+            break;
+        case TraceOp::VetTreat:
+            vet(event.scope).treatAnimal(animal);
+            break;
+        case TraceOp::VetCheckup:
+            vet(event.scope).performCheckup(animal);
+            break;
+        default:
+            return false;
+    }
+    return true;
+}
+
+std::vector<TraceReplayer::OpStats> TraceReplayer::run(Pacing pacing) {
+    typedef std::chrono::steady_clock Clock;
+
+    enclosures.clear();
+    vets.clear();
+    zoo.reset();
+
+    const size_t opCount = static_cast<size_t>(TraceOp::COUNT);
+    std::vector<std::vector<double>> latencies(opCount);
+    std::vector<uint64_t> failures(opCount, 0);
+    {
+        SilenceConsole silence;
+        Clock::time_point start = Clock::now();
+        for (const TraceEvent& event : events) {
+            if (pacing == Pacing::Recorded) {
+                std::this_thread::sleep_until(start + std::chrono::microseconds(event.atMicros));
+            }
+            Clock::time_point before = Clock::now();
+            bool ok;
+            try {
+                ok = apply(event);
+            } catch (const std::exception&) {
+                ok = false;
+            }
+            std::chrono::duration<double, std::micro> elapsed = Clock::now() - before;
+
+            size_t op = static_cast<size_t>(event.op);
+            latencies[op].push_back(elapsed.count());
+            failures[op] += ok ? 0 : 1;
+        }
+    }
+
+    std::vector<OpStats> stats;
+    for (size_t op = 0; op < opCount; ++op) {
+        std::vector<double>& samples = latencies[op];
+        if (samples.empty()) {
+            continue;
+        }
+        std::sort(samples.begin(), samples.end());
+        double total = 0.0;
+        for (double sample : samples) {
+            total += sample;
+        }
+        OpStats s;
+        s.op = static_cast<TraceOp>(op);
+        s.count = samples.size();
+        s.failures = failures[op];
+        s.meanMicros = total / samples.size();
+        s.p50Micros = samples[samples.size() / 2];
+        s.p99Micros = samples[std::min(samples.size() - 1, samples.size() * 99 / 100)];
+        s.maxMicros = samples.back();
+        stats.push_back(s);
+    }
+    return stats;
+}
+
+size_t TraceReplayer::getEventCount() const {
+    return events.size();
+}
+
+const Zoo* TraceReplayer::getZoo() const {
+    return zoo.get();
+}
+
+void TraceReplayer::printReport(std::ostream& report, const std::vector<OpStats>& stats) {
+    report << "\n=== Replay Timing ===" << std::endl;
+    report << std::left << std::setw(18) << "operation"
+           << std::right << std::setw(12) << "count"
+           << std::setw(10) << "failed"
+           << std::setw(12) << "mean (us)"
+           << std::setw(12) << "p50 (us)"
+           << std::setw(12) << "p99 (us)"
+           << std::setw(12) << "max (us)" << std::endl;
+
+    double totalMicros = 0.0;
+    uint64_t totalCount = 0;
+    for (const OpStats& s : stats) {
+        report << std::left << std::setw(18) << traceOpName(s.op)
+               << std::right << std::setw(12) << s.count
+               << std::setw(10) << s.failures
+               << std::fixed << std::setprecision(3)
+               << std::setw(12) << s.meanMicros
+               << std::setw(12) << s.p50Micros
+               << std::setw(12) << s.p99Micros
+               << std::setw(12) << s.maxMicros << std::endl;
+        totalMicros += s.meanMicros * s.count;
+        totalCount += s.count;
+    }
+    report.unsetf(std::ios::floatfield);
+    report << "Events: " << totalCount << "  time in calls: " << totalMicros / 1000.0 << " ms" << std::endl;
+}
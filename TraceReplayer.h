@@ -0,0 +1,70 @@
+#ifndef TRACEREPLAYER_H
+#define TRACEREPLAYER_H
+
+#include "OperationTrace.h"
+#include "Enclosure.h"
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class Zoo;
+class Veterinarian;
+
+/**
+ * Re-executes a trace written by OperationRecorder and times every call
+ * The replay builds its own zoo (from the trace's ZooOpen and seed
+ * animals), plus one Veterinarian and one Enclosure<Animal> per name the
+ * trace uses. Events run back to back, or at the recorded offsets from
+ * the start. Console output of the replayed calls is discarded so it
+ * does not dominate the timings. A call that fails (animal not found,
+ * zoo full, ...) is counted and the replay goes on.
+ */
+class TraceReplayer {
+public:
+    enum class Pacing { Fastest, Recorded };
+
+    struct OpStats {
+        TraceOp op;
+        uint64_t count;
+        uint64_t failures;
+        double meanMicros;
+        double p50Micros;
+        double p99Micros;
+        double maxMicros;
+    };
+
+private:
+    std::vector<TraceEvent> events;
+    std::unique_ptr<Zoo> zoo;
+    std::map<std::string, std::unique_ptr<Veterinarian>> vets;
+    std::map<std::string, std::unique_ptr<Enclosure<Animal>>> enclosures;
+
+    Zoo& requireZoo();
+    Veterinarian& vet(const std::string& name);
+    Enclosure<Animal>& enclosure(const std::string& name);
+    Animal* findAnimal(const std::string& name);
+
+    // Returns false if the call failed
+    bool apply(const TraceEvent& event);
+
+public:
+    explicit TraceReplayer(const std::string& tracePath);
+    ~TraceReplayer();
+
+    TraceReplayer(const TraceReplayer&) = delete;
+    TraceReplayer& operator=(const TraceReplayer&) = delete;
+
+    // Replays the whole trace into a fresh zoo; one entry per op used
+    std::vector<OpStats> run(Pacing pacing);
+
+    size_t getEventCount() const;
+
+    // The zoo as the last run() left it, nullptr before the first
+    const Zoo* getZoo() const;
+
+    static void printReport(std::ostream& report, const std::vector<OpStats>& stats);
+};
+
+#endif // TRACEREPLAYER_H
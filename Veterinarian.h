@@ -2,9 +2,11 @@
 #define VETERINARIAN_H
 
 #include "Animal.h"
+#include "OperationTrace.h"
 #include <string>
 #include <vector>
 #include <iostream>
+#include <algorithm>
 
 /**
  * Observer interface for health notifications
@@ -57,22 +59,31 @@ private:
     std::string name;
     std::string specialization;
     int animalsTeated;
+    OperationRecorder* recorder;   // not owned, see setRecorder
 
 public:
     Veterinarian(const std::string& vetName, const std::string& spec)
-        : name(vetName), specialization(spec), animalsTeated(0) {
+        : name(vetName), specialization(spec), animalsTeated(0), recorder(nullptr) {
         std::cout << "Veterinarian " << name << " (" << specialization 
                   << ") is now on duty!" << std::endl;
     }
 
     // Observer pattern implementation
     void onAnimalSick(Animal* animal) override {
+        if (recorder) {
+            recorder->record(TraceOp::VetNotified, name, animal->getName());
+        }
+        OperationRecorder::Pause pause(recorder);
         std::cout << "\n?? ALERT: Dr. " << name << " has been notified!" << std::endl;
         treatAnimal(animal);
     }
 
     // Treat a sick animal
     void treatAnimal(Animal* animal) {
+        if (recorder) {
+            recorder->record(TraceOp::VetTreat, name, animal->getName());
+        }
+        OperationRecorder::Pause pause(recorder);
         std::cout << "Dr. " << name << " is treating " << animal->getName() << "..." << std::endl;
         
         std::cout << "Performing examination..." << std::endl;
@@ -93,6 +104,10 @@ public:
 
     // Perform routine checkup
     void performCheckup(Animal* animal) {
+        if (recorder) {
+            recorder->record(TraceOp::VetCheckup, name, animal->getName());
+        }
+        OperationRecorder::Pause pause(recorder);
         std::cout << "\nDr. " << name << " performing checkup on " 
                   << animal->getName() << "..." << std::endl;
         animal->performCheckup();
@@ -106,9 +121,13 @@ public:
         std::cout << "Animals treated: " << animalsTeated << std::endl;
     }
 
-    std::string getName() const { return name; }
-    std::string getSpecialization() const { return specialization; }
+    const std::string& getName() const { return name; }
+    const std::string& getSpecialization() const { return specialization; }
     int getTreatmentCount() const { return animalsTeated; }
+
+    // Log notifications, treatments and checkups to recorder (nullptr stops)
+    void setRecorder(OperationRecorder* newRecorder) { recorder = newRecorder; }
+    OperationRecorder* getRecorder() const { return recorder; }
 };
 
 #endif // VETERINARIAN_H
@@ -0,0 +1,68 @@
+#include "WordPool.h"
+#include "InternTable.h"
+#include "Exceptions.h"
+#include <stdexcept>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+WordPool::WordPool() : chunks(), count(0) {
+    add("Hello!");
+    add("Pretty bird!");
+}
+
+WordPool& WordPool::global() {
+    static WordPool pool;
+    return pool;
+}
+
+unsigned WordPool::chunkOf(WordId id, WordId& offset) {
+    uint64_t biased = static_cast<uint64_t>(id) + (1u << FIRST_CHUNK_BITS);
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanReverse64(&index, biased);
+    unsigned top = static_cast<unsigned>(index);
+#else
+    unsigned top = 63 - __builtin_clzll(biased);
+#endif
+    offset = static_cast<WordId>(biased - (uint64_t(1) << top));
+    return top - FIRST_CHUNK_BITS;
+}
+
+WordPool::WordId WordPool::add(std::string_view word) {
+    // Interned strings are unique, so the pointer identifies the word
+    const std::string* text = InternTable::global().intern(word);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = ids.find(text);
+    if (it != ids.end()) {
+        return it->second;
+    }
+    WordId id = count.load(std::memory_order_relaxed);
+    WordId offset;
+    unsigned chunk = chunkOf(id, offset);
+    if (chunk >= CHUNK_COUNT) {
+        throw InvalidOperationException("Word pool is full");
+    }
+    if (!chunks[chunk]) {
+        chunks[chunk] = new const std::string*[size_t(1) << (chunk + FIRST_CHUNK_BITS)];
+    }
+    chunks[chunk][offset] = text;
+    ids.emplace(text, id);
+    // Readers that see the new count also see the word and its chunk
+    count.store(id + 1, std::memory_order_release);
+    return id;
+}
+
+const std::string& WordPool::word(WordId id) const {
+    if (id >= count.load(std::memory_order_acquire)) {
+        throw std::out_of_range("WordPool::word");
+    }
+    WordId offset;
+    unsigned chunk = chunkOf(id, offset);
+    return *chunks[chunk][offset];
+}
+
+size_t WordPool::size() const {
+    return count.load(std::memory_order_acquire);
+}
@@ -0,0 +1,50 @@
+#ifndef WORDPOOL_H
+#define WORDPOOL_H
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <atomic>
+#include <mutex>
+#include <cstdint>
+
+/**
+ * Shared, deduplicated pool of words that parrots can say
+ * A parrot's vocabulary is a list of small WordIds into this pool.
+ * The words every parrot starts with are pre-registered as the first
+ * BASE_WORD_COUNT ids, so a new parrot does not store them at all.
+ *
+ * Adding a word takes a lock; looking one up does not. Words live in
+ * chunks that double in size and never move, and the count is published
+ * only after the word is in place.
+ */
+class WordPool {
+public:
+    typedef uint32_t WordId;
+
+    static constexpr WordId BASE_WORD_COUNT = 2; // "Hello!", "Pretty bird!"
+
+    static WordPool& global();
+
+    WordId add(std::string_view word);
+    const std::string& word(WordId id) const;
+    size_t size() const;
+
+private:
+    static constexpr unsigned FIRST_CHUNK_BITS = 4;    // 16 words
+    static constexpr unsigned CHUNK_COUNT = 32 - FIRST_CHUNK_BITS;
+
+    std::mutex mutex;                                   // guards add()
+    const std::string** chunks[CHUNK_COUNT];            // interned, never freed
+    std::atomic<WordId> count;
+    std::unordered_map<const std::string*, WordId> ids;
+
+    // Chunk c holds ids [16 * (2^c - 1), 16 * (2^(c+1) - 1))
+    static unsigned chunkOf(WordId id, WordId& offset);
+
+    WordPool();
+    WordPool(const WordPool&) = delete;
+    WordPool& operator=(const WordPool&) = delete;
+};
+
+#endif // WORDPOOL_H
@@ -6,12 +6,94 @@
 #include "Eagle.h"
 #include "Penguin.h"
 #include "Parrot.h"
+#include "Veterinarian.h"
+#include "ZooArchive.h"
+#include "HistoryStore.h"
+#include "AnomalyDetector.h"
+#include "AtomicFileWriter.h"
+#include "AllocationTracker.h"
+#include "ParallelReduce.h"
+#include "ZooSketches.h"
+#include "OperationTrace.h"
 #include <iostream>
 #include <fstream>
 #include <algorithm>
+#include <cstdio>
+#include <utility>
+
+namespace {
+
+// The fields saveToFile writes, copied out of one animal
+struct SavedAnimal {
+    const std::string* species;   // getSpecies() values are interned, never freed
+    std::string name;
+    int age;
+    double weight;
+    bool healthy;
+};
+
+void appendRecord(std::string& out, const std::string& species, const std::string& name,
+                  int age, double weight, bool healthy) {
+    // Weights are whole grams: three decimals hold them exactly, and
+    // trailing zeros are dropped so 190 kg still reads "190"
+    char number[32];
+    out += species;
+    out += '|';
+    out += name;
+    out += '|';
+    out += std::to_string(age);
+    out += '|';
+    int length = std::snprintf(number, sizeof(number), "%.3f", weight);
+    while (length > 0 && number[length - 1] == '0') {
+        --length;
+    }
+    if (length > 0 && number[length - 1] == '.') {
+        --length;
+    }
+    out.append(number, static_cast<size_t>(length));
+    out += '|';
+    out += healthy ? '1' : '0';
+}
+
+std::vector<SavedAnimal> captureAnimals(const std::vector<IAnimal*>& animals) {
+    std::vector<SavedAnimal> saved;
+    saved.reserve(animals.size());
+    for (const IAnimal* animal : animals) {
+        const Animal* a = dynamic_cast<const Animal*>(animal);
+        if (a) {
+            saved.push_back({ &a->getSpecies(), a->getName(), a->getAge(), a->getWeight(),
+                              a->getHealthStatus() });
+        }
+    }
+    return saved;
+}
+
+void writeSaved(const std::string& filename, const std::string& zooName, int capacity,
+                const std::vector<SavedAnimal>& saved) {
+    AllocationScope scope(AllocRegion::Persistence);
+    AtomicFileWriter writer(filename);
+    std::string& out = writer.buffer();
+    out += zooName;
+    out += '\n';
+    out += std::to_string(capacity);
+    out += '\n';
+    out += std::to_string(saved.size());
+    out += '\n';
+    for (const SavedAnimal& animal : saved) {
+        appendRecord(writer.buffer(), *animal.species, animal.name, animal.age,
+                     animal.weight, animal.healthy);
+        writer.buffer() += '\n';
+        writer.flushIfFull();
+    }
+    writer.commit();
+}
+
+} // namespace
 
 Zoo::Zoo(std::string name, int capacity)
-    : zooName(name), capacity(capacity) {
+    : zooName(name), capacity(capacity), verbose(true), history(nullptr),
+      anomalies(nullptr), recorder(nullptr), sketches(nullptr),
+      namePrefixesDropped(false), nameBytes(0) {
     std::cout << "Creating zoo: " << zooName << " (Capacity: " << capacity << ")" << std::endl;
 }
 
@@ -21,7 +103,9 @@ Zoo::~Zoo() {
 
 // Copy constructor (Rule of Three)
 Zoo::Zoo(const Zoo& other)
-    : zooName(other.zooName + "_copy"), capacity(other.capacity) {
+    : zooName(other.zooName + "_copy"), capacity(other.capacity),
+      verbose(other.verbose), history(nullptr), anomalies(nullptr), recorder(nullptr),
+      sketches(nullptr), namePrefixesDropped(false), nameBytes(0) {
     deepCopy(other);
 }
 
@@ -31,54 +115,379 @@ Zoo& Zoo::operator=(const Zoo& other) {
         cleanup();
         zooName = other.zooName + "_copy";
         capacity = other.capacity;
+        verbose = other.verbose;
         deepCopy(other);
     }
     return *this;
 }
 
 void Zoo::deepCopy(const Zoo& other) {
+    other.ensureLoaded();
     // Note: Deep copy would require cloneable interface
     // For simplicity, we'll do a shallow copy warning
     std::cout << "Warning: Zoo copy constructor performs shallow copy of animal pointers." << std::endl;
     animals = other.animals;
+    sickAnimals = other.sickAnimals;
+    nameIndex = other.nameIndex;
+    nameBytes = other.nameBytes;
 }
 
 void Zoo::cleanup() {
     for (IAnimal* animal : animals) {
+        if (history && dynamic_cast<Animal*>(animal)) {
+            history->forget(static_cast<Animal*>(animal)->getId());
+        }
         delete animal;
     }
     animals.clear();
+    sickAnimals.clear();
+    nameIndex.clear();
+    archived.reset();
+    if (anomalies) {
+        anomalies->clear();
+    }
+    if (sketches) {
+        sketches->clear();
+    }
+    rankings.reset();
+    namePrefixes.reset();
+    namePrefixesDropped = false;
+    nameBytes = 0;
 }
 
-void Zoo::addAnimal(IAnimal* animal) {
-    if (animals.size() >= static_cast<size_t>(capacity)) {
-        throw ZooFullException(capacity);
+void Zoo::ensureLoaded() const {
+    if (!archived) {
+        return;
+    }
+    // Loading is not a visible change of state, so it is allowed from
+    // const members; Zoo objects are never defined const themselves
+    Zoo* self = const_cast<Zoo*>(this);
+    std::unique_ptr<LazyArchive> pending = std::move(self->archived);
+    pending->drain([self](Animal* animal) { self->adopt(animal); });
+}
+
+void Zoo::adopt(Animal* animal) {
+    OperationRecorder* wasRecording = recorder;
+    bool wasVerbose = verbose;
+    recorder = nullptr;
+    verbose = false;
+    try {
+        addAnimal(animal);
+    } catch (...) {
+        recorder = wasRecording;
+        verbose = wasVerbose;
+        delete animal;
+        throw;
+    }
+    recorder = wasRecording;
+    verbose = wasVerbose;
+}
+
+void Zoo::onHealthChanged(Animal* animal, bool healthy) {
+    if (recorder) {
+        recorder->record(TraceOp::SetHealth, "", animal->getName(), healthy ? 1.0 : 0.0);
+    }
+    sickAnimals.set(animal->getSlot(), !healthy);
+    recordHistory(*animal);
+    if (anomalies) {
+        anomalies->observeHealth(animal, animal->getSlot(), healthy);
+    }
+}
+
+void Zoo::onWeightChanged(Animal* animal, double weight) {
+    if (recorder) {
+        recorder->record(TraceOp::SetWeight, "", animal->getName(), weight);
+    }
+    recordHistory(*animal);
+    if (anomalies) {
+        anomalies->observeWeight(animal, animal->getSlot(), weight);
+    }
+    if (sketches) {
+        sketches->onChanged(*animal, animal->getSlot());
+    }
+    if (rankings) {
+        rankings->onChanged(animal, animal->getSlot());
+    }
+}
+
+void Zoo::onAgeChanged(Animal* animal, int) {
+    if (sketches) {
+        sketches->onChanged(*animal, animal->getSlot());
+    }
+    if (rankings) {
+        rankings->onChanged(animal, animal->getSlot());
+    }
+}
+
+void Zoo::onCheckup(Animal* animal, bool healthy) {
+    recordHistory(*animal);
+    if (anomalies) {
+        anomalies->observeHealth(animal, animal->getSlot(), healthy);
+    }
+}
+
+void Zoo::recordHistory(const Animal& animal) {
+    if (!history) {
+        return;
+    }
+    try {
+        history->recordNow(animal.getId(), animal.getWeight(), animal.getHealthStatus());
+    }
+    catch (const InvalidOperationException&) {
+        // The clock went backwards for this animal; history is append-only,
+        // and a setter on the animal is no place to fail
+    }
+}
+
+const char* zooStatusName(ZooStatus status) {
+    switch (status) {
+        case ZooStatus::Ok: return "ok";
+        case ZooStatus::NotFound: return "not-found";
+        case ZooStatus::Full: return "full";
+        case ZooStatus::InvalidAnimal: return "invalid-animal";
+    }
+    return "unknown";
+}
+
+size_t Zoo::nameKey(const std::string& name) {
+    return std::hash<std::string>()(name);
+}
+
+size_t Zoo::findSlot(const std::string& name) const {
+    // Several animals may share a name; the lowest slot wins, as it did
+    // when lookups scanned the animals in order
+    size_t found = NO_SLOT;
+    auto range = nameIndex.equal_range(nameKey(name));
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second < found && static_cast<const Animal*>(animals[it->second])->getName() == name) {
+            found = it->second;
+        }
+    }
+    return found;
+}
+
+void Zoo::unindexName(const std::string& name, size_t slot) {
+    auto range = nameIndex.equal_range(nameKey(name));
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second == slot) {
+            nameIndex.erase(it);
+            return;
+        }
+    }
+}
+
+// Repoints an index entry in place rather than erasing and re-inserting
+// it, which would free and allocate a node
+void Zoo::moveIndexedName(const std::string& name, size_t from, size_t to) {
+    auto range = nameIndex.equal_range(nameKey(name));
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second == from) {
+            it->second = to;
+            return;
+        }
+    }
+}
+
+void Zoo::onNameChanged(Animal* animal, const std::string& oldName) {
+    // History is kept by animal id, so the series simply carries on
+    unindexName(oldName, animal->getSlot());
+    nameIndex.emplace(nameKey(animal->getName()), animal->getSlot());
+    updateNamePrefixes(&animal->getName(), &oldName);
+}
+
+void Zoo::updateNamePrefixes(const std::string* added, const std::string* removed) {
+    if (added) {
+        nameBytes += added->size();
+    }
+    if (removed) {
+        nameBytes -= removed->size();
+    }
+    if (namePrefixes) {
+        if (removed) {
+            namePrefixes->remove(*removed);
+        }
+        // add() already compacts before giving up, so a failure means the
+        // names no longer fit at all
+        if (added && !namePrefixes->add(*added)) {
+            namePrefixes.reset();
+            namePrefixesDropped = true;
+        }
+    } else if (namePrefixesDropped && NamePrefixIndex::fits(nameBytes)) {
+        namePrefixesDropped = false;
+        completeName(std::string(), 0); // builds the index
+    }
+}
+
+ZooStatus Zoo::tryAddAnimal(IAnimal* animal) {
+    AllocationScope scope(AllocRegion::Zoo);
+    if (recorder && dynamic_cast<const Animal*>(animal)) {
+        recorder->recordAnimal(TraceOp::ZooAdd, "", *static_cast<const Animal*>(animal));
+    }
+    if (static_cast<size_t>(getAnimalCount()) >= static_cast<size_t>(capacity)) {
+        return ZooStatus::Full;
     }
     if (animal == nullptr) {
-        throw InvalidOperationException("Cannot add null animal");
+        return ZooStatus::InvalidAnimal;
     }
+    size_t slot = animals.size();
     animals.push_back(animal);
-    std::cout << "Added " << animal->getSpecies() << " named " 
-              << dynamic_cast<Animal*>(animal)->getName() << " to the zoo." << std::endl;
+    sickAnimals.resize(animals.size());
+
+    Animal* a = dynamic_cast<Animal*>(animal);
+    if (a) {
+        a->attachObserver(this, slot);
+        nameIndex.emplace(nameKey(a->getName()), slot);
+        sickAnimals.set(slot, !a->getHealthStatus());
+        if (anomalies) {
+            anomalies->resize(slot); // forget whatever last lived in this slot
+        }
+        if (sketches) {
+            sketches->onAdded(*a, slot);
+        }
+        if (rankings) {
+            rankings->onAdded(a, slot);
+        }
+        updateNamePrefixes(&a->getName(), nullptr);
+        recordHistory(*a);
+    }
+
+    if (verbose) {
+        std::cout << "Added " << animal->getSpecies() << " named " 
+                  << dynamic_cast<Animal*>(animal)->getName() << " to the zoo." << std::endl;
+    }
+    return ZooStatus::Ok;
+}
+
+void Zoo::addAnimal(IAnimal* animal) {
+    switch (tryAddAnimal(animal)) {
+        case ZooStatus::Full:
+            throw ZooFullException(capacity);
+        case ZooStatus::InvalidAnimal:
+            throw InvalidOperationException("Cannot add null animal");
+        default:
+            break;
+    }
+}
+
+std::vector<ZooStatus> Zoo::tryAddAnimals(const std::vector<IAnimal*>& batch) {
+    AllocationScope scope(AllocRegion::Zoo);
+    size_t room = std::min(batch.size(), static_cast<size_t>(std::max(capacity - getAnimalCount(), 0)));
+    animals.reserve(animals.size() + room);
+    nameIndex.reserve(nameIndex.size() + room);
+
+    std::vector<ZooStatus> results;
+    results.reserve(batch.size());
+    for (IAnimal* animal : batch) {
+        results.push_back(tryAddAnimal(animal));
+    }
+    return results;
+}
+
+ZooStatus Zoo::tryRemoveAnimal(const std::string& name) {
+    AllocationScope scope(AllocRegion::Zoo);
+    if (recorder) {
+        recorder->record(TraceOp::ZooRemove, "", name);
+    }
+    size_t slot = findSlot(name);
+    if (slot == NO_SLOT) {
+        return archived && archived->remove(name) ? ZooStatus::Ok : ZooStatus::NotFound;
+    }
+    removeSlot(slot, name);
+    return ZooStatus::Ok;
+}
+
+ZooStatus Zoo::tryRemoveAnimal(const IAnimal* animal) {
+    AllocationScope scope(AllocRegion::Zoo);
+    const Animal* a = dynamic_cast<const Animal*>(animal);
+    if (!a) {
+        return ZooStatus::InvalidAnimal;
+    }
+    size_t slot = a->getSlot();
+    if (slot >= animals.size() || animals[slot] != animal) {
+        return ZooStatus::NotFound;
+    }
+    // By record, not name: replaying a name would take the first of
+    // several animals that share it
+    if (recorder) {
+        recorder->recordAnimal(TraceOp::ZooRemoveAnimal, "", *a);
+    }
+    removeSlot(slot, std::string(a->getName()));
+    return ZooStatus::Ok;
+}
+
+void Zoo::removeSlot(size_t slot, const std::string& name) {
+    if (verbose) {
+        std::cout << "Removing " << animals[slot]->getSpecies() << " named " << name << std::endl;
+    }
+    unindexName(name, slot);
+    if (dynamic_cast<Animal*>(animals[slot])) {
+        updateNamePrefixes(nullptr, &name);
+    }
+    if (sketches) {
+        sketches->onRemoved(slot);
+    }
+    if (Animal* a = dynamic_cast<Animal*>(animals[slot])) {
+        if (rankings) {
+            rankings->onRemoved(a, slot);
+        }
+        // A later animal may take the name, but not the id or the history
+        if (history) {
+            history->forget(a->getId());
+        }
+    }
+    delete animals[slot];
+
+    // Fill the hole with the last animal so slots stay dense
+    size_t last = animals.size() - 1;
+    if (slot != last) {
+        animals[slot] = animals[last];
+        sickAnimals.moveSlot(last, slot);
+        if (anomalies) {
+            anomalies->moveSlot(last, slot);
+        }
+        if (sketches) {
+            sketches->moveSlot(last, slot);
+        }
+        if (rankings) {
+            rankings->moveSlot(last, slot);
+        }
+        Animal* moved = dynamic_cast<Animal*>(animals[slot]);
+        if (moved) {
+            moved->setSlot(slot);
+            moveIndexedName(moved->getName(), last, slot);
+        }
+    }
+    animals.pop_back();
+    sickAnimals.resize(animals.size());
+    if (anomalies) {
+        anomalies->resize(animals.size());
+    }
+    if (sketches) {
+        sketches->resize(animals.size());
+    }
+    if (rankings) {
+        rankings->resize(animals.size());
+    }
 }
 
 void Zoo::removeAnimal(const std::string& name) {
-    auto it = std::find_if(animals.begin(), animals.end(),
-        [&name](IAnimal* animal) {
-            Animal* a = dynamic_cast<Animal*>(animal);
-            return a && a->getName() == name;
-        });
-    
-    if (it == animals.end()) {
+    if (tryRemoveAnimal(name) == ZooStatus::NotFound) {
         throw AnimalNotFoundException(name);
     }
-    
-    std::cout << "Removing " << (*it)->getSpecies() << " named " << name << std::endl;
-    delete *it;
-    animals.erase(it);
+}
+
+std::vector<ZooStatus> Zoo::tryRemoveAnimals(const std::vector<std::string>& names) {
+    AllocationScope scope(AllocRegion::Zoo);
+    std::vector<ZooStatus> results;
+    results.reserve(names.size());
+    for (const std::string& name : names) {
+        results.push_back(tryRemoveAnimal(name));
+    }
+    return results;
 }
 
 void Zoo::makeAllSounds() const {
+    ensureLoaded();
     std::cout << "\n=== All Animals Making Sounds ===" << std::endl;
     for (const IAnimal* animal : animals) {
         animal->makeSound();
@@ -86,6 +495,10 @@ void Zoo::makeAllSounds() const {
 }
 
 void Zoo::feedAllAnimals() const {
+    ensureLoaded();
+    if (recorder) {
+        recorder->record(TraceOp::ZooFeed);
+    }
     std::cout << "\n=== Feeding Time ===" << std::endl;
     for (const IAnimal* animal : animals) {
         animal->eat();
@@ -93,6 +506,12 @@ void Zoo::feedAllAnimals() const {
 }
 
 void Zoo::performDailyCheckups() {
+    AllocationScope scope(AllocRegion::Zoo);
+    ensureLoaded();
+    if (recorder) {
+        recorder->record(TraceOp::ZooDailyCheckups);
+    }
+    OperationRecorder::Pause pause(recorder);
     std::cout << "\n=== Daily Checkups ===" << std::endl;
     for (IAnimal* animal : animals) {
         Animal* a = dynamic_cast<Animal*>(animal);
@@ -104,6 +523,7 @@ void Zoo::performDailyCheckups() {
 }
 
 void Zoo::displayAllAnimals() const {
+    ensureLoaded();
     std::cout << "\n========================================" << std::endl;
     std::cout << "=== Animals in " << zooName << " ===" << std::endl;
     std::cout << "========================================" << std::endl;
@@ -129,6 +549,7 @@ void Zoo::displayAllAnimals() const {
 }
 
 void Zoo::displayBySpecies(const std::string& species) const {
+    ensureLoaded();
     std::cout << "\n=== " << species << "s in the zoo ===" << std::endl;
     bool found = false;
     
@@ -149,10 +570,15 @@ void Zoo::displayBySpecies(const std::string& species) const {
 }
 
 int Zoo::getAnimalCount() const {
-    return animals.size();
+    return static_cast<int>(animals.size() + getArchivedCount());
 }
 
 int Zoo::countBySpecies(const std::string& species) const {
+    AllocationScope scope(AllocRegion::Zoo);
+    ensureLoaded();
+    if (recorder) {
+        recorder->record(TraceOp::ZooCountSpecies, "", species);
+    }
     int count = 0;
     for (const IAnimal* animal : animals) {
         if (animal->getSpecies() == species) {
@@ -162,53 +588,226 @@ int Zoo::countBySpecies(const std::string& species) const {
     return count;
 }
 
-double Zoo::calculateTotalFoodRequirement() const {
-    double total = 0.0;
-    for (const IAnimal* animal : animals) {
-        const Animal* a = dynamic_cast<const Animal*>(animal);
-        if (a) {
-            total += a->calculateFoodRequirement();
+double Zoo::calculateTotalFoodRequirement(unsigned threads) const {
+    AllocationScope scope(AllocRegion::Zoo);
+    ensureLoaded();
+    if (recorder) {
+        recorder->record(TraceOp::ZooTotalFood);
+    }
+    CompensatedSum total = parallelReduce(animals.size(), threads, CompensatedSum(),
+        [this](CompensatedSum& sum, size_t i) {
+            const Animal* a = dynamic_cast<const Animal*>(animals[i]);
+            if (a) {
+                sum.add(a->calculateFoodRequirement());
+            }
+        },
+        [](CompensatedSum& sum, const CompensatedSum& other) { sum += other; });
+    return total.value();
+}
+
+std::vector<Animal*> Zoo::topAnimals(RankBy by, size_t k) const {
+    AllocationScope scope(AllocRegion::Zoo);
+    ensureLoaded();
+    if (!rankings) {
+        // Ranking is not a visible change of state, like ensureLoaded
+        std::unique_ptr<AnimalRankings> built(new AnimalRankings());
+        for (size_t slot = 0; slot < animals.size(); ++slot) {
+            if (Animal* a = dynamic_cast<Animal*>(animals[slot])) {
+                built->onAdded(a, slot);
+            }
+        }
+        rankings = std::move(built);
+    }
+    return rankings->top(by, k);
+}
+
+std::vector<std::string> Zoo::completeName(const std::string& prefix, size_t limit) const {
+    AllocationScope scope(AllocRegion::Zoo);
+    ensureLoaded();
+    if (namePrefixesDropped) {
+        throw InvalidOperationException("Too many names to index");
+    }
+    if (!namePrefixes) {
+        std::vector<std::string_view> names;
+        names.reserve(animals.size());
+        for (IAnimal* animal : animals) {
+            if (const Animal* a = dynamic_cast<const Animal*>(animal)) {
+                names.push_back(a->getName());
+            }
         }
+        std::unique_ptr<NamePrefixIndex> built(new NamePrefixIndex());
+        built->addAll(names);
+        namePrefixes = std::move(built);
+    }
+    return namePrefixes->complete(prefix, limit);
+}
+
+int Zoo::getSickCount() const {
+    ensureLoaded();
+    return static_cast<int>(sickAnimals.count());
+}
+
+std::vector<Animal*> Zoo::getSickAnimals() const {
+    AllocationScope scope(AllocRegion::Zoo);
+    ensureLoaded();
+    std::vector<Animal*> sick;
+    sickAnimals.forEachSet([this, &sick](size_t slot) {
+        sick.push_back(static_cast<Animal*>(animals[slot]));
+    });
+    return sick;
+}
+
+void Zoo::performSickCheckups() {
+    AllocationScope scope(AllocRegion::Zoo);
+    ensureLoaded();
+    if (recorder) {
+        recorder->record(TraceOp::ZooSickCheckups);
+    }
+    OperationRecorder::Pause pause(recorder);
+    std::cout << "\n=== Checkups for Animals Needing Attention ===" << std::endl;
+    if (sickAnimals.count() == 0) {
+        std::cout << "All animals are healthy." << std::endl;
+        return;
+    }
+    sickAnimals.forEachSet([this](size_t slot) {
+        static_cast<Animal*>(animals[slot])->performCheckup();
+        std::cout << std::endl;
+    });
+}
+
+int Zoo::dispatchVeterinarian(Veterinarian& vet) {
+    AllocationScope scope(AllocRegion::Zoo);
+    ensureLoaded();
+    if (recorder) {
+        recorder->record(TraceOp::ZooDispatchVet, vet.getName(), "");
+    }
+    OperationRecorder::Pause pause(recorder);
+    int treated = 0;
+    sickAnimals.forEachSet([this, &vet, &treated](size_t slot) {
+        vet.treatAnimal(static_cast<Animal*>(animals[slot]));
+        ++treated;
+    });
+    return treated;
+}
+
+IAnimal* Zoo::tryFindAnimal(const std::string& name) const {
+    AllocationScope scope(AllocRegion::Zoo);
+    if (recorder) {
+        recorder->record(TraceOp::ZooFind, "", name);
+    }
+    size_t slot = findSlot(name);
+    if (slot != NO_SLOT) {
+        return animals[slot];
+    }
+    if (!archived) {
+        return nullptr;
+    }
+    // First lookup of an archived animal moves it into the zoo, where the
+    // health bitmap, history and the other hooks see its changes; like
+    // ensureLoaded this is not a visible change of state
+    Animal* animal = archived->take(name);
+    if (animal) {
+        const_cast<Zoo*>(this)->adopt(animal);
     }
-    return total;
+    return animal;
 }
 
 IAnimal* Zoo::findAnimal(const std::string& name) const {
-    for (const IAnimal* animal : animals) {
-        const Animal* a = dynamic_cast<const Animal*>(animal);
-        if (a && a->getName() == name) {
-            return const_cast<IAnimal*>(animal);
+    AllocationScope scope(AllocRegion::Zoo);
+    IAnimal* animal = tryFindAnimal(name);
+    if (!animal) {
+        throw AnimalNotFoundException(name);
+    }
+    return animal;
+}
+
+std::vector<IAnimal*> Zoo::findAllNamed(const std::string& name) const {
+    AllocationScope scope(AllocRegion::Zoo);
+    ensureLoaded();
+    std::vector<size_t> slots;
+    auto range = nameIndex.equal_range(nameKey(name));
+    for (auto it = range.first; it != range.second; ++it) {
+        if (static_cast<const Animal*>(animals[it->second])->getName() == name) {
+            slots.push_back(it->second);
         }
     }
-    throw AnimalNotFoundException(name);
+    std::sort(slots.begin(), slots.end());
+    std::vector<IAnimal*> found;
+    found.reserve(slots.size());
+    for (size_t slot : slots) {
+        found.push_back(animals[slot]);
+    }
+    return found;
+}
+
+std::vector<IAnimal*> Zoo::findAnimals(const std::vector<std::string>& names) const {
+    AllocationScope scope(AllocRegion::Zoo);
+    std::vector<IAnimal*> found;
+    found.reserve(names.size());
+    for (const std::string& name : names) {
+        found.push_back(tryFindAnimal(name));
+    }
+    return found;
 }
 
 void Zoo::saveToFile(const std::string& filename) const {
-    std::ofstream outFile(filename);
-    if (!outFile) {
-        throw InvalidOperationException("Cannot open file for writing: " + filename);
+    AllocationScope scope(AllocRegion::Persistence);
+    ensureLoaded();
+    writeSaved(filename, zooName, capacity, captureAnimals(animals));
+    if (verbose) {
+        std::cout << "Zoo data saved to " << filename << std::endl;
     }
-    
-    outFile << zooName << std::endl;
-    outFile << capacity << std::endl;
-    outFile << animals.size() << std::endl;
-    
-    for (const IAnimal* animal : animals) {
-        const Animal* a = dynamic_cast<const Animal*>(animal);
-        if (a) {
-            outFile << a->getSpecies() << "|"
-                    << a->getName() << "|"
-                    << a->getAge() << "|"
-                    << a->getWeight() << "|"
-                    << a->getHealthStatus() << std::endl;
-        }
+}
+
+std::future<void> Zoo::saveToFileAsync(const std::string& filename) const {
+    AllocationScope scope(AllocRegion::Persistence);
+    ensureLoaded();
+    std::vector<SavedAnimal> saved = captureAnimals(animals);
+    if (verbose) {
+        std::cout << "Saving zoo data to " << filename << " in the background" << std::endl;
+    }
+    return std::async(std::launch::async,
+        [filename, name = zooName, capacity = capacity, saved = std::move(saved)] {
+            writeSaved(filename, name, capacity, saved);
+        });
+}
+
+void Zoo::formatRecord(std::string& out, const Animal& animal) {
+    appendRecord(out, animal.getSpecies(), animal.getName(), animal.getAge(),
+                 animal.getWeight(), animal.getHealthStatus());
+}
+
+void Zoo::saveArchive(const std::string& filename) const {
+    AllocationScope scope(AllocRegion::Persistence);
+    ensureLoaded();
+    ZooArchive::write(*this, filename);
+    if (verbose) {
+        std::cout << "Zoo archive saved to " << filename << std::endl;
     }
-    
-    outFile.close();
-    std::cout << "Zoo data saved to " << filename << std::endl;
 }
 
-void Zoo::loadFromFile(const std::string& filename) {
+size_t Zoo::getArchivedCount() const {
+    return archived ? archived->size() : 0;
+}
+
+void Zoo::loadFromFile(const std::string& filename, LoadMode mode) {
+    AllocationScope scope(AllocRegion::Persistence);
+    if (ZooArchive::isArchive(filename)) {
+        std::unique_ptr<ZooArchive> archive(new ZooArchive(filename));
+        cleanup();
+        zooName = archive->getZooName();
+        capacity = archive->getCapacity();
+        archived.reset(new LazyArchive(std::move(archive)));
+        if (mode == LoadMode::Eager) {
+            ensureLoaded();
+        }
+        if (verbose) {
+            std::cout << "Zoo data loaded from " << filename << " (" << getAnimalCount()
+                      << " animals" << (mode == LoadMode::Lazy ? ", on demand)" : ")") << std::endl;
+        }
+        return;
+    }
+
     std::ifstream inFile(filename);
     if (!inFile) {
         throw InvalidOperationException("Cannot open file for reading: " + filename);
@@ -237,3 +836,70 @@ std::string Zoo::getZooName() const {
 int Zoo::getCapacity() const {
     return capacity;
 }
+
+const std::vector<IAnimal*>& Zoo::getAnimals() const {
+    ensureLoaded();
+    return animals;
+}
+
+void Zoo::setHistory(HistoryStore* store) {
+    history = store;
+}
+
+HistoryStore* Zoo::getHistory() const {
+    return history;
+}
+
+void Zoo::setAnomalyDetector(AnomalyDetector* detector) {
+    anomalies = detector;
+}
+
+AnomalyDetector* Zoo::getAnomalyDetector() const {
+    return anomalies;
+}
+
+void Zoo::setSketches(ZooSketches* zooSketches) {
+    if (zooSketches) {
+        ensureLoaded();
+        zooSketches->clear();
+        for (size_t slot = 0; slot < animals.size(); ++slot) {
+            if (const Animal* a = dynamic_cast<const Animal*>(animals[slot])) {
+                zooSketches->onAdded(*a, slot);
+            }
+        }
+    }
+    sketches = zooSketches;
+}
+
+ZooSketches* Zoo::getSketches() const {
+    return sketches;
+}
+
+void Zoo::setRecorder(OperationRecorder* newRecorder) {
+    // Loading an archive adds its animals, which is not an operation to
+    // trace; they go into the trace as seeds below
+    recorder = nullptr;
+    if (!newRecorder) {
+        return;
+    }
+    ensureLoaded();
+    recorder = newRecorder;
+    recorder->record(TraceOp::ZooOpen, zooName, "", capacity);
+    for (const IAnimal* animal : animals) {
+        if (const Animal* a = dynamic_cast<const Animal*>(animal)) {
+            recorder->recordAnimal(TraceOp::ZooSeed, "", *a);
+        }
+    }
+}
+
+OperationRecorder* Zoo::getRecorder() const {
+    return recorder;
+}
+
+void Zoo::setVerbose(bool enabled) {
+    verbose = enabled;
+}
+
+bool Zoo::isVerbose() const {
+    return verbose;
+}
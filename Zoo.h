@@ -2,23 +2,109 @@
 #define ZOO_H
 
 #include "IAnimal.h"
+#include "IAnimalObserver.h"
+#include "HealthBitmap.h"
+#include "AnimalRankings.h"
+#include "NamePrefixIndex.h"
 #include <vector>
 #include <string>
+#include <memory>
+#include <future>
+#include <unordered_map>
+
+class Animal;
+class Veterinarian;
+class LazyArchive;
+class HistoryStore;
+class AnomalyDetector;
+class OperationRecorder;
+class ZooSketches;
+
+/**
+ * Result of the non-throwing Zoo operations (tryAddAnimal and friends)
+ */
+enum class ZooStatus {
+    Ok,
+    NotFound,
+    Full,
+    InvalidAnimal
+};
+
+const char* zooStatusName(ZooStatus status);
 
 /**
  * Zoo management class demonstrating polymorphism
  * Implements Rule of Three for proper resource management
+ *
+ * Each animal occupies a slot (its index in the animals vector). Removal
+ * moves the last animal into the freed slot, so slots stay dense and
+ * slot-indexed side tables such as the sick-animal bitmap stay compact.
  */
-class Zoo {
+class Zoo : private IAnimalObserver {
 private:
     std::vector<IAnimal*> animals;
     std::string zooName;
     int capacity;
+    bool verbose;
+
+    // Bit set for every slot whose animal needs attention
+    HealthBitmap sickAnimals;
+
+    // Name hash -> slot, so lookups and misses do not scan the animals
+    std::unordered_multimap<size_t, size_t> nameIndex;
+    static const size_t NO_SLOT = static_cast<size_t>(-1);
+
+    // Animals still in a lazily loaded archive (see loadFromFile)
+    std::unique_ptr<LazyArchive> archived;
+
+    // Weight and checkup history, not owned (see setHistory)
+    HistoryStore* history;
+
+    // Streaming anomaly detection, not owned (see setAnomalyDetector)
+    AnomalyDetector* anomalies;
+
+    // Call trace, not owned (see setRecorder)
+    OperationRecorder* recorder;
+
+    // Approximate distributions, not owned (see setSketches)
+    ZooSketches* sketches;
+
+    // Built by the first topAnimals call, then kept current
+    mutable std::unique_ptr<AnimalRankings> rankings;
+
+    // Built by the first completeName call, then kept current. Writers
+    // drop it while the names outgrow it and rebuild it themselves once
+    // they fit again, so a reader never builds over a dropped index.
+    mutable std::unique_ptr<NamePrefixIndex> namePrefixes;
+    bool namePrefixesDropped;
+    size_t nameBytes;    // total length of all names
+    void updateNamePrefixes(const std::string* added, const std::string* removed);
 
     // Helper function for deep copy
     void deepCopy(const Zoo& other);
     void cleanup();
 
+    // Moves every archived animal into the zoo; whole-zoo operations call
+    // this first so they never see a partially loaded zoo
+    void ensureLoaded() const;
+    // Adds an animal taken from the archive without tracing or printing it
+    void adopt(Animal* animal);
+
+    // IAnimalObserver: keeps the health bitmap and history in sync
+    void onHealthChanged(Animal* animal, bool healthy) override;
+    void onWeightChanged(Animal* animal, double weight) override;
+    void onAgeChanged(Animal* animal, int age) override;
+    void onCheckup(Animal* animal, bool healthy) override;
+    void onNameChanged(Animal* animal, const std::string& oldName) override;
+    void recordHistory(const Animal& animal);
+
+    static size_t nameKey(const std::string& name);
+    size_t findSlot(const std::string& name) const;
+    void unindexName(const std::string& name, size_t slot);
+    void moveIndexedName(const std::string& name, size_t from, size_t to);
+    // Takes the animal in slot out of every index and deletes it
+    void removeSlot(size_t slot, const std::string& name);
+
 public:
     Zoo(std::string name, int capacity);
     ~Zoo();
@@ -28,8 +114,21 @@ public:
     Zoo& operator=(const Zoo& other);
 
     // Animal management
+    // addAnimal and removeAnimal throw ZooFullException, InvalidOperation-
+    // Exception or AnimalNotFoundException; the try* forms return the
+    // status instead, for callers where failures are routine. An animal
+    // that was not added still belongs to the caller.
     void addAnimal(IAnimal* animal);
     void removeAnimal(const std::string& name);
+    ZooStatus tryAddAnimal(IAnimal* animal);
+    ZooStatus tryRemoveAnimal(const std::string& name);
+    // Removes that very animal, for callers that picked one of several
+    // animals sharing a name (see findAllNamed)
+    ZooStatus tryRemoveAnimal(const IAnimal* animal);
+
+    // One status per item, in order
+    std::vector<ZooStatus> tryAddAnimals(const std::vector<IAnimal*>& batch);
+    std::vector<ZooStatus> tryRemoveAnimals(const std::vector<std::string>& names);
 
     // Polymorphic operations
     void makeAllSounds() const;
@@ -43,18 +142,97 @@ public:
     // Statistics
     int getAnimalCount() const;
     int countBySpecies(const std::string& species) const;
-    double calculateTotalFoodRequirement() const;
+    // Compensated sum in fixed blocks (ParallelReduce.h): the same bits
+    // for any number of threads
+    double calculateTotalFoodRequirement(unsigned threads = 1) const;
+
+    // The k heaviest, oldest or hungriest animals, largest first. The
+    // first call ranks the whole zoo (O(n log n)); after that adds,
+    // removals and weight or age changes keep the ranking current and a
+    // query costs O(k log k). The first call changes the zoo, so it must
+    // not race with other calls (ConcurrentZoo makes it up front).
+    std::vector<Animal*> topAnimals(RankBy by, size_t k) const;
+
+    // Health tracking (backed by the sick-animal bitmap)
+    int getSickCount() const;
+    std::vector<Animal*> getSickAnimals() const;
+    void performSickCheckups();
+    int dispatchVeterinarian(Veterinarian& vet);
 
-    // Find animal
+    // Find animal: findAnimal throws AnimalNotFoundException on a miss,
+    // tryFindAnimal returns nullptr, findAnimals returns one entry per name
     IAnimal* findAnimal(const std::string& name) const;
+    IAnimal* tryFindAnimal(const std::string& name) const;
+    std::vector<IAnimal*> findAnimals(const std::vector<std::string>& names) const;
+    // Every animal called name, lowest slot first; loads a lazy archive
+    std::vector<IAnimal*> findAllNamed(const std::string& name) const;
+    // Up to limit names starting with prefix, in byte order, one per
+    // animal. The first call indexes every name (O(n log n)); after that
+    // adds, removals and renames update the index and a lookup costs
+    // O(log n) plus the matches returned. Adds never fail on its account:
+    // once the names outgrow the index (2 GiB of text) it is dropped and
+    // calls throw InvalidOperationException, until removals or renames
+    // bring the names back within the limit and rebuild it. Only the
+    // first build happens here; it changes the zoo, so it must not race
+    // with other calls (ConcurrentZoo makes it up front).
+    std::vector<std::string> completeName(const std::string& prefix, size_t limit) const;
 
     // File I/O
+    // saveToFile writes the text format; saveArchive writes every attribute
+    // plus a name index (see ZooArchive.h). loadFromFile reads an archive:
+    // LoadMode::Lazy reads only its header and index; findAnimal() moves
+    // an animal into the zoo the first time it asks for it, and anything
+    // that needs the whole zoo (display, save, statistics) loads the rest.
+    // Either way the zoo owns it, and pointers stay valid until it is
+    // removed or the zoo is cleared or loaded again.
+    enum class LoadMode { Eager, Lazy };
     void saveToFile(const std::string& filename) const;
-    void loadFromFile(const std::string& filename);
+    // Copies the fields saveToFile writes (a few dozen bytes per animal)
+    // and returns; the file is formatted and written on a background
+    // thread, and like saveToFile replaces filename only once complete.
+    // The zoo may change or be destroyed meanwhile. get() on the future
+    // rethrows any write error.
+    std::future<void> saveToFileAsync(const std::string& filename) const;
+    void saveArchive(const std::string& filename) const;
+    void loadFromFile(const std::string& filename, LoadMode mode = LoadMode::Eager);
+    size_t getArchivedCount() const;
+
+    // Appends one saveToFile line without the newline: species|name|age|weight|health
+    static void formatRecord(std::string& out, const Animal& animal);
 
     // Getters
     std::string getZooName() const;
     int getCapacity() const;
+    const std::vector<IAnimal*>& getAnimals() const;
+
+    // Record every added animal, weight change and checkup in store, on
+    // the store's current day; nullptr stops recording. Copies of the zoo
+    // do not record. The store must outlive the zoo or be detached first.
+    void setHistory(HistoryStore* store);
+    HistoryStore* getHistory() const;
+
+    // Feed every weight change, health change and checkup to detector,
+    // which alerts its IHealthObservers on readings out of line with the
+    // animal's own recent ones. Same ownership rules as setHistory.
+    void setAnomalyDetector(AnomalyDetector* detector);
+    AnomalyDetector* getAnomalyDetector() const;
+
+    // Keep sketches (age and weight quantiles, distinct names per species)
+    // up to date on adds, removals and weight changes. Attaching clears
+    // sketches and loads every animal into it; animals in a lazily loaded
+    // archive join when they are loaded. Same ownership rules as setHistory.
+    void setSketches(ZooSketches* zooSketches);
+    ZooSketches* getSketches() const;
+
+    // Log every call made on the zoo and its animals to recorder, for
+    // TraceReplayer; attaching writes the zoo's current animals first.
+    // Same ownership rules as setHistory.
+    void setRecorder(OperationRecorder* recorder);
+    OperationRecorder* getRecorder() const;
+
+    // Console logging of add/remove/save messages (on by default)
+    void setVerbose(bool enabled);
+    bool isVerbose() const;
 };
 
 #endif // ZOO_H
@@ -0,0 +1,259 @@
+#include "ZooArchive.h"
+#include "BinaryCodec.h"
+#include "Exceptions.h"
+#include "AtomicFileWriter.h"
+#include "Zoo.h"
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+using namespace BinaryCodec;
+
+namespace {
+
+const char MAGIC[4] = { 'Z', 'A', 'R', 'C' };
+const uint32_t FORMAT_VERSION = 1;
+
+// Magic, version, capacity, count, index offset, fence stride, name length
+const size_t FIXED_HEADER_SIZE = 4 + 4 + 4 + 8 + 8 + 4 + 4;
+
+const size_t WRITE_BLOCK_SIZE = 1 << 20;
+
+uint64_t nameHash(const std::string& name) {
+    return hash64(name.data(), name.size());
+}
+
+void writeBytes(AtomicFileWriter& writer, const std::string& bytes) {
+    writer.buffer() += bytes;
+    writer.flushIfFull();
+}
+
+std::string encodeHeader(const std::string& zooName, int capacity, uint64_t count,
+                         uint64_t indexOffset) {
+    std::string header(MAGIC, sizeof(MAGIC));
+    putU32(header, FORMAT_VERSION);
+    putU32(header, static_cast<uint32_t>(capacity));
+    putU64(header, count);
+    putU64(header, indexOffset);
+    putU32(header, ZooArchive::FENCE_STRIDE);
+    putU32(header, static_cast<uint32_t>(zooName.size()));
+    header += zooName;
+    return header;
+}
+
+} // namespace
+
+// ---- ZooArchive ----
+
+void ZooArchive::write(const Zoo& zoo, const std::string& path) {
+    // A temp file renamed into place, so a failed write leaves the old
+    // archive whole, and a LazyArchive reading it keeps its own copy
+    AtomicFileWriter writer(path);
+
+    // The header is rewritten at the end once count and index offset are known
+    std::string header = encodeHeader(zoo.getZooName(), zoo.getCapacity(), 0, 0);
+    writeBytes(writer, header);
+    uint64_t position = header.size();
+
+    const std::vector<IAnimal*>& animals = zoo.getAnimals();
+    std::vector<std::pair<uint64_t, uint64_t>> index;
+    index.reserve(animals.size());
+
+    std::string block;
+    std::string record;
+    for (const IAnimal* animal : animals) {
+        const Animal* a = dynamic_cast<const Animal*>(animal);
+        if (!a) continue;
+        record.clear();
+        AnimalRecord::capture(*a).encode(record);
+        index.emplace_back(nameHash(a->getName()), position + block.size());
+        putU32(block, static_cast<uint32_t>(record.size()));
+        block += record;
+        if (block.size() >= WRITE_BLOCK_SIZE) {
+            writeBytes(writer, block);
+            position += block.size();
+            block.clear();
+        }
+    }
+    writeBytes(writer, block);
+    position += block.size();
+
+    std::sort(index.begin(), index.end());
+    uint64_t indexOffset = position;
+    block.clear();
+    std::string fences;
+    for (size_t i = 0; i < index.size(); ++i) {
+        putU64(block, index[i].first);
+        putU64(block, index[i].second);
+        if (i % FENCE_STRIDE == 0) {
+            putU64(fences, index[i].first);
+        }
+    }
+    writeBytes(writer, block);
+    writeBytes(writer, fences);
+
+    writer.rewriteStart(encodeHeader(zoo.getZooName(), zoo.getCapacity(), index.size(), indexOffset));
+    writer.commit();
+}
+
+bool ZooArchive::isArchive(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    char magic[sizeof(MAGIC)];
+    return file.read(magic, sizeof(magic)) && std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+ZooArchive::ZooArchive(const std::string& path)
+    : file(path, std::ios::binary), path(path), capacity(0), count(0),
+      recordsBegin(0), indexOffset(0), fenceStride(FENCE_STRIDE) {
+    if (!file) {
+        throw InvalidOperationException("Cannot open file for reading: " + path);
+    }
+    std::string fixed = readBytes(0, FIXED_HEADER_SIZE);
+    if (std::memcmp(fixed.data(), MAGIC, sizeof(MAGIC)) != 0) {
+        throw InvalidOperationException("Not a zoo archive: " + path);
+    }
+    Reader header(fixed.data() + sizeof(MAGIC), fixed.size() - sizeof(MAGIC));
+    if (header.u32() != FORMAT_VERSION) {
+        throw InvalidOperationException("Unsupported archive version: " + path);
+    }
+    capacity = static_cast<int>(header.u32());
+    count = header.u64();
+    indexOffset = header.u64();
+    fenceStride = header.u32();
+    uint32_t nameLength = header.u32();
+    if (fenceStride == 0) {
+        throw InvalidOperationException("Corrupt archive: " + path);
+    }
+    zooName = readBytes(FIXED_HEADER_SIZE, nameLength);
+    recordsBegin = FIXED_HEADER_SIZE + nameLength;
+
+    size_t fenceCount = static_cast<size_t>((count + fenceStride - 1) / fenceStride);
+    std::string fenceBytes = readBytes(indexOffset + count * 16, fenceCount * 8);
+    Reader fenceReader(fenceBytes);
+    fences.resize(fenceCount);
+    for (uint64_t& fence : fences) {
+        fence = fenceReader.u64();
+    }
+}
+
+const std::string& ZooArchive::getZooName() const {
+    return zooName;
+}
+
+int ZooArchive::getCapacity() const {
+    return capacity;
+}
+
+uint64_t ZooArchive::size() const {
+    return count;
+}
+
+std::string ZooArchive::readBytes(uint64_t offset, size_t size) {
+    std::string bytes(size, '\0');
+    file.clear();
+    file.seekg(static_cast<std::streamoff>(offset));
+    if (size > 0 && !file.read(&bytes[0], static_cast<std::streamsize>(size))) {
+        throw InvalidOperationException("Corrupt or truncated archive: " + path);
+    }
+    return bytes;
+}
+
+std::vector<uint64_t> ZooArchive::lookup(const std::string& name) {
+    std::vector<uint64_t> offsets;
+    uint64_t hash = nameHash(name);
+
+    // Equal hashes may start in the block before the first fence >= hash
+    size_t block = static_cast<size_t>(std::lower_bound(fences.begin(), fences.end(), hash) - fences.begin());
+    block = block > 0 ? block - 1 : 0;
+
+    for (uint64_t entry = static_cast<uint64_t>(block) * fenceStride; entry < count;) {
+        size_t entries = static_cast<size_t>(std::min<uint64_t>(fenceStride, count - entry));
+        std::string bytes = readBytes(indexOffset + entry * 16, entries * 16);
+        Reader in(bytes);
+        for (size_t i = 0; i < entries; ++i) {
+            uint64_t entryHash = in.u64();
+            uint64_t offset = in.u64();
+            if (entryHash > hash) {
+                return offsets;
+            }
+            if (entryHash == hash && read(offset).name == name) {
+                offsets.push_back(offset);
+            }
+        }
+        entry += entries;
+    }
+    return offsets;
+}
+
+AnimalRecord ZooArchive::read(uint64_t offset) {
+    std::string lengthBytes = readBytes(offset, 4);
+    uint32_t length = Reader(lengthBytes).u32();
+    std::string record = readBytes(offset + 4, length);
+    return AnimalRecord::decode(record.data(), record.size());
+}
+
+void ZooArchive::forEach(const std::function<void(uint64_t offset, const AnimalRecord& record)>& visit) {
+    file.clear();
+    file.seekg(static_cast<std::streamoff>(recordsBegin));
+    std::string record;
+    for (uint64_t offset = recordsBegin; offset < indexOffset;) {
+        char lengthBytes[4];
+        if (!file.read(lengthBytes, sizeof(lengthBytes))) {
+            throw InvalidOperationException("Corrupt or truncated archive: " + path);
+        }
+        uint32_t length = Reader(lengthBytes, sizeof(lengthBytes)).u32();
+        record.resize(length);
+        if (length > 0 && !file.read(&record[0], length)) {
+            throw InvalidOperationException("Corrupt or truncated archive: " + path);
+        }
+        visit(offset, AnimalRecord::decode(record.data(), record.size()));
+        offset += 4 + length;
+    }
+}
+
+// ---- LazyArchive ----
+
+LazyArchive::LazyArchive(std::unique_ptr<ZooArchive> archive)
+    : archive(std::move(archive)) {
+}
+
+bool LazyArchive::locate(const std::string& name, uint64_t& offset) {
+    for (uint64_t candidate : archive->lookup(name)) {
+        if (!removed.count(candidate)) {
+            offset = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+Animal* LazyArchive::take(const std::string& name) {
+    uint64_t offset;
+    if (!locate(name, offset)) {
+        return nullptr;
+    }
+    Animal* animal = archive->read(offset).materialize();
+    removed.insert(offset);
+    return animal;
+}
+
+bool LazyArchive::remove(const std::string& name) {
+    uint64_t offset;
+    if (!locate(name, offset)) {
+        return false;
+    }
+    removed.insert(offset);
+    return true;
+}
+
+size_t LazyArchive::size() const {
+    return static_cast<size_t>(archive->size()) - removed.size();
+}
+
+void LazyArchive::drain(const std::function<void(Animal*)>& sink) {
+    archive->forEach([&](uint64_t offset, const AnimalRecord& record) {
+        if (removed.count(offset)) return;
+        removed.insert(offset);
+        sink(record.materialize());
+    });
+}
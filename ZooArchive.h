@@ -0,0 +1,104 @@
+#ifndef ZOOARCHIVE_H
+#define ZOOARCHIVE_H
+
+#include "AnimalRecord.h"
+#include <string>
+#include <vector>
+#include <fstream>
+#include <memory>
+#include <functional>
+#include <unordered_set>
+#include <cstdint>
+
+class Zoo;
+
+/**
+ * Binary zoo archive with an on-disk name index
+ *
+ * Layout (little-endian):
+ *   header:  "ZARC" version(u32) capacity(u32) count(u64) indexOffset(u64)
+ *            fenceStride(u32) name length(u32) zoo name
+ *   records: u32 length + AnimalRecord::encode() bytes, one per animal
+ *   index:   count x (name hash u64, record offset u64), sorted
+ *   fences:  name hash of every fenceStride-th index entry
+ *
+ * Opening reads only the header and the fences, so it costs the same for
+ * ten animals as for ten million. A lookup binary-searches the fences and
+ * then reads one index block of fenceStride entries.
+ */
+class ZooArchive {
+public:
+    static const uint32_t FENCE_STRIDE = 1024;
+
+    // Writes every animal with all of its attributes
+    static void write(const Zoo& zoo, const std::string& path);
+
+    // True if the file starts with the archive magic
+    static bool isArchive(const std::string& path);
+
+    // Reads header and fences; throws InvalidOperationException on errors
+    explicit ZooArchive(const std::string& path);
+
+    const std::string& getZooName() const;
+    int getCapacity() const;
+    uint64_t size() const;
+
+    // Offsets of every record with this name (usually one)
+    std::vector<uint64_t> lookup(const std::string& name);
+
+    AnimalRecord read(uint64_t offset);
+
+    // Visits every record in file order
+    void forEach(const std::function<void(uint64_t offset, const AnimalRecord& record)>& visit);
+
+private:
+    std::ifstream file;
+    std::string path;
+    std::string zooName;
+    int capacity;
+    uint64_t count;
+    uint64_t recordsBegin;
+    uint64_t indexOffset;
+    uint32_t fenceStride;
+    std::vector<uint64_t> fences;
+
+    std::string readBytes(uint64_t offset, size_t size);
+};
+
+/**
+ * Archive opened with Zoo::loadFromFile(..., LoadMode::Lazy)
+ *
+ * Holds the animals the zoo has not asked for yet. take() decodes one
+ * and hands it over, so every animal anyone has seen lives in the zoo
+ * and is observed like the rest. Taken and removed animals are
+ * remembered as tombstones.
+ */
+class LazyArchive {
+public:
+    explicit LazyArchive(std::unique_ptr<ZooArchive> archive);
+
+    LazyArchive(const LazyArchive&) = delete;
+    LazyArchive& operator=(const LazyArchive&) = delete;
+
+    // Decoded animal, now owned by the caller, or nullptr if it is not
+    // in the archive
+    Animal* take(const std::string& name);
+
+    // Marks the animal as removed; false if it is not in the archive
+    bool remove(const std::string& name);
+
+    // Animals not yet taken or removed
+    size_t size() const;
+
+    // Hands every remaining animal to sink (ownership included) and
+    // leaves the archive empty
+    void drain(const std::function<void(Animal*)>& sink);
+
+private:
+    std::unique_ptr<ZooArchive> archive;
+    std::unordered_set<uint64_t> removed;
+
+    bool locate(const std::string& name, uint64_t& offset);
+};
+
+#endif // ZOOARCHIVE_H
@@ -0,0 +1,444 @@
+#include "ZooDiff.h"
+#include "Animal.h"
+#include "AnimalFactory.h"
+#include "Exceptions.h"
+#include "Zoo.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <string_view>
+#include <thread>
+#include <unordered_set>
+
+namespace {
+
+typedef ZooSnapshot::Entry Entry;
+
+void runParallel(size_t tasks, unsigned threads, const std::function<void(size_t)>& task) {
+    std::atomic<size_t> next(0);
+    std::vector<std::thread> workers;
+    unsigned count = std::max(1u, std::min<unsigned>(threads, static_cast<unsigned>(tasks)));
+    for (unsigned t = 0; t < count; ++t) {
+        workers.emplace_back([&]() {
+            for (size_t i = next++; i < tasks; i = next++) {
+                task(i);
+            }
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+std::string_view nameOf(const Entry& entry) {
+    return std::string_view(entry.line + entry.nameBegin, entry.nameLength);
+}
+
+std::string_view lineOf(const Entry& entry) {
+    return std::string_view(entry.line, entry.length);
+}
+
+size_t bucketOf(const Entry& entry) {
+    return static_cast<size_t>(entry.nameHash >> (64 - ZooSnapshot::BUCKET_BITS));
+}
+
+// Orders by name hash, then name; ties (duplicate names) by content
+int compareNames(const Entry& a, const Entry& b) {
+    if (a.nameHash != b.nameHash) return a.nameHash < b.nameHash ? -1 : 1;
+    return nameOf(a).compare(nameOf(b));
+}
+
+bool entryLess(const Entry& a, const Entry& b) {
+    int order = compareNames(a, b);
+    return order != 0 ? order < 0 : a.contentHash < b.contentHash;
+}
+
+/**
+ * Fills in the hashes and name position of a species|name|... line
+ * Returns false for lines that are not records
+ */
+bool describeLine(const char* line, size_t length, Entry& entry) {
+    std::string_view text(line, length);
+    size_t first = text.find('|');
+    size_t second = first == std::string_view::npos ? first : text.find('|', first + 1);
+    if (second == std::string_view::npos) {
+        return false;
+    }
+    std::hash<std::string_view> hasher;
+    entry.line = line;
+    entry.length = static_cast<uint32_t>(length);
+    entry.nameBegin = static_cast<uint32_t>(first + 1);
+    entry.nameLength = static_cast<uint32_t>(second - first - 1);
+    entry.nameHash = hasher(nameOf(entry));
+    entry.contentHash = hasher(text);
+    return true;
+}
+
+struct Record {
+    SpeciesId species;
+    std::string subSpecies;    // monkey and penguin type
+    bool goldenEagle;
+    std::string name;
+    int age;
+    double weight;
+    bool healthy;
+};
+
+// Reads the getSpecies() label a record starts with
+bool parseSpecies(const std::string& label, Record& record) {
+    record.goldenEagle = false;
+    // "Monkey (Capuchin)" and "Penguin (Emperor)" carry their sub-species
+    size_t open = label.find(" (");
+    std::string base = label;
+    if (open != std::string::npos && label.size() > open + 3 && label.back() == ')') {
+        record.subSpecies = label.substr(open + 2, label.size() - open - 3);
+        base.erase(open);
+    }
+    for (int s = 0; s < SPECIES_COUNT; ++s) {
+        if (base == speciesName(static_cast<SpeciesId>(s))) {
+            record.species = static_cast<SpeciesId>(s);
+            return record.subSpecies.empty()
+                || record.species == SpeciesId::Monkey || record.species == SpeciesId::Penguin;
+        }
+    }
+    if (base == "Golden Eagle" && record.subSpecies.empty()) {
+        record.species = SpeciesId::Eagle;
+        record.goldenEagle = true;
+        return true;
+    }
+    return false;
+}
+
+Record parseRecord(const std::string& line) {
+    Record record;
+    std::istringstream in(line);
+    std::string species, age, weight, healthy;
+    if (!std::getline(in, species, '|') || !std::getline(in, record.name, '|')
+        || !std::getline(in, age, '|') || !std::getline(in, weight, '|')
+        || !std::getline(in, healthy)) {
+        throw InvalidOperationException("Malformed record: " + line);
+    }
+    if (!parseSpecies(species, record)) {
+        throw InvalidOperationException("Unknown species in record: " + line);
+    }
+
+    // Whole fields only, and only values the animal would keep
+    char* end = nullptr;
+    errno = 0;
+    long years = std::strtol(age.c_str(), &end, 10);
+    if (age.empty() || *end != '\0' || errno != 0 || years < 0 || years > UINT16_MAX) {
+        throw InvalidOperationException("Bad age in record: " + line);
+    }
+    errno = 0;
+    double kilograms = std::strtod(weight.c_str(), &end);
+    if (weight.empty() || *end != '\0' || errno != 0 || !(kilograms > 0) || !std::isfinite(kilograms)) {
+        throw InvalidOperationException("Bad weight in record: " + line);
+    }
+    if (healthy != "0" && healthy != "1") {
+        throw InvalidOperationException("Bad health flag in record: " + line);
+    }
+    record.age = static_cast<int>(years);
+    record.weight = kilograms;
+    record.healthy = healthy == "1";
+    return record;
+}
+
+// Factory defaults for the fields the save format does not carry
+IAnimal* createAnimal(const Record& record) {
+    IAnimal* animal;
+    switch (record.species) {
+        case SpeciesId::Monkey:
+            animal = new Monkey(record.name, record.age, record.weight, true, "Brown", 160, 50, true,
+                                record.subSpecies.empty() ? "Capuchin" : record.subSpecies);
+            break;
+        case SpeciesId::Penguin:
+            animal = new Penguin(record.name, record.age, record.weight, 0.4, false, "Small", 8, 150,
+                                 record.subSpecies.empty() ? "Emperor" : record.subSpecies);
+            break;
+        case SpeciesId::Eagle:
+            animal = new Eagle(record.name, record.age, record.weight, 2.0, true, "Hooked", 7.0, 3000,
+                               record.goldenEagle);
+            break;
+        default:
+            animal = AnimalFactory::createAnimal(speciesName(record.species), record.name,
+                                                 record.age, record.weight);
+            break;
+    }
+    static_cast<Animal*>(animal)->setHealthStatus(record.healthy);
+    return animal;
+}
+
+} // namespace
+
+// ---- ZooSnapshot ----
+
+ZooSnapshot ZooSnapshot::fromZoo(const Zoo& zoo, unsigned threads) {
+    threads = std::max(1u, threads);
+    const std::vector<IAnimal*>& animals = zoo.getAnimals();
+    size_t perPart = (animals.size() + threads - 1) / threads;
+
+    ZooSnapshot snapshot;
+    std::vector<std::vector<Entry>> parts(threads);
+    snapshot.text.resize(threads);
+    runParallel(threads, threads, [&](size_t t) {
+        size_t begin = std::min(animals.size(), t * perPart);
+        size_t end = std::min(animals.size(), begin + perPart);
+        std::string* out = new std::string();
+        snapshot.text[t].reset(out);
+        std::vector<size_t> offsets;
+        offsets.reserve(end - begin + 1);
+        for (size_t i = begin; i < end; ++i) {
+            const Animal* animal = dynamic_cast<const Animal*>(animals[i]);
+            if (!animal) continue;
+            offsets.push_back(out->size());
+            Zoo::formatRecord(*out, *animal);
+        }
+        offsets.push_back(out->size());
+
+        const char* base = out->data();
+        std::vector<Entry>& part = parts[t];
+        part.reserve(offsets.size() - 1);
+        for (size_t i = 0; i + 1 < offsets.size(); ++i) {
+            Entry entry;
+            if (describeLine(base + offsets[i], offsets[i + 1] - offsets[i], entry)) {
+                part.push_back(entry);
+            }
+        }
+    });
+    snapshot.build(parts, threads);
+    return snapshot;
+}
+
+ZooSnapshot ZooSnapshot::fromFile(const std::string& path, unsigned threads) {
+    threads = std::max(1u, threads);
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        throw InvalidOperationException("Cannot open file for reading: " + path);
+    }
+
+    ZooSnapshot snapshot;
+    std::string* content = new std::string(static_cast<size_t>(file.tellg()), '\0');
+    snapshot.text.emplace_back(content);
+    file.seekg(0);
+    file.read(&(*content)[0], static_cast<std::streamsize>(content->size()));
+
+    // Skip the name, capacity and count header lines
+    size_t start = 0;
+    for (int line = 0; line < 3 && start < content->size(); ++line) {
+        size_t end = content->find('\n', start);
+        start = end == std::string::npos ? content->size() : end + 1;
+    }
+
+    // Split the records into one range per thread at line boundaries
+    std::vector<size_t> bounds(1, start);
+    size_t step = (content->size() - start) / threads + 1;
+    for (unsigned t = 1; t < threads; ++t) {
+        size_t cut = std::max(bounds.back(), std::min(content->size(), start + t * step));
+        size_t end = content->find('\n', cut);
+        bounds.push_back(end == std::string::npos ? content->size() : end + 1);
+    }
+    bounds.push_back(content->size());
+
+    std::vector<std::vector<Entry>> parts(threads);
+    runParallel(threads, threads, [&](size_t t) {
+        const char* base = content->data();
+        size_t position = bounds[t];
+        while (position < bounds[t + 1]) {
+            size_t end = content->find('\n', position);
+            if (end == std::string::npos || end > bounds[t + 1]) end = bounds[t + 1];
+            size_t length = end - position;
+            if (length > 0 && base[position + length - 1] == '\r') --length;
+            Entry entry;
+            if (describeLine(base + position, length, entry)) {
+                parts[t].push_back(entry);
+            }
+            position = end + 1;
+        }
+    });
+    snapshot.build(parts, threads);
+    return snapshot;
+}
+
+void ZooSnapshot::build(std::vector<std::vector<Entry>>& parts, unsigned threads) {
+    // Radix-partition every part by bucket, then sort the buckets
+    std::vector<std::vector<size_t>> counts(parts.size(), std::vector<size_t>(BUCKETS, 0));
+    for (size_t t = 0; t < parts.size(); ++t) {
+        for (const Entry& entry : parts[t]) {
+            ++counts[t][bucketOf(entry)];
+        }
+    }
+
+    bucketStart.assign(BUCKETS + 1, 0);
+    std::vector<std::vector<size_t>> cursor(parts.size(), std::vector<size_t>(BUCKETS, 0));
+    size_t total = 0;
+    for (size_t b = 0; b < BUCKETS; ++b) {
+        bucketStart[b] = total;
+        for (size_t t = 0; t < parts.size(); ++t) {
+            cursor[t][b] = total;
+            total += counts[t][b];
+        }
+    }
+    bucketStart[BUCKETS] = total;
+
+    entries.resize(total);
+    runParallel(parts.size(), threads, [&](size_t t) {
+        for (const Entry& entry : parts[t]) {
+            entries[cursor[t][bucketOf(entry)]++] = entry;
+        }
+        std::vector<Entry>().swap(parts[t]);
+    });
+    runParallel(BUCKETS, threads, [&](size_t b) {
+        std::sort(entries.begin() + bucketStart[b], entries.begin() + bucketStart[b + 1], entryLess);
+    });
+}
+
+size_t ZooSnapshot::size() const {
+    return entries.size();
+}
+
+const ZooSnapshot::Entry* ZooSnapshot::bucketBegin(size_t bucket) const {
+    return entries.data() + bucketStart[bucket];
+}
+
+const ZooSnapshot::Entry* ZooSnapshot::bucketEnd(size_t bucket) const {
+    return entries.data() + bucketStart[bucket + 1];
+}
+
+// ---- ZooDiff ----
+
+ZooDelta ZooDiff::compare(const ZooSnapshot& before, const ZooSnapshot& after, unsigned threads) {
+    std::vector<ZooDelta> partial(ZooSnapshot::BUCKETS);
+    runParallel(ZooSnapshot::BUCKETS, std::max(1u, threads), [&](size_t b) {
+        ZooDelta& delta = partial[b];
+        const Entry* old = before.bucketBegin(b);
+        const Entry* oldEnd = before.bucketEnd(b);
+        const Entry* now = after.bucketBegin(b);
+        const Entry* nowEnd = after.bucketEnd(b);
+        while (old != oldEnd && now != nowEnd) {
+            int order = compareNames(*old, *now);
+            if (order < 0) {
+                delta.removed.emplace_back(lineOf(*old++));
+            } else if (order > 0) {
+                delta.added.emplace_back(lineOf(*now++));
+            } else {
+                if (old->contentHash == now->contentHash) {
+                    ++delta.unchanged;
+                } else {
+                    delta.changed.emplace_back(std::string(lineOf(*old)), std::string(lineOf(*now)));
+                }
+                ++old;
+                ++now;
+            }
+        }
+        for (; old != oldEnd; ++old) delta.removed.emplace_back(lineOf(*old));
+        for (; now != nowEnd; ++now) delta.added.emplace_back(lineOf(*now));
+    });
+
+    ZooDelta result;
+    for (ZooDelta& part : partial) {
+        std::move(part.added.begin(), part.added.end(), std::back_inserter(result.added));
+        std::move(part.removed.begin(), part.removed.end(), std::back_inserter(result.removed));
+        std::move(part.changed.begin(), part.changed.end(), std::back_inserter(result.changed));
+        result.unchanged += part.unchanged;
+    }
+    return result;
+}
+
+// ---- ZooDelta ----
+
+bool ZooDelta::empty() const {
+    return added.empty() && removed.empty() && changed.empty();
+}
+
+void ZooDelta::print(std::ostream& out, size_t limit) const {
+    out << "added " << added.size() << ", removed " << removed.size()
+        << ", changed " << changed.size() << ", unchanged " << unchanged << '\n';
+    for (size_t i = 0; i < added.size() && i < limit; ++i) {
+        out << "+ " << added[i] << '\n';
+    }
+    for (size_t i = 0; i < removed.size() && i < limit; ++i) {
+        out << "- " << removed[i] << '\n';
+    }
+    for (size_t i = 0; i < changed.size() && i < limit; ++i) {
+        out << "~ " << changed[i].first << " -> " << changed[i].second << '\n';
+    }
+}
+
+namespace {
+
+// Finds an animal not yet claimed whose save-file line is exactly line;
+// several animals may share its name
+Animal* claimAnimal(const Zoo& zoo, const std::string& line, const std::string& name,
+                    std::unordered_set<const Animal*>& claimed) {
+    std::string formatted;
+    for (IAnimal* animal : zoo.findAllNamed(name)) {
+        Animal* candidate = dynamic_cast<Animal*>(animal);
+        if (!candidate || claimed.count(candidate)) {
+            continue;
+        }
+        formatted.clear();
+        Zoo::formatRecord(formatted, *candidate);
+        if (formatted == line) {
+            claimed.insert(candidate);
+            return candidate;
+        }
+    }
+    throw AnimalNotFoundException(name);
+}
+
+} // namespace
+
+void ZooDelta::apply(Zoo& zoo) const {
+    // Everything that can fail happens before the zoo is touched: each
+    // old line is matched to its own animal and new animals are built
+    std::unordered_set<const Animal*> claimed;
+    std::vector<Animal*> leaving;
+    for (const std::string& line : removed) {
+        leaving.push_back(claimAnimal(zoo, line, parseRecord(line).name, claimed));
+    }
+
+    struct Update {
+        Animal* animal;
+        Record after;
+    };
+    std::vector<Update> updates;
+    std::vector<std::unique_ptr<IAnimal>> arriving;
+    for (const auto& change : changed) {
+        Record before = parseRecord(change.first);
+        Record after = parseRecord(change.second);
+        Animal* animal = claimAnimal(zoo, change.first, before.name, claimed);
+        if (before.species != after.species || before.subSpecies != after.subSpecies
+            || before.goldenEagle != after.goldenEagle) {
+            leaving.push_back(animal);
+            arriving.emplace_back(createAnimal(after));
+        } else {
+            updates.push_back(Update{ animal, after });
+        }
+    }
+    for (const std::string& line : added) {
+        arriving.emplace_back(createAnimal(parseRecord(line)));
+    }
+    if (static_cast<size_t>(zoo.getAnimalCount()) - leaving.size() + arriving.size()
+        > static_cast<size_t>(zoo.getCapacity())) {
+        throw ZooFullException(zoo.getCapacity());
+    }
+
+    for (Animal* animal : leaving) {
+        zoo.tryRemoveAnimal(animal);
+    }
+    for (const Update& update : updates) {
+        update.animal->setAge(update.after.age);
+        update.animal->setWeight(update.after.weight);
+        update.animal->setHealthStatus(update.after.healthy);
+    }
+    for (std::unique_ptr<IAnimal>& animal : arriving) {
+        if (zoo.tryAddAnimal(animal.get()) == ZooStatus::Ok) {
+            animal.release();
+        }
+    }
+}
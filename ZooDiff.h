@@ -0,0 +1,87 @@
+#ifndef ZOODIFF_H
+#define ZOODIFF_H
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include <utility>
+#include <cstdint>
+#include <memory>
+
+class Zoo;
+
+/**
+ * Hashed, sorted view of one zoo state for diffing
+ * Built from a live Zoo or from a Zoo::saveToFile file. Each record is
+ * the save-file line (species|name|age|weight|health); entries keep a
+ * name hash and a content hash and point into the snapshot's own text.
+ * Entries are radix-partitioned into buckets by the top bits of the name
+ * hash and sorted within each bucket, so two snapshots can be compared
+ * bucket by bucket on separate threads.
+ */
+class ZooSnapshot {
+public:
+    struct Entry {
+        uint64_t nameHash;
+        uint64_t contentHash;
+        const char* line;
+        uint32_t length;
+        uint32_t nameBegin;
+        uint32_t nameLength;
+    };
+
+    static const unsigned BUCKET_BITS = 8;
+    static const size_t BUCKETS = size_t(1) << BUCKET_BITS;
+
+    static ZooSnapshot fromZoo(const Zoo& zoo, unsigned threads);
+
+    // Throws InvalidOperationException if the file cannot be read
+    static ZooSnapshot fromFile(const std::string& path, unsigned threads);
+
+    size_t size() const;
+    const Entry* bucketBegin(size_t bucket) const;
+    const Entry* bucketEnd(size_t bucket) const;
+
+private:
+    std::vector<std::unique_ptr<std::string>> text;  // lines the entries point into
+    std::vector<Entry> entries;                      // grouped by bucket, sorted by name
+    std::vector<size_t> bucketStart;                 // BUCKETS + 1 offsets into entries
+
+    void build(std::vector<std::vector<Entry>>& parts, unsigned threads);
+};
+
+/**
+ * Difference between two zoo states, as save-file lines
+ */
+struct ZooDelta {
+    std::vector<std::string> added;                             // lines only in the new state
+    std::vector<std::string> removed;                           // lines only in the old state
+    std::vector<std::pair<std::string, std::string>> changed;   // old line, new line
+    size_t unchanged = 0;
+
+    bool empty() const;
+
+    // Summary counts, then up to limit lines of each kind (+, -, ~)
+    void print(std::ostream& out, size_t limit) const;
+
+    // Turns the old state into the new one by touching only the changed
+    // animals. Each removed or changed line is matched to the animal whose
+    // whole record it is, not just the first one with that name. Added
+    // animals get the factory defaults for fields the save format does
+    // not carry. Throws AnimalNotFoundException, ZooFullException or
+    // InvalidOperationException before changing anything if the delta
+    // does not fit the zoo or holds a record that does not parse.
+    void apply(Zoo& zoo) const;
+};
+
+/**
+ * Linear-time comparison of two snapshots
+ * Matching buckets are merge-walked in parallel; records with the same
+ * name are compared by content hash only.
+ */
+class ZooDiff {
+public:
+    static ZooDelta compare(const ZooSnapshot& before, const ZooSnapshot& after, unsigned threads);
+};
+
+#endif // ZOODIFF_H
@@ -0,0 +1,277 @@
+#include "ZooLiveView.h"
+#include "Zoo.h"
+#include "Animal.h"
+#include "Exceptions.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <cerrno>
+#include <new>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace {
+
+const char MAGIC[8] = { 'Z', 'O', 'O', 'L', 'I', 'V', 'E', '1' };
+const uint32_t LAYOUT_VERSION = 1;
+const size_t ZOO_NAME_SIZE = 64;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "the live view needs lock-free 64-bit atomics in shared memory");
+static_assert(sizeof(LiveAnimalRow) == 64, "rows are one cache line");
+
+struct SegmentHeader {
+    char magic[8];
+    uint32_t layoutVersion;
+    uint32_t rowCapacity;
+    uint64_t bufferSize;
+    std::atomic<uint64_t> published;   // version of the current buffer, 0 = none
+};
+
+struct BufferHeader {
+    std::atomic<uint64_t> sequence;    // odd while publish() is writing
+    char zooName[ZOO_NAME_SIZE];
+    LiveAggregates totals;
+};
+
+size_t roundUp(size_t size) {
+    return (size + 63) & ~static_cast<size_t>(63);
+}
+
+size_t bufferSize(uint32_t rowCapacity) {
+    return roundUp(sizeof(BufferHeader)) + static_cast<size_t>(rowCapacity) * sizeof(LiveAnimalRow);
+}
+
+size_t segmentSize(uint32_t rowCapacity) {
+    return roundUp(sizeof(SegmentHeader)) + 2 * bufferSize(rowCapacity);
+}
+
+// Version v lives in buffer v % 2
+BufferHeader* bufferFor(void* base, uint32_t rowCapacity, uint64_t version) {
+    char* first = static_cast<char*>(base) + roundUp(sizeof(SegmentHeader));
+    return reinterpret_cast<BufferHeader*>(first + (version % 2) * bufferSize(rowCapacity));
+}
+
+LiveAnimalRow* rowsOf(BufferHeader* buffer) {
+    return reinterpret_cast<LiveAnimalRow*>(reinterpret_cast<char*>(buffer) + roundUp(sizeof(BufferHeader)));
+}
+
+// shm_open names are "/name"
+std::string segmentPath(const std::string& name) {
+    return !name.empty() && name[0] == '/' ? name : "/" + name;
+}
+
+void copyName(char* target, size_t size, const std::string& source) {
+    size_t length = std::min(source.size(), size - 1);
+    std::memcpy(target, source.data(), length);
+    std::memset(target + length, 0, size - length);
+}
+
+std::string systemError(const std::string& what, const std::string& name) {
+    return what + " " + name + ": " + std::strerror(errno);
+}
+
+} // namespace
+
+// ---- LiveViewPublisher ----
+
+LiveViewPublisher::LiveViewPublisher(const std::string& name, uint32_t rowCapacity)
+    : segmentName(segmentPath(name)), base(nullptr), mappedSize(segmentSize(rowCapacity)),
+      rowCapacity(rowCapacity) {
+    // Replace any segment left behind by a publisher that did not exit cleanly
+    shm_unlink(segmentName.c_str());
+    int fd = shm_open(segmentName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        throw InvalidOperationException(systemError("Cannot create live view", segmentName));
+    }
+    if (ftruncate(fd, static_cast<off_t>(mappedSize)) < 0) {
+        std::string message = systemError("Cannot size live view", segmentName);
+        close(fd);
+        shm_unlink(segmentName.c_str());
+        throw InvalidOperationException(message);
+    }
+    base = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        base = nullptr;
+        std::string message = systemError("Cannot map live view", segmentName);
+        shm_unlink(segmentName.c_str());
+        throw InvalidOperationException(message);
+    }
+
+    // The new segment is zero-filled, which is also the "nothing published"
+    // state of both buffers; the magic goes in last so readers never see a
+    // half-initialised header
+    SegmentHeader* header = new (base) SegmentHeader;
+    header->layoutVersion = LAYOUT_VERSION;
+    header->rowCapacity = rowCapacity;
+    header->bufferSize = bufferSize(rowCapacity);
+    header->published.store(0, std::memory_order_relaxed);
+    for (uint64_t version = 0; version < 2; ++version) {
+        new (bufferFor(base, rowCapacity, version)) BufferHeader;
+        bufferFor(base, rowCapacity, version)->sequence.store(0, std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(header->magic, MAGIC, sizeof(MAGIC));
+}
+
+LiveViewPublisher::~LiveViewPublisher() {
+    if (base) {
+        munmap(base, mappedSize);
+        shm_unlink(segmentName.c_str());
+    }
+}
+
+uint64_t LiveViewPublisher::publish(const Zoo& zoo) {
+    SegmentHeader* header = static_cast<SegmentHeader*>(base);
+    uint64_t version = header->published.load(std::memory_order_relaxed) + 1;
+    BufferHeader* buffer = bufferFor(base, rowCapacity, version);
+
+    uint64_t sequence = buffer->sequence.load(std::memory_order_relaxed);
+    buffer->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    LiveAggregates totals;
+    std::memset(&totals, 0, sizeof(totals));
+    LiveAnimalRow* rows = rowsOf(buffer);
+    for (const IAnimal* animal : zoo.getAnimals()) {
+        const Animal* a = dynamic_cast<const Animal*>(animal);
+        if (!a) continue;
+
+        double food = a->calculateFoodRequirement();
+        int species = static_cast<int>(a->getSpeciesId());
+        ++totals.animalCount;
+        totals.totalWeight += a->getWeight();
+        totals.totalFood += food;
+        if (!a->getHealthStatus()) ++totals.sickCount;
+        if (species < SPECIES_COUNT) ++totals.speciesCount[species];
+
+        if (totals.rowCount < rowCapacity) {
+            LiveAnimalRow& row = rows[totals.rowCount++];
+            copyName(row.name, sizeof(row.name), a->getName());
+            row.species = static_cast<uint8_t>(species);
+            row.healthy = a->getHealthStatus() ? 1 : 0;
+            row.reserved[0] = row.reserved[1] = 0;
+            row.age = a->getAge();
+            row.weight = a->getWeight();
+            row.food = food;
+        }
+    }
+    totals.version = version;
+    totals.publishedAtMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    copyName(buffer->zooName, sizeof(buffer->zooName), zoo.getZooName());
+    buffer->totals = totals;
+
+    buffer->sequence.store(sequence + 2, std::memory_order_release);
+    header->published.store(version, std::memory_order_release);
+    return version;
+}
+
+const std::string& LiveViewPublisher::getSegmentName() const {
+    return segmentName;
+}
+
+uint32_t LiveViewPublisher::getRowCapacity() const {
+    return rowCapacity;
+}
+
+// ---- LiveViewReader ----
+
+LiveViewReader::LiveViewReader(const std::string& name)
+    : base(nullptr), mappedSize(0), retries(0) {
+    std::string path = segmentPath(name);
+    int fd = shm_open(path.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        throw InvalidOperationException(systemError("Cannot open live view", path));
+    }
+    struct stat info;
+    if (fstat(fd, &info) < 0 || static_cast<size_t>(info.st_size) < sizeof(SegmentHeader)) {
+        close(fd);
+        throw InvalidOperationException("Not a zoo live view: " + path);
+    }
+    mappedSize = static_cast<size_t>(info.st_size);
+    base = mmap(nullptr, mappedSize, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        base = nullptr;
+        throw InvalidOperationException(systemError("Cannot map live view", path));
+    }
+
+    const SegmentHeader* header = static_cast<const SegmentHeader*>(base);
+    bool valid = std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) == 0
+        && header->layoutVersion == LAYOUT_VERSION
+        && header->bufferSize == bufferSize(header->rowCapacity)
+        && mappedSize >= segmentSize(header->rowCapacity);
+    if (!valid) {
+        munmap(base, mappedSize);
+        base = nullptr;
+        throw InvalidOperationException("Not a zoo live view: " + path);
+    }
+}
+
+LiveViewReader::~LiveViewReader() {
+    if (base) {
+        munmap(base, mappedSize);
+    }
+}
+
+bool LiveViewReader::snapshot(LiveSnapshot& out) {
+    SegmentHeader* header = static_cast<SegmentHeader*>(base);
+    uint32_t rowCapacity = header->rowCapacity;
+    char zooName[ZOO_NAME_SIZE];
+
+    for (;; ++retries) {
+        uint64_t version = header->published.load(std::memory_order_acquire);
+        if (version == 0) {
+            return false;
+        }
+        BufferHeader* buffer = bufferFor(base, rowCapacity, version);
+        uint64_t sequence = buffer->sequence.load(std::memory_order_acquire);
+        if (sequence % 2 != 0) {
+            continue;
+        }
+
+        out.totals = buffer->totals;
+        std::memcpy(zooName, buffer->zooName, sizeof(zooName));
+        size_t rowCount = static_cast<size_t>(std::min<uint64_t>(out.totals.rowCount, rowCapacity));
+        out.rows.resize(rowCount);
+        if (rowCount > 0) {
+            std::memcpy(out.rows.data(), rowsOf(buffer), rowCount * sizeof(LiveAnimalRow));
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (buffer->sequence.load(std::memory_order_relaxed) == sequence) {
+            zooName[sizeof(zooName) - 1] = '\0';
+            out.zooName = zooName;
+            return true;
+        }
+    }
+}
+
+bool LiveViewReader::readTotals(LiveAggregates& out) {
+    SegmentHeader* header = static_cast<SegmentHeader*>(base);
+    for (;; ++retries) {
+        uint64_t version = header->published.load(std::memory_order_acquire);
+        if (version == 0) {
+            return false;
+        }
+        BufferHeader* buffer = bufferFor(base, header->rowCapacity, version);
+        uint64_t sequence = buffer->sequence.load(std::memory_order_acquire);
+        if (sequence % 2 != 0) {
+            continue;
+        }
+        out = buffer->totals;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (buffer->sequence.load(std::memory_order_relaxed) == sequence) {
+            return true;
+        }
+    }
+}
+
+unsigned long long LiveViewReader::getRetries() const {
+    return retries;
+}
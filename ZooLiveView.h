@@ -0,0 +1,113 @@
+#ifndef ZOOLIVEVIEW_H
+#define ZOOLIVEVIEW_H
+
+#include "Species.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Zoo;
+
+/**
+ * Read-only live view of a zoo in POSIX shared memory (Linux only)
+ * One process publishes the animal table and its aggregates; any number
+ * of local processes map the same segment and take consistent snapshots
+ * without touching the zoo, its files or its locks.
+ *
+ * The segment holds two buffers. publish() always rewrites the buffer
+ * readers are not pointed at, guarded by a per-buffer sequence number
+ * (odd while being written), then flips the published version. Readers
+ * copy the current buffer and retry only if its sequence number moved,
+ * which needs two publishes during one read. The writer never waits for
+ * readers.
+ */
+
+// One animal, fixed size so readers can index the table directly
+struct LiveAnimalRow {
+    static const size_t NAME_SIZE = 40;
+
+    char name[NAME_SIZE];     // NUL-terminated, truncated if longer
+    uint8_t species;          // SpeciesId
+    uint8_t healthy;
+    uint8_t reserved[2];
+    int32_t age;
+    double weight;
+    double food;              // calculateFoodRequirement()
+
+    SpeciesId getSpeciesId() const { return static_cast<SpeciesId>(species); }
+};
+
+// Totals over the whole zoo, published together with the rows
+struct LiveAggregates {
+    uint64_t version;         // publish() count, 1 for the first one
+    int64_t publishedAtMs;    // wall clock, milliseconds since the epoch
+    uint64_t animalCount;
+    uint64_t rowCount;        // < animalCount if the segment is too small
+    uint64_t sickCount;
+    double totalWeight;
+    double totalFood;
+    uint64_t speciesCount[SPECIES_COUNT];
+};
+
+struct LiveSnapshot {
+    std::string zooName;
+    LiveAggregates totals;
+    std::vector<LiveAnimalRow> rows;
+};
+
+/**
+ * Owns the shared-memory segment and writes snapshots of a Zoo into it
+ * The segment is removed when the publisher is destroyed; readers that
+ * still have it mapped keep their last view.
+ */
+class LiveViewPublisher {
+private:
+    std::string segmentName;
+    void* base;
+    size_t mappedSize;
+    uint32_t rowCapacity;
+
+public:
+    // Creates (or replaces) segment name, sized for rowCapacity animals
+    LiveViewPublisher(const std::string& name, uint32_t rowCapacity);
+    ~LiveViewPublisher();
+
+    LiveViewPublisher(const LiveViewPublisher&) = delete;
+    LiveViewPublisher& operator=(const LiveViewPublisher&) = delete;
+
+    // Writes the zoo into the idle buffer and makes it current
+    // Returns the new version
+    uint64_t publish(const Zoo& zoo);
+
+    const std::string& getSegmentName() const;
+    uint32_t getRowCapacity() const;
+};
+
+/**
+ * Maps a published segment read-only and copies out consistent snapshots
+ */
+class LiveViewReader {
+private:
+    void* base;
+    size_t mappedSize;
+    unsigned long long retries;
+
+public:
+    explicit LiveViewReader(const std::string& name);
+    ~LiveViewReader();
+
+    LiveViewReader(const LiveViewReader&) = delete;
+    LiveViewReader& operator=(const LiveViewReader&) = delete;
+
+    // Fills out with the latest published state (reusing its storage)
+    // Returns false if nothing has been published yet
+    bool snapshot(LiveSnapshot& out);
+
+    // Aggregates only, without copying the rows
+    bool readTotals(LiveAggregates& out);
+
+    // Reads that had to start over because a publish overlapped them
+    unsigned long long getRetries() const;
+};
+
+#endif // ZOOLIVEVIEW_H
@@ -0,0 +1,171 @@
+#ifndef ZOOPROTOCOL_H
+#define ZOOPROTOCOL_H
+
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Wire protocol for the local socket server (see ZooServer.h)
+ *
+ * Every message is a frame: a 4-byte little-endian body length followed by
+ * the body. A request body starts with a one-byte opcode, a response body
+ * with a one-byte status; the rest is the payload. Integers are
+ * little-endian, doubles are IEEE-754 bits, strings are a 2-byte length
+ * followed by the bytes. Responses come back in request order, so clients
+ * may pipeline as many requests as they like on one connection.
+ */
+namespace ZooProtocol {
+
+const size_t HEADER_SIZE = 4;
+const uint32_t MAX_FRAME_SIZE = 64 * 1024;
+
+enum Opcode : uint8_t {
+    OP_PING = 0,
+    OP_ADD = 1,            // species, name, age (i32), weight (f64)
+    OP_REMOVE = 2,         // name
+    OP_FIND = 3,           // name -> species, name, age, weight, healthy (u8)
+    OP_COUNT = 4,          // -> count (i32)
+    OP_COUNT_SPECIES = 5,  // species -> count (i32)
+    OP_TOTAL_FOOD = 6,     // -> kilograms (f64)
+    OP_CHECKUPS = 7        // runs the daily checkups
+};
+
+enum Status : uint8_t {
+    STATUS_OK = 0,
+    STATUS_NOT_FOUND = 1,
+    STATUS_ZOO_FULL = 2,
+    STATUS_BAD_REQUEST = 3,
+    STATUS_ERROR = 4
+};
+
+/**
+ * Appends one frame to an output buffer
+ * The length prefix is patched in by finish()
+ */
+class FrameWriter {
+private:
+    std::string& out;
+    size_t start;
+
+    void putRaw(const void* data, size_t size) {
+        out.append(static_cast<const char*>(data), size);
+    }
+
+public:
+    explicit FrameWriter(std::string& buffer) : out(buffer), start(buffer.size()) {
+        out.append(HEADER_SIZE, '\0');
+    }
+
+    void putU8(uint8_t value) {
+        out.push_back(static_cast<char>(value));
+    }
+
+    void putU32(uint32_t value) {
+        char bytes[4];
+        for (int i = 0; i < 4; ++i) {
+            bytes[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+        }
+        putRaw(bytes, 4);
+    }
+
+    void putI32(int32_t value) {
+        putU32(static_cast<uint32_t>(value));
+    }
+
+    void putF64(double value) {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        putU32(static_cast<uint32_t>(bits));
+        putU32(static_cast<uint32_t>(bits >> 32));
+    }
+
+    void putString(const std::string& value) {
+        size_t size = value.size() > 0xFFFF ? 0xFFFF : value.size();
+        putU8(static_cast<uint8_t>(size & 0xFF));
+        putU8(static_cast<uint8_t>(size >> 8));
+        putRaw(value.data(), size);
+    }
+
+    void finish() {
+        uint32_t length = static_cast<uint32_t>(out.size() - start - HEADER_SIZE);
+        for (size_t i = 0; i < HEADER_SIZE; ++i) {
+            out[start + i] = static_cast<char>((length >> (8 * i)) & 0xFF);
+        }
+    }
+};
+
+/**
+ * Reads fields from a frame body
+ * Every getter returns false instead of reading past the end
+ */
+class FrameReader {
+private:
+    const unsigned char* data;
+    size_t size;
+    size_t pos;
+
+public:
+    FrameReader(const char* body, size_t length)
+        : data(reinterpret_cast<const unsigned char*>(body)), size(length), pos(0) {}
+
+    bool getU8(uint8_t& value) {
+        if (pos + 1 > size) return false;
+        value = data[pos++];
+        return true;
+    }
+
+    bool getU32(uint32_t& value) {
+        if (pos + 4 > size) return false;
+        value = 0;
+        for (int i = 0; i < 4; ++i) {
+            value |= static_cast<uint32_t>(data[pos + i]) << (8 * i);
+        }
+        pos += 4;
+        return true;
+    }
+
+    bool getI32(int32_t& value) {
+        uint32_t raw;
+        if (!getU32(raw)) return false;
+        value = static_cast<int32_t>(raw);
+        return true;
+    }
+
+    bool getF64(double& value) {
+        uint32_t low, high;
+        if (!getU32(low) || !getU32(high)) return false;
+        uint64_t bits = (static_cast<uint64_t>(high) << 32) | low;
+        std::memcpy(&value, &bits, sizeof(value));
+        return true;
+    }
+
+    bool getString(std::string& value) {
+        if (pos + 2 > size) return false;
+        size_t length = data[pos] | (static_cast<size_t>(data[pos + 1]) << 8);
+        pos += 2;
+        if (pos + length > size) return false;
+        value.assign(reinterpret_cast<const char*>(data + pos), length);
+        pos += length;
+        return true;
+    }
+
+    bool atEnd() const { return pos == size; }
+};
+
+/**
+ * Length of the frame body starting at buffer, or false if the
+ * header is not complete yet
+ */
+inline bool peekFrameLength(const char* buffer, size_t available, uint32_t& length) {
+    if (available < HEADER_SIZE) return false;
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(buffer);
+    length = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16)
+             | (static_cast<uint32_t>(bytes[3]) << 24);
+    return true;
+}
+
+} // namespace ZooProtocol
+
+#endif // ZOOPROTOCOL_H
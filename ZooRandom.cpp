@@ -0,0 +1,49 @@
+#include "ZooRandom.h"
+#include <atomic>
+
+namespace {
+
+std::atomic<uint64_t> baseSeed(0x5EED5EED5EED5EEDULL);
+std::atomic<uint64_t> threadOrdinal(0);
+
+uint64_t mix(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+struct ThreadState {
+    uint64_t state;
+
+    ThreadState() {
+        state = mix(baseSeed.load() + mix(threadOrdinal.fetch_add(1) + 1));
+    }
+};
+
+thread_local ThreadState current;
+
+} // namespace
+
+void ZooRandom::seed(uint64_t value) {
+    baseSeed.store(value);
+    threadOrdinal.store(0);
+    seedThread(value);
+}
+
+void ZooRandom::seedThread(uint64_t threadSeed) {
+    current.state = mix(threadSeed);
+}
+
+uint64_t ZooRandom::next() {
+    current.state += 0x9E3779B97F4A7C15ULL;
+    return mix(current.state);
+}
+
+size_t ZooRandom::below(size_t bound) {
+    // Modulo bias is negligible for the small bounds used here
+    return static_cast<size_t>(next() % bound);
+}
+
+double ZooRandom::unit() {
+    return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0);
+}
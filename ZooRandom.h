@@ -0,0 +1,32 @@
+#ifndef ZOORANDOM_H
+#define ZOORANDOM_H
+
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Seedable random numbers with one generator per thread
+ * Replaces the global rand(): each thread owns a small SplitMix64 state,
+ * so there is no shared state to contend on. A thread's stream is derived
+ * from the global seed and the order in which threads first draw a
+ * number; parallel simulations that need exact reproducibility call
+ * seedThread() with a per-worker seed instead.
+ */
+class ZooRandom {
+public:
+    // Base seed for threads that have not drawn a number yet
+    static void seed(uint64_t baseSeed);
+
+    // Reset the calling thread's generator
+    static void seedThread(uint64_t threadSeed);
+
+    static uint64_t next();
+
+    // Uniform value in [0, bound); bound must be non-zero
+    static size_t below(size_t bound);
+
+    // Uniform value in [0, 1)
+    static double unit();
+};
+
+#endif // ZOORANDOM_H
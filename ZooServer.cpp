@@ -0,0 +1,403 @@
+#include "ZooServer.h"
+#include "ZooProtocol.h"
+#include "Animal.h"
+#include "AnimalFactory.h"
+#include "Exceptions.h"
+#include "ZooLiveView.h"
+#include <iostream>
+#include <stdexcept>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/epoll.h>
+
+using namespace ZooProtocol;
+
+namespace {
+
+const int MAX_EVENTS = 64;
+const size_t READ_CHUNK = 64 * 1024;
+
+// Swallows everything written to it
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize count) override { return count; }
+};
+
+// Points std::cout at a NullBuffer for its lifetime
+class SilenceConsole {
+private:
+    NullBuffer discard;
+    std::streambuf* console;
+
+public:
+    SilenceConsole() : console(std::cout.rdbuf(&discard)) {}
+    ~SilenceConsole() { std::cout.rdbuf(console); }
+};
+
+void setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+        throw InvalidOperationException(std::string("fcntl failed: ") + std::strerror(errno));
+    }
+}
+
+void writeStatus(std::string& out, Status status) {
+    FrameWriter frame(out);
+    frame.putU8(status);
+    frame.finish();
+}
+
+} // namespace
+
+ZooServer::ZooServer(Zoo& zoo, const std::string& socketPath)
+    : zoo(zoo), socketPath(socketPath), listenFd(-1), epollFd(-1),
+      running(false), requestsServed(0), liveView(nullptr),
+      liveViewInterval(0), publishedRequests(0) {
+}
+
+ZooServer::~ZooServer() {
+    for (auto& entry : connections) {
+        close(entry.first);
+    }
+    if (listenFd >= 0) {
+        close(listenFd);
+        unlink(socketPath.c_str());
+    }
+    if (epollFd >= 0) {
+        close(epollFd);
+    }
+}
+
+void ZooServer::run() {
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        throw InvalidOperationException("Socket path too long: " + socketPath);
+    }
+    std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+    listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0) {
+        throw InvalidOperationException(std::string("socket failed: ") + std::strerror(errno));
+    }
+    unlink(socketPath.c_str());
+    if (bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0
+        || listen(listenFd, SOMAXCONN) < 0) {
+        throw InvalidOperationException("Cannot listen on " + socketPath + ": " + std::strerror(errno));
+    }
+    setNonBlocking(listenFd);
+
+    epollFd = epoll_create1(0);
+    if (epollFd < 0) {
+        throw InvalidOperationException(std::string("epoll_create1 failed: ") + std::strerror(errno));
+    }
+    epoll_event event;
+    std::memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.fd = listenFd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &event);
+
+    std::cerr << "Zoo server listening on " << socketPath << std::endl;
+
+    running = true;
+    publishLiveView(true);
+    epoll_event events[MAX_EVENTS];
+    while (running) {
+        int ready = epoll_wait(epollFd, events, MAX_EVENTS, 500);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            throw InvalidOperationException(std::string("epoll_wait failed: ") + std::strerror(errno));
+        }
+
+        for (int i = 0; i < ready; ++i) {
+            int fd = events[i].data.fd;
+            if (fd == listenFd) {
+                acceptClients();
+                continue;
+            }
+
+            auto it = connections.find(fd);
+            if (it == connections.end()) continue;
+            Connection& conn = it->second;
+
+            bool alive = !(events[i].events & EPOLLERR);
+            if (events[i].events & EPOLLHUP) {
+                conn.closing = true; // still carry out what was sent
+            }
+            if (alive && (events[i].events & EPOLLIN)) {
+                alive = readFrom(fd, conn);
+                if (alive) processFrames(conn);
+            }
+            if (alive) {
+                alive = flush(fd, conn);
+            }
+            if (alive && conn.closing && conn.output.empty()) {
+                alive = false; // every reply is out
+            }
+            if (!alive) {
+                closeConnection(fd);
+            }
+        }
+        publishLiveView(false);
+    }
+
+    std::cerr << "Zoo server stopped after " << requestsServed << " requests" << std::endl;
+}
+
+void ZooServer::stop() {
+    running = false;
+}
+
+unsigned long long ZooServer::getRequestsServed() const {
+    return requestsServed;
+}
+
+void ZooServer::setLiveView(LiveViewPublisher* publisher, std::chrono::milliseconds interval) {
+    liveView = publisher;
+    liveViewInterval = interval;
+}
+
+void ZooServer::publishLiveView(bool force) {
+    if (!liveView || (!force && publishedRequests == requestsServed)) {
+        return;
+    }
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (!force && now - lastPublish < liveViewInterval) {
+        return;
+    }
+    liveView->publish(zoo);
+    publishedRequests = requestsServed;
+    lastPublish = now;
+}
+
+void ZooServer::acceptClients() {
+    while (true) {
+        int fd = accept(listenFd, nullptr, nullptr);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            return; // EAGAIN: no more pending clients
+        }
+        setNonBlocking(fd);
+
+        epoll_event event;
+        std::memset(&event, 0, sizeof(event));
+        event.events = EPOLLIN | EPOLLRDHUP;
+        event.data.fd = fd;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) < 0) {
+            close(fd);
+            continue;
+        }
+        connections[fd] = Connection();
+        connections[fd].events = event.events;
+    }
+}
+
+bool ZooServer::readFrom(int fd, Connection& conn) {
+    char chunk[READ_CHUNK];
+    while (true) {
+        ssize_t received = recv(fd, chunk, sizeof(chunk), 0);
+        if (received > 0) {
+            conn.input.append(chunk, static_cast<size_t>(received));
+            continue;
+        }
+        if (received == 0) {
+            // Peer closed or half-closed: still answer what it sent
+            conn.closing = true;
+            return true;
+        }
+        if (errno == EINTR) continue;
+        return errno == EAGAIN || errno == EWOULDBLOCK;
+    }
+}
+
+void ZooServer::processFrames(Connection& conn) {
+    size_t offset = 0;
+    uint32_t length;
+    while (peekFrameLength(conn.input.data() + offset, conn.input.size() - offset, length)) {
+        if (length > MAX_FRAME_SIZE) {
+            // Cannot resynchronise after a corrupt length: answer, then
+            // drop the stream rather than parse its body as frames
+            conn.input.clear();
+            writeStatus(conn.output, STATUS_BAD_REQUEST);
+            conn.closing = true;
+            return;
+        }
+        if (conn.input.size() - offset < HEADER_SIZE + length) break;
+
+        handleRequest(conn.input.data() + offset + HEADER_SIZE, length, conn.output);
+        offset += HEADER_SIZE + length;
+        ++requestsServed;
+    }
+    conn.input.erase(0, offset);
+    if (conn.closing) {
+        conn.input.clear(); // a partial frame that will never complete
+    }
+}
+
+bool ZooServer::flush(int fd, Connection& conn) {
+    while (conn.outputSent < conn.output.size()) {
+        ssize_t sent = send(fd, conn.output.data() + conn.outputSent,
+                            conn.output.size() - conn.outputSent, MSG_NOSIGNAL);
+        if (sent > 0) {
+            conn.outputSent += static_cast<size_t>(sent);
+            continue;
+        }
+        if (sent < 0 && errno == EINTR) continue;
+        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        return false;
+    }
+
+    bool pending = conn.outputSent < conn.output.size();
+    if (!pending) {
+        conn.output.clear();
+        conn.outputSent = 0;
+    }
+    // A closing connection is only waited on for writing
+    uint32_t wanted = (conn.closing ? 0u : static_cast<uint32_t>(EPOLLIN | EPOLLRDHUP))
+                    | (pending ? static_cast<uint32_t>(EPOLLOUT) : 0u);
+    if (wanted != conn.events) {
+        epoll_event event;
+        std::memset(&event, 0, sizeof(event));
+        event.events = wanted;
+        event.data.fd = fd;
+        epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &event);
+        conn.events = wanted;
+    }
+    return true;
+}
+
+void ZooServer::closeConnection(int fd) {
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    close(fd);
+    connections.erase(fd);
+}
+
+void ZooServer::handleRequest(const char* body, size_t length, std::string& out) {
+    FrameReader request(body, length);
+    uint8_t opcode;
+    if (!request.getU8(opcode)) {
+        writeStatus(out, STATUS_BAD_REQUEST);
+        return;
+    }
+
+    try {
+        switch (opcode) {
+            // Every request must use its whole frame: trailing bytes mean
+            // client and server disagree on the layout
+            case OP_PING:
+                if (!request.atEnd()) break;
+                writeStatus(out, STATUS_OK);
+                return;
+
+            case OP_ADD: {
+                std::string species, name;
+                int32_t age;
+                double weight;
+                if (!request.getString(species) || !request.getString(name)
+                    || !request.getI32(age) || !request.getF64(weight) || !request.atEnd()) {
+                    break;
+                }
+                IAnimal* animal = AnimalFactory::createAnimal(species, name, age, weight);
+                ZooStatus status = zoo.tryAddAnimal(animal);
+                if (status != ZooStatus::Ok) {
+                    delete animal;
+                }
+                writeStatus(out, status == ZooStatus::Full ? STATUS_ZOO_FULL : STATUS_OK);
+                return;
+            }
+
+            case OP_REMOVE: {
+                std::string name;
+                if (!request.getString(name) || !request.atEnd()) break;
+                ZooStatus status = zoo.tryRemoveAnimal(name);
+                writeStatus(out, status == ZooStatus::Ok ? STATUS_OK : STATUS_NOT_FOUND);
+                return;
+            }
+
+            case OP_FIND: {
+                std::string name;
+                if (!request.getString(name) || !request.atEnd()) break;
+                // Owned by the zoo; only read while this request runs
+                const Animal* a = dynamic_cast<const Animal*>(zoo.tryFindAnimal(name));
+                if (!a) {
+                    writeStatus(out, STATUS_NOT_FOUND);
+                    return;
+                }
+                FrameWriter response(out);
+                response.putU8(STATUS_OK);
+                response.putString(a->getSpecies());
+                response.putString(a->getName());
+                response.putI32(a->getAge());
+                response.putF64(a->getWeight());
+                response.putU8(a->getHealthStatus() ? 1 : 0);
+                response.finish();
+                return;
+            }
+
+            case OP_COUNT: {
+                if (!request.atEnd()) break;
+                FrameWriter response(out);
+                response.putU8(STATUS_OK);
+                response.putI32(zoo.getAnimalCount());
+                response.finish();
+                return;
+            }
+
+            case OP_COUNT_SPECIES: {
+                std::string species;
+                if (!request.getString(species) || !request.atEnd()) break;
+                FrameWriter response(out);
+                response.putU8(STATUS_OK);
+                response.putI32(zoo.countBySpecies(species));
+                response.finish();
+                return;
+            }
+
+            case OP_TOTAL_FOOD: {
+                if (!request.atEnd()) break;
+                FrameWriter response(out);
+                response.putU8(STATUS_OK);
+                response.putF64(zoo.calculateTotalFoodRequirement());
+                response.finish();
+                return;
+            }
+
+            case OP_CHECKUPS: {
+                if (!request.atEnd()) break;
+                // Checkups print each animal; the server's console is
+                // for the server's own messages
+                SilenceConsole quiet;
+                zoo.performDailyCheckups();
+                writeStatus(out, STATUS_OK);
+                return;
+            }
+
+            default:
+                break;
+        }
+    }
+    catch (const AnimalNotFoundException&) {
+        writeStatus(out, STATUS_NOT_FOUND);
+        return;
+    }
+    catch (const ZooFullException&) {
+        writeStatus(out, STATUS_ZOO_FULL);
+        return;
+    }
+    catch (const std::invalid_argument&) {
+        writeStatus(out, STATUS_BAD_REQUEST);
+        return;
+    }
+    catch (const std::exception&) {
+        writeStatus(out, STATUS_ERROR);
+        return;
+    }
+
+    writeStatus(out, STATUS_BAD_REQUEST);
+}
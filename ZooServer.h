@@ -0,0 +1,77 @@
+#ifndef ZOOSERVER_H
+#define ZOOSERVER_H
+
+#include "Zoo.h"
+#include <string>
+#include <map>
+#include <cstdint>
+#include <csignal>
+#include <chrono>
+
+class LiveViewPublisher;
+
+/**
+ * Serves Zoo operations over a Unix domain socket (Linux only)
+ * Single-threaded epoll loop: every readable connection has all of its
+ * complete frames executed in one go, and the responses are written back
+ * with a single send, so pipelined clients get batched replies.
+ * The wire format is described in ZooProtocol.h.
+ */
+class ZooServer {
+private:
+    struct Connection {
+        std::string input;
+        std::string output;
+        size_t outputSent;
+        uint32_t events;        // registered with epoll
+        // No more requests will be read: the peer shut down its side, or
+        // sent a frame the stream cannot be resynchronised after. Replies
+        // already queued are flushed, then the connection is closed.
+        bool closing;
+
+        Connection() : outputSent(0), events(0), closing(false) {}
+    };
+
+    Zoo& zoo;
+    std::string socketPath;
+    int listenFd;
+    int epollFd;
+    volatile std::sig_atomic_t running;
+    std::map<int, Connection> connections;
+    unsigned long long requestsServed;
+
+    // Optional shared-memory view, republished at most every liveViewInterval
+    LiveViewPublisher* liveView;
+    std::chrono::milliseconds liveViewInterval;
+    unsigned long long publishedRequests;
+    std::chrono::steady_clock::time_point lastPublish;
+
+    void publishLiveView(bool force);
+
+    void acceptClients();
+    bool readFrom(int fd, Connection& conn);
+    bool flush(int fd, Connection& conn);
+    void closeConnection(int fd);
+    void processFrames(Connection& conn);
+    void handleRequest(const char* body, size_t length, std::string& out);
+
+public:
+    ZooServer(Zoo& zoo, const std::string& socketPath);
+    ~ZooServer();
+
+    ZooServer(const ZooServer&) = delete;
+    ZooServer& operator=(const ZooServer&) = delete;
+
+    // Bind the socket and serve until stop() is called
+    // stop() is async-signal-safe so it can be called from a signal handler
+    void run();
+    void stop();
+
+    unsigned long long getRequestsServed() const;
+
+    // Publish the zoo to publisher after requests change it (see ZooLiveView.h)
+    // Must be set before run(); the publisher must outlive the server
+    void setLiveView(LiveViewPublisher* publisher, std::chrono::milliseconds interval);
+};
+
+#endif // ZOOSERVER_H
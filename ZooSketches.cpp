@@ -0,0 +1,398 @@
+#include "ZooSketches.h"
+#include "Animal.h"
+#include <cmath>
+#include <iomanip>
+#include <algorithm>
+
+const double QuantileSketch::RELATIVE_ACCURACY = 0.01;
+
+namespace {
+
+const double GAMMA = (1.0 + QuantileSketch::RELATIVE_ACCURACY) / (1.0 - QuantileSketch::RELATIVE_ACCURACY);
+const double LOG_GAMMA = std::log(GAMMA);
+
+// Below this a value goes in the zero bucket (ages of newborns)
+const double MIN_VALUE = 1e-6;
+
+const uint8_t SKETCH_VERSION = 1;
+
+// FNV-1a spreads short names poorly over the high bits HyperLogLog
+// uses to pick a register, so finish with a 64-bit mixer
+uint64_t mix(uint64_t hash) {
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ull;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+} // namespace
+
+QuantileSketch::QuantileSketch() : offset(0), zeroCount(0), total(0) {}
+
+int32_t QuantileSketch::bucketOf(double value) {
+    return static_cast<int32_t>(std::ceil(std::log(value) / LOG_GAMMA));
+}
+
+double QuantileSketch::bucketValue(int32_t index) {
+    // Midpoint (in relative terms) of (gamma^(i-1), gamma^i]
+    return 2.0 * std::pow(GAMMA, index) / (GAMMA + 1.0);
+}
+
+void QuantileSketch::add(double value) {
+    ++total;
+    if (value < MIN_VALUE) {
+        ++zeroCount;
+        return;
+    }
+    int32_t index = bucketOf(value);
+    if (counts.empty()) {
+        offset = index;
+        counts.assign(1, 0);
+    } else if (index < offset) {
+        counts.insert(counts.begin(), static_cast<size_t>(offset - index), 0);
+        offset = index;
+    } else if (static_cast<size_t>(index - offset) >= counts.size()) {
+        counts.resize(static_cast<size_t>(index - offset) + 1, 0);
+    }
+    ++counts[static_cast<size_t>(index - offset)];
+}
+
+bool QuantileSketch::remove(double value) {
+    if (value < MIN_VALUE) {
+        if (zeroCount == 0) {
+            return false;
+        }
+        --zeroCount;
+        --total;
+        return true;
+    }
+    int32_t index = bucketOf(value);
+    if (index < offset || static_cast<size_t>(index - offset) >= counts.size()
+        || counts[static_cast<size_t>(index - offset)] == 0) {
+        return false;
+    }
+    --counts[static_cast<size_t>(index - offset)];
+    --total;
+    return true;
+}
+
+void QuantileSketch::merge(const QuantileSketch& other) {
+    if (other.counts.empty()) {
+        zeroCount += other.zeroCount;
+        total += other.total;
+        return;
+    }
+    if (counts.empty()) {
+        offset = other.offset;
+        counts.assign(other.counts.size(), 0);
+    }
+    int32_t low = std::min(offset, other.offset);
+    int32_t high = std::max(offset + static_cast<int32_t>(counts.size()),
+                            other.offset + static_cast<int32_t>(other.counts.size()));
+    if (low < offset) {
+        counts.insert(counts.begin(), static_cast<size_t>(offset - low), 0);
+        offset = low;
+    }
+    counts.resize(static_cast<size_t>(high - offset), 0);
+    for (size_t i = 0; i < other.counts.size(); ++i) {
+        counts[static_cast<size_t>(other.offset - offset) + i] += other.counts[i];
+    }
+    zeroCount += other.zeroCount;
+    total += other.total;
+}
+
+uint64_t QuantileSketch::count() const {
+    return total;
+}
+
+double QuantileSketch::quantile(double q) const {
+    if (total == 0) {
+        return 0.0;
+    }
+    q = std::min(std::max(q, 0.0), 1.0);
+    uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(total - 1));
+    if (rank < zeroCount) {
+        return 0.0;
+    }
+    uint64_t seen = zeroCount;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        seen += counts[i];
+        if (seen > rank) {
+            return bucketValue(offset + static_cast<int32_t>(i));
+        }
+    }
+    return bucketValue(offset + static_cast<int32_t>(counts.size()) - 1);
+}
+
+void QuantileSketch::encode(std::string& out) const {
+    // Trim empty buckets at both ends; removals can leave them behind
+    size_t first = 0;
+    size_t last = counts.size();
+    while (first < last && counts[first] == 0) ++first;
+    while (last > first && counts[last - 1] == 0) --last;
+    BinaryCodec::putVarint(out, zeroCount);
+    BinaryCodec::putZigzag(out, offset + static_cast<int32_t>(first));
+    BinaryCodec::putVarint(out, last - first);
+    for (size_t i = first; i < last; ++i) {
+        BinaryCodec::putVarint(out, counts[i]);
+    }
+}
+
+QuantileSketch QuantileSketch::decode(BinaryCodec::Reader& in) {
+    QuantileSketch sketch;
+    sketch.zeroCount = in.varint();
+    sketch.total = sketch.zeroCount;
+    int64_t offset = in.zigzag();
+    uint64_t buckets = in.varint();
+    // Bucket indexes of doubles stay within +-40000 at 1% accuracy
+    if (offset < -100000 || offset > 100000 || buckets > 200000) {
+        throw InvalidOperationException("Corrupt sketch data");
+    }
+    sketch.offset = static_cast<int32_t>(offset);
+    sketch.counts.resize(static_cast<size_t>(buckets));
+    for (uint64_t& bucket : sketch.counts) {
+        bucket = in.varint();
+        sketch.total += bucket;
+    }
+    return sketch;
+}
+
+DistinctCounter::DistinctCounter() : registers(size_t(1) << PRECISION, 0) {}
+
+void DistinctCounter::add(const std::string& value) {
+    uint64_t hash = mix(BinaryCodec::hash64(value.data(), value.size()));
+    size_t index = static_cast<size_t>(hash >> (64 - PRECISION));
+    uint64_t rest = hash << PRECISION;
+    uint8_t rank = 1;
+    const uint8_t maxRank = 64 - PRECISION + 1;
+    while (rank < maxRank && !(rest & (1ull << 63))) {
+        rest <<= 1;
+        ++rank;
+    }
+    registers[index] = std::max(registers[index], rank);
+}
+
+void DistinctCounter::merge(const DistinctCounter& other) {
+    for (size_t i = 0; i < registers.size(); ++i) {
+        registers[i] = std::max(registers[i], other.registers[i]);
+    }
+}
+
+double DistinctCounter::estimate() const {
+    const double m = static_cast<double>(registers.size());
+    double sum = 0.0;
+    size_t zeros = 0;
+    for (uint8_t reg : registers) {
+        sum += std::ldexp(1.0, -reg);
+        zeros += reg == 0;
+    }
+    double estimate = (0.7213 / (1.0 + 1.079 / m)) * m * m / sum;
+    // Small counts: linear counting over the empty registers is closer
+    if (estimate <= 2.5 * m && zeros > 0) {
+        estimate = m * std::log(m / static_cast<double>(zeros));
+    }
+    return estimate;
+}
+
+void DistinctCounter::encode(std::string& out) const {
+    // Mostly zeros for small populations: store (zero run, value) pairs
+    size_t i = 0;
+    while (i < registers.size()) {
+        size_t run = 0;
+        while (i < registers.size() && registers[i] == 0) {
+            ++run;
+            ++i;
+        }
+        BinaryCodec::putVarint(out, run);
+        if (i < registers.size()) {
+            BinaryCodec::putU8(out, registers[i++]);
+        }
+    }
+}
+
+DistinctCounter DistinctCounter::decode(BinaryCodec::Reader& in) {
+    DistinctCounter counter;
+    size_t i = 0;
+    while (i < counter.registers.size()) {
+        uint64_t run = in.varint();
+        if (run > counter.registers.size() - i) {
+            throw InvalidOperationException("Corrupt sketch data");
+        }
+        i += static_cast<size_t>(run);
+        if (i < counter.registers.size()) {
+            counter.registers[i++] = in.u8();
+        }
+    }
+    return counter;
+}
+
+void SpeciesSketch::merge(const SpeciesSketch& other) {
+    ages.merge(other.ages);
+    weights.merge(other.weights);
+    names.merge(other.names);
+}
+
+SpeciesSketch& PopulationSketch::entry(SpeciesId species) {
+    return bySpecies[std::min(static_cast<int>(species), SPECIES_COUNT)];
+}
+
+void PopulationSketch::add(SpeciesId species, int age, double weight, const std::string& name) {
+    SpeciesSketch& s = entry(species);
+    s.ages.add(age);
+    s.weights.add(weight);
+    s.names.add(name);
+}
+
+void PopulationSketch::remove(SpeciesId species, int age, double weight) {
+    SpeciesSketch& s = entry(species);
+    s.ages.remove(age);
+    s.weights.remove(weight);
+}
+
+void PopulationSketch::changeWeight(SpeciesId species, double from, double to) {
+    SpeciesSketch& s = entry(species);
+    if (s.weights.remove(from)) {
+        s.weights.add(to);
+    }
+}
+
+void PopulationSketch::changeAge(SpeciesId species, int from, int to) {
+    SpeciesSketch& s = entry(species);
+    if (s.ages.remove(from)) {
+        s.ages.add(to);
+    }
+}
+
+PopulationSketch& PopulationSketch::merge(const PopulationSketch& other) {
+    for (int i = 0; i <= SPECIES_COUNT; ++i) {
+        bySpecies[i].merge(other.bySpecies[i]);
+    }
+    return *this;
+}
+
+const SpeciesSketch& PopulationSketch::getSpecies(SpeciesId species) const {
+    return bySpecies[std::min(static_cast<int>(species), SPECIES_COUNT)];
+}
+
+SpeciesSketch PopulationSketch::getTotal() const {
+    SpeciesSketch total;
+    for (const SpeciesSketch& s : bySpecies) {
+        total.merge(s);
+    }
+    return total;
+}
+
+std::string PopulationSketch::encode() const {
+    std::string out;
+    BinaryCodec::putU8(out, SKETCH_VERSION);
+    for (const SpeciesSketch& s : bySpecies) {
+        s.ages.encode(out);
+        s.weights.encode(out);
+        s.names.encode(out);
+    }
+    return out;
+}
+
+PopulationSketch PopulationSketch::decode(const std::string& data) {
+    BinaryCodec::Reader in(data);
+    if (in.u8() != SKETCH_VERSION) {
+        throw InvalidOperationException("Unsupported sketch version");
+    }
+    PopulationSketch sketch;
+    for (SpeciesSketch& s : sketch.bySpecies) {
+        s.ages = QuantileSketch::decode(in);
+        s.weights = QuantileSketch::decode(in);
+        s.names = DistinctCounter::decode(in);
+    }
+    if (!in.atEnd()) {
+        throw InvalidOperationException("Corrupt sketch data");
+    }
+    return sketch;
+}
+
+void PopulationSketch::print(std::ostream& out) const {
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+
+    out << "\n=== Population Sketch (approximate) ===" << std::endl;
+    out << std::left << std::setw(10) << "Species" << std::right
+        << std::setw(10) << "Count" << std::setw(10) << "Names"
+        << std::setw(22) << "Age p50/p95/p99" << std::setw(28) << "Weight p50/p95/p99" << std::endl;
+
+    auto row = [&out](const char* label, const SpeciesSketch& s) {
+        out << std::left << std::setw(10) << label << std::right
+            << std::setw(10) << s.ages.count()
+            << std::setw(10) << static_cast<uint64_t>(std::llround(s.names.estimate()))
+            << std::fixed << std::setprecision(1)
+            << std::setw(8) << s.ages.quantile(0.5) << std::setw(7) << s.ages.quantile(0.95)
+            << std::setw(7) << s.ages.quantile(0.99)
+            << std::setw(10) << s.weights.quantile(0.5) << std::setw(9) << s.weights.quantile(0.95)
+            << std::setw(9) << s.weights.quantile(0.99) << std::endl;
+    };
+
+    for (int i = 0; i <= SPECIES_COUNT; ++i) {
+        if (bySpecies[i].ages.count() > 0) {
+            row(speciesName(static_cast<SpeciesId>(i)), bySpecies[i]);
+        }
+    }
+    row("Total", getTotal());
+
+    out.flags(flags);
+    out.precision(precision);
+}
+
+void ZooSketches::onAdded(const Animal& animal, size_t slot) {
+    if (slot >= slots.size()) {
+        slots.resize(slot + 1);
+    }
+    SlotState& state = slots[slot];
+    state.weight = static_cast<float>(animal.getWeight());
+    state.age = static_cast<uint16_t>(animal.getAge());
+    state.species = animal.getSpeciesId();
+    sketch.add(state.species, state.age, state.weight, animal.getName());
+}
+
+void ZooSketches::onRemoved(size_t slot) {
+    if (slot < slots.size()) {
+        const SlotState& state = slots[slot];
+        sketch.remove(state.species, state.age, state.weight);
+    }
+}
+
+void ZooSketches::onChanged(const Animal& animal, size_t slot) {
+    if (slot >= slots.size()) {
+        return;
+    }
+    SlotState& state = slots[slot];
+    float weight = static_cast<float>(animal.getWeight());
+    sketch.changeWeight(state.species, state.weight, weight);
+    state.weight = weight;
+    uint16_t age = static_cast<uint16_t>(animal.getAge());
+    if (age != state.age) {
+        sketch.changeAge(state.species, state.age, age);
+        state.age = age;
+    }
+}
+
+void ZooSketches::moveSlot(size_t from, size_t to) {
+    if (from < slots.size() && to < slots.size()) {
+        slots[to] = slots[from];
+    }
+}
+
+void ZooSketches::resize(size_t slotCount) {
+    if (slotCount < slots.size()) {
+        slots.resize(slotCount);
+    }
+}
+
+void ZooSketches::clear() {
+    slots.clear();
+    sketch = PopulationSketch();
+}
+
+const PopulationSketch& ZooSketches::getSketch() const {
+    return sketch;
+}
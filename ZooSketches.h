@@ -0,0 +1,153 @@
+#ifndef ZOOSKETCHES_H
+#define ZOOSKETCHES_H
+
+#include "Species.h"
+#include "BinaryCodec.h"
+#include <vector>
+#include <string>
+#include <ostream>
+#include <cstddef>
+#include <cstdint>
+
+class Animal;
+
+/**
+ * Mergeable quantile sketch with a relative error bound (DDSketch)
+ * Values fall into logarithmic buckets of width RELATIVE_ACCURACY, so a
+ * quantile is within 1% of the true value whatever the distribution.
+ * Unlike t-digest or KLL, a bucket count can go down again, which lets
+ * the sketch follow removals and weight changes. Merging adds bucket
+ * counts; a quantile walks a few hundred buckets.
+ */
+class QuantileSketch {
+public:
+    static const double RELATIVE_ACCURACY;
+
+private:
+    int32_t offset;                 // bucket index of counts[0]
+    std::vector<uint64_t> counts;
+    uint64_t zeroCount;             // values too small for a log bucket
+    uint64_t total;
+
+    static int32_t bucketOf(double value);
+    static double bucketValue(int32_t index);
+
+public:
+    QuantileSketch();
+
+    void add(double value);
+    // Takes back one earlier add of value; false (and no change) if the
+    // sketch holds nothing in that bucket
+    bool remove(double value);
+    void merge(const QuantileSketch& other);
+
+    uint64_t count() const;
+    // q in [0, 1]; 0 for an empty sketch
+    double quantile(double q) const;
+
+    void encode(std::string& out) const;
+    static QuantileSketch decode(BinaryCodec::Reader& in);
+};
+
+/**
+ * Approximate distinct count (HyperLogLog, 2^12 registers, ~1.6% error)
+ * Insert-only: a value that goes away is still counted. Merging takes
+ * the larger of each register pair.
+ */
+class DistinctCounter {
+public:
+    static const int PRECISION = 12;
+
+private:
+    std::vector<uint8_t> registers;
+
+public:
+    DistinctCounter();
+
+    void add(const std::string& value);
+    void merge(const DistinctCounter& other);
+    double estimate() const;
+
+    void encode(std::string& out) const;
+    static DistinctCounter decode(BinaryCodec::Reader& in);
+};
+
+/**
+ * Age and weight distributions and distinct names for one species
+ */
+struct SpeciesSketch {
+    QuantileSketch ages;
+    QuantileSketch weights;
+    DistinctCounter names;
+
+    void merge(const SpeciesSketch& other);
+};
+
+/**
+ * Sketches per species, for dashboards over many animals or many zoos
+ * Sketches from different zoos merge by adding bucket counts, and encode
+ * to tens of kilobytes whatever the population, so each site can ship its
+ * own and a dashboard can combine them without touching the animals. The
+ * name counters dominate: empty registers are run-length encoded, but
+ * once a species has thousands of names its 4096 registers are mostly
+ * set, and a million-animal zoo encodes to about 50 KB.
+ */
+class PopulationSketch {
+private:
+    // One entry per SpeciesId, Unknown included
+    SpeciesSketch bySpecies[SPECIES_COUNT + 1];
+
+    SpeciesSketch& entry(SpeciesId species);
+
+public:
+    void add(SpeciesId species, int age, double weight, const std::string& name);
+    void remove(SpeciesId species, int age, double weight);
+    void changeWeight(SpeciesId species, double from, double to);
+    void changeAge(SpeciesId species, int from, int to);
+
+    PopulationSketch& merge(const PopulationSketch& other);
+
+    const SpeciesSketch& getSpecies(SpeciesId species) const;
+    // Every species merged
+    SpeciesSketch getTotal() const;
+
+    std::string encode() const;
+    // Throws InvalidOperationException on corrupt input
+    static PopulationSketch decode(const std::string& data);
+
+    // Count, distinct names and age/weight p50/p95/p99 per species
+    void print(std::ostream& out) const;
+};
+
+/**
+ * PopulationSketch kept up to date by a Zoo (see Zoo::setSketches)
+ * The zoo reports adds, removals and weight or age changes by slot. Each
+ * slot remembers the age and weight it was sketched with, so a removal
+ * takes back exactly what was added.
+ */
+class ZooSketches {
+private:
+    struct SlotState {
+        float weight;
+        uint16_t age;
+        SpeciesId species;
+    };
+
+    std::vector<SlotState> slots;
+    PopulationSketch sketch;
+
+public:
+    void onAdded(const Animal& animal, size_t slot);
+    void onRemoved(size_t slot);
+    // Weight or age changed
+    void onChanged(const Animal& animal, size_t slot);
+
+    // Slot bookkeeping, mirroring the zoo (see HealthBitmap::moveSlot)
+    void moveSlot(size_t from, size_t to);
+    void resize(size_t slotCount);
+    void clear();
+
+    const PopulationSketch& getSketch() const;
+};
+
+#endif // ZOOSKETCHES_H
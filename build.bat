@@ -13,10 +13,17 @@ if %ERRORLEVEL% EQU 0 (
     echo Found g++ compiler. Building with g++...
     echo.
     
-    g++ -std=c++11 -Wall -Wextra -o zoo_simulator.exe ^
+    g++ -std=c++17 -Wall -Wextra -o zoo_simulator.exe ^
         main.cpp Animal.cpp Mammal.cpp Bird.cpp ^
         Lion.cpp Elephant.cpp Monkey.cpp ^
-        Eagle.cpp Penguin.cpp Parrot.cpp Zoo.cpp
+        Eagle.cpp Penguin.cpp Parrot.cpp Zoo.cpp ^
+        BatchRunner.cpp HealthBitmap.cpp InternTable.cpp WordPool.cpp ZooRandom.cpp ^
+        FeedingPlanner.cpp EnclosurePlanner.cpp AnimalRecord.cpp ^
+        ColumnarExporter.cpp ZooDiff.cpp ZooArchive.cpp HistoryStore.cpp ^
+        AnomalyDetector.cpp AtomicFileWriter.cpp OperationTrace.cpp ^
+        TraceReplayer.cpp ConcurrentZoo.cpp AllocationTracker.cpp ^
+        PopulationReport.cpp ZooSketches.cpp AnimalRankings.cpp ^
+        NamePrefixIndex.cpp
     
     if %ERRORLEVEL% EQU 0 (
         echo.
@@ -44,7 +51,7 @@ if %ERRORLEVEL% EQU 0 (
     echo   - Visual Studio: Use Developer Command Prompt
     echo.
     echo Or compile manually:
-    echo   g++ -std=c++11 -o zoo_simulator.exe main.cpp Animal.cpp Mammal.cpp Bird.cpp Lion.cpp Elephant.cpp Monkey.cpp Eagle.cpp Penguin.cpp Parrot.cpp Zoo.cpp
+    echo   g++ -std=c++17 -o zoo_simulator.exe main.cpp Animal.cpp Mammal.cpp Bird.cpp Lion.cpp Elephant.cpp Monkey.cpp Eagle.cpp Penguin.cpp Parrot.cpp Zoo.cpp BatchRunner.cpp HealthBitmap.cpp InternTable.cpp WordPool.cpp ZooRandom.cpp FeedingPlanner.cpp EnclosurePlanner.cpp AnimalRecord.cpp ColumnarExporter.cpp ZooDiff.cpp ZooArchive.cpp HistoryStore.cpp AnomalyDetector.cpp AtomicFileWriter.cpp OperationTrace.cpp TraceReplayer.cpp ConcurrentZoo.cpp AllocationTracker.cpp PopulationReport.cpp ZooSketches.cpp AnimalRankings.cpp NamePrefixIndex.cpp
     echo.
     pause
 )
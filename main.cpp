@@ -9,10 +9,30 @@
 #include "AnimalFactory.h"
 #include "Enclosure.h"
 #include "Veterinarian.h"
+#include "BatchRunner.h"
+#include "ZooRandom.h"
+#include "FeedingPlanner.h"
+#include "ColumnarExporter.h"
+#include "OperationTrace.h"
+#include "TraceReplayer.h"
+#include "PopulationReport.h"
+#include <thread>
+#include <future>
 #include <iostream>
+#include <fstream>
+#include <iomanip>
 #include <limits>
 #include <cstdlib>
 #include <ctime>
+#include <string>
+#include <memory>
+#include <vector>
+
+#ifdef __linux__
+#include "ZooServer.h"
+#include "ZooLiveView.h"
+#include <csignal>
+#endif
 
 using namespace std;
 
@@ -131,6 +151,11 @@ void displayMenu() {
     cout << "14. Use Animal Factory" << endl;
     cout << "15. Manage Enclosures" << endl;
     cout << "16. Veterinarian Demo" << endl;
+    cout << "17. Treat Sick Animals" << endl;
+    cout << "18. Feeding Plan" << endl;
+    cout << "19. Export Columnar Data" << endl;
+    cout << "20. Population Report" << endl;
+    cout << "21. Top Animals (heaviest, oldest, hungriest)" << endl;
     cout << "\n0.  Exit" << endl;
     cout << "============================================" << endl;
     cout << "Enter choice: ";
@@ -190,12 +215,37 @@ void addAnimalMenu(Zoo& zoo) {
     }
 }
 
-void removeAnimalMenu(Zoo& zoo) {
-    cout << "\n=== Remove Animal ===" << endl;
-    cout << "Enter animal name: ";
+// Reads an animal name after a menu choice. An entry ending in '*' lists
+// the names starting with the rest and asks again, unless just one does.
+string readAnimalName(const Zoo& zoo) {
+    const size_t shown = 10;
     string name;
     cin.ignore();
-    getline(cin, name);
+    cout << "Enter animal name (or a prefix ending in *): ";
+    while (getline(cin, name) && !name.empty() && name.back() == '*') {
+        name.pop_back();
+        vector<string> matches = zoo.completeName(name, shown + 1);
+        if (matches.size() == 1) {
+            cout << "Using " << matches[0] << endl;
+            return matches[0];
+        }
+        if (matches.empty()) {
+            cout << "No animal name starts with \"" << name << "\"" << endl;
+        }
+        for (size_t i = 0; i < matches.size() && i < shown; ++i) {
+            cout << "  " << matches[i] << endl;
+        }
+        if (matches.size() > shown) {
+            cout << "  ..." << endl;
+        }
+        cout << "Enter animal name (or a prefix ending in *): ";
+    }
+    return name;
+}
+
+void removeAnimalMenu(Zoo& zoo) {
+    cout << "\n=== Remove Animal ===" << endl;
+    string name = readAnimalName(zoo);
     
     try {
         zoo.removeAnimal(name);
@@ -208,10 +258,7 @@ void removeAnimalMenu(Zoo& zoo) {
 
 void findAnimalMenu(Zoo& zoo) {
     cout << "\n=== Find Animal ===" << endl;
-    cout << "Enter animal name: ";
-    string name;
-    cin.ignore();
-    getline(cin, name);
+    string name = readAnimalName(zoo);
     
     try {
         IAnimal* animal = zoo.findAnimal(name);
@@ -238,10 +285,7 @@ void displayBySpeciesMenu(Zoo& zoo) {
 
 void specialCareMenu(Zoo& zoo) {
     cout << "\n=== Special Care ===" << endl;
-    cout << "Enter animal name: ";
-    string name;
-    cin.ignore();
-    getline(cin, name);
+    string name = readAnimalName(zoo);
     
     try {
         IAnimal* animal = zoo.findAnimal(name);
@@ -254,10 +298,7 @@ void specialCareMenu(Zoo& zoo) {
 
 void demonstratePolymorphismMenu(Zoo& zoo) {
     cout << "\n=== Demonstrate Polymorphism ===" << endl;
-    cout << "Enter animal name: ";
-    string name;
-    cin.ignore();
-    getline(cin, name);
+    string name = readAnimalName(zoo);
     
     try {
         IAnimal* animal = zoo.findAnimal(name);
@@ -268,30 +309,57 @@ void demonstratePolymorphismMenu(Zoo& zoo) {
     }
 }
 
-void saveToFileMenu(Zoo& zoo) {
+// Waits for the background save started by saveToFileMenu, if any
+void finishPendingSave(future<void>& pendingSave) {
+    if (!pendingSave.valid()) {
+        return;
+    }
+    try {
+        pendingSave.get();
+    }
+    catch (const exception& e) {
+        cerr << "Error: background save failed: " << e.what() << endl;
+    }
+}
+
+void saveToFileMenu(Zoo& zoo, future<void>& pendingSave) {
     cout << "\n=== Save to File ===" << endl;
     cout << "Enter filename: ";
     string filename;
     cin.ignore();
     getline(cin, filename);
     
+    cout << "Format - (1) text, (2) archive with all attributes: ";
+    string format;
+    getline(cin, format);
+
+    // One save at a time, so two saves of the same file cannot race
+    finishPendingSave(pendingSave);
     try {
-        zoo.saveToFile(filename);
+        if (format == "2") {
+            zoo.saveArchive(filename);
+        } else {
+            // The menu comes back as soon as the animals are copied
+            pendingSave = zoo.saveToFileAsync(filename);
+        }
     }
     catch (const exception& e) {
         cerr << "Error: " << e.what() << endl;
     }
 }
 
-void loadFromFileMenu(Zoo& zoo) {
+void loadFromFileMenu(Zoo& zoo, future<void>& pendingSave) {
     cout << "\n=== Load from File ===" << endl;
     cout << "Enter filename: ";
     string filename;
     cin.ignore();
     getline(cin, filename);
-    
+
+    finishPendingSave(pendingSave);
+
     try {
-        zoo.loadFromFile(filename);
+        // Archives open on demand: only the animals looked up get decoded
+        zoo.loadFromFile(filename, Zoo::LoadMode::Lazy);
     }
     catch (const exception& e) {
         cerr << "Error: " << e.what() << endl;
@@ -351,6 +419,10 @@ void enclosureMenu() {
     
     cout << "\nFood requirement: " << lionEnclosure.calculateTotalFoodRequirement() 
          << " kg" << endl;
+
+    PopulationReport report;
+    report.addEnclosure(lionEnclosure);
+    report.print(cout);
     
     cout << "\n✓ Enclosure demo complete! (Animals will be cleaned up automatically)" << endl;
 }
@@ -362,10 +434,7 @@ void veterinarianMenu(Zoo& zoo) {
     Veterinarian vet("Rodriguez", "Exotic Animals");
     
     cout << "\nSelect an animal to examine:" << endl;
-    cout << "Enter animal name: ";
-    string name;
-    cin.ignore();
-    getline(cin, name);
+    string name = readAnimalName(zoo);
     
     try {
         IAnimal* animal = zoo.findAnimal(name);
@@ -395,8 +464,287 @@ void veterinarianMenu(Zoo& zoo) {
     }
 }
 
-int main() {
-    srand(time(0)); // Seed random number generator
+// ========================================
+// NON-INTERACTIVE MODES
+// ========================================
+
+#ifdef __linux__
+ZooServer* activeServer = nullptr;
+
+void handleStopSignal(int) {
+    if (activeServer) {
+        activeServer->stop();
+    }
+}
+
+/**
+ * Serves the zoo over a Unix domain socket until SIGINT/SIGTERM
+ * With a live view name the zoo is also published to shared memory
+ */
+int runServer(const string& socketPath, int capacity, const string& liveViewName) {
+    Zoo zoo("Wildlife Paradise", capacity);
+    zoo.setVerbose(false);
+
+    try {
+        unique_ptr<LiveViewPublisher> liveView;
+        ZooServer server(zoo, socketPath);
+        if (!liveViewName.empty()) {
+            liveView.reset(new LiveViewPublisher(liveViewName, static_cast<uint32_t>(max(capacity, 0))));
+            server.setLiveView(liveView.get(), chrono::milliseconds(100));
+            cerr << "Publishing live view " << liveView->getSegmentName() << endl;
+        }
+        activeServer = &server;
+        signal(SIGINT, handleStopSignal);
+        signal(SIGTERM, handleStopSignal);
+        server.run();
+        activeServer = nullptr;
+    }
+    catch (const exception& e) {
+        activeServer = nullptr;
+        cerr << "Server error: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * Prints the latest snapshot of a live view published by --server --live
+ */
+int runLiveView(const string& name, int rowLimit) {
+    try {
+        LiveViewReader reader(name);
+        LiveSnapshot snapshot;
+        if (!reader.snapshot(snapshot)) {
+            cout << "Nothing published yet" << endl;
+            return 0;
+        }
+
+        const LiveAggregates& totals = snapshot.totals;
+        cout << snapshot.zooName << " (version " << totals.version << ")" << endl;
+        cout << "Animals: " << totals.animalCount << "  sick: " << totals.sickCount << endl;
+        cout << fixed << setprecision(1)
+             << "Total weight: " << totals.totalWeight << " kg  food: "
+             << totals.totalFood << " kg/day" << endl;
+        for (int s = 0; s < SPECIES_COUNT; ++s) {
+            if (totals.speciesCount[s] > 0) {
+                cout << "  " << left << setw(10) << speciesName(static_cast<SpeciesId>(s))
+                     << right << totals.speciesCount[s] << endl;
+            }
+        }
+        size_t shown = min(snapshot.rows.size(), static_cast<size_t>(max(rowLimit, 0)));
+        for (size_t i = 0; i < shown; ++i) {
+            const LiveAnimalRow& row = snapshot.rows[i];
+            cout << "  " << row.name << ' ' << speciesName(row.getSpeciesId())
+                 << " age=" << row.age << " weight=" << row.weight
+                 << (row.healthy ? " healthy" : " sick") << endl;
+        }
+        if (totals.rowCount < totals.animalCount) {
+            cout << "(view holds " << totals.rowCount << " of "
+                 << totals.animalCount << " animals)" << endl;
+        }
+    }
+    catch (const exception& e) {
+        cerr << "Live view error: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
+#endif
+
+/**
+ * Runs a command script from a file ("-" for stdin) without prompts
+ * Timing per command goes to stderr so stdout stays machine-readable
+ */
+int runBatch(const string& scriptPath, int capacity, const string& tracePath) {
+    ios::sync_with_stdio(false);
+
+    ifstream scriptFile;
+    if (scriptPath != "-") {
+        scriptFile.open(scriptPath);
+        if (!scriptFile) {
+            cerr << "Cannot open script: " << scriptPath << endl;
+            return 1;
+        }
+    }
+    istream& script = scriptPath == "-" ? cin : scriptFile;
+
+    Zoo zoo("Wildlife Paradise", capacity);
+    zoo.setVerbose(false);
+
+    unique_ptr<OperationRecorder> recorder;
+    if (!tracePath.empty()) {
+        try {
+            recorder.reset(new OperationRecorder(tracePath));
+        } catch (const exception& e) {
+            cerr << "Error: " << e.what() << endl;
+            return 1;
+        }
+        zoo.setRecorder(recorder.get());
+    }
+
+    BatchRunner runner(zoo);
+    unsigned long long failures = runner.run(script);
+    runner.printTimings(cerr);
+
+    if (recorder) {
+        zoo.setRecorder(nullptr);
+        recorder->flush();
+        cerr << "Recorded " << recorder->getEventCount() << " calls ("
+             << recorder->getByteCount() << " bytes) to " << tracePath << endl;
+    }
+    return failures == 0 ? 0 : 1;
+}
+
+int runReplay(const string& tracePath, const string& pace) {
+    try {
+        TraceReplayer replayer(tracePath);
+        TraceReplayer::Pacing pacing = pace == "recorded"
+            ? TraceReplayer::Pacing::Recorded : TraceReplayer::Pacing::Fastest;
+        vector<TraceReplayer::OpStats> stats = replayer.run(pacing);
+        TraceReplayer::printReport(cout, stats);
+        if (const Zoo* zoo = replayer.getZoo()) {
+            cout << "Final zoo: " << zoo->getAnimalCount() << " animals, "
+                 << zoo->getSickCount() << " needing attention" << endl;
+        }
+        return 0;
+    }
+    catch (const exception& e) {
+        cerr << "Error: " << e.what() << endl;
+        return 1;
+    }
+}
+
+void printUsage(const char* program) {
+    cerr << "Usage: " << program << "                 (interactive menu)" << endl;
+    cerr << "       " << program << " --batch FILE|- [--capacity N] [--record TRACE]" << endl;
+    cerr << "       " << program << " --replay TRACE [--pace fastest|recorded]" << endl;
+#ifdef __linux__
+    cerr << "       " << program << " --server PATH [--capacity N] [--live NAME]" << endl;
+    cerr << "       " << program << " --live-view NAME [--rows N]" << endl;
+#endif
+    BatchRunner::printCommands(cerr);
+}
+
+void treatSickAnimalsMenu(Zoo& zoo) {
+    cout << "\n=== Treat Sick Animals ===" << endl;
+    cout << "Animals needing attention: " << zoo.getSickCount()
+         << " of " << zoo.getAnimalCount() << endl;
+    if (zoo.getSickCount() == 0) {
+        return;
+    }
+
+    Veterinarian vet("Rodriguez", "Exotic Animals");
+    int treated = zoo.dispatchVeterinarian(vet);
+    cout << "\nTreated " << treated << " animal(s); "
+         << zoo.getSickCount() << " still need attention." << endl;
+}
+
+void feedingPlanMenu(Zoo& zoo) {
+    cout << "\n=== Feeding Plan ===" << endl;
+    cout << "Enter number of days to plan for: ";
+    int days;
+    cin >> days;
+    if (cin.fail() || days <= 0) {
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        cout << "Invalid number of days!" << endl;
+        return;
+    }
+
+    FeedingPlanner planner;
+    planner.addZoo(zoo);
+    FoodInventory stock;
+    planner.printPlan(cout, stock, days);
+}
+
+void exportColumnarMenu(Zoo& zoo) {
+    cout << "\n=== Export Columnar Data ===" << endl;
+    cout << "Enter filename: ";
+    string filename;
+    cin.ignore();
+    getline(cin, filename);
+
+    try {
+        ColumnarExporter exporter(ColumnarExporter::DEFAULT_ROW_GROUP_SIZE,
+                                  max(1u, thread::hardware_concurrency()));
+        ColumnarExporter::ExportStats stats = exporter.exportZoo(zoo, filename);
+        cout << "Exported " << stats.rows << " animals in " << stats.rowGroups
+             << " row group(s), " << stats.bytes << " bytes" << endl;
+        ColumnarExporter::describe(filename, cout);
+    }
+    catch (const exception& e) {
+        cerr << "Error: " << e.what() << endl;
+    }
+}
+
+void topAnimalsMenu(Zoo& zoo) {
+    cout << "\n=== Top Animals ===" << endl;
+    cout << "Rank by (1 = weight, 2 = age, 3 = food): ";
+    int choice;
+    size_t k;
+    cin >> choice;
+    cout << "How many: ";
+    cin >> k;
+    if (cin.fail() || choice < 1 || choice > 3) {
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        cout << "Invalid choice!" << endl;
+        return;
+    }
+
+    RankBy by = static_cast<RankBy>(choice - 1);
+    int place = 1;
+    for (const Animal* animal : zoo.topAnimals(by, k)) {
+        cout << setw(3) << place++ << ". " << animal->getName() << " (" << animal->getSpecies()
+             << "): " << animal->getWeight() << " kg, " << animal->getAge() << " years, "
+             << animal->calculateFoodRequirement() << " kg food/day" << endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1) {
+        string mode = argv[1];
+        int capacity = 100000;
+        int rows = 10;
+        string liveViewName;
+        string tracePath;
+        string pace = "fastest";
+        for (int i = 3; i + 1 < argc; i += 2) {
+            if (string(argv[i]) == "--capacity") {
+                capacity = atoi(argv[i + 1]);
+            }
+            else if (string(argv[i]) == "--live") {
+                liveViewName = argv[i + 1];
+            }
+            else if (string(argv[i]) == "--rows") {
+                rows = atoi(argv[i + 1]);
+            }
+            else if (string(argv[i]) == "--record") {
+                tracePath = argv[i + 1];
+            }
+            else if (string(argv[i]) == "--pace") {
+                pace = argv[i + 1];
+            }
+        }
+        if (mode == "--batch" && argc >= 3) {
+            return runBatch(argv[2], capacity, tracePath);
+        }
+        if (mode == "--replay" && argc >= 3) {
+            return runReplay(argv[2], pace);
+        }
+#ifdef __linux__
+        if (mode == "--server" && argc >= 3) {
+            return runServer(argv[2], capacity, liveViewName);
+        }
+        if (mode == "--live-view" && argc >= 3) {
+            return runLiveView(argv[2], rows);
+        }
+#endif
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    ZooRandom::seed(time(0)); // Seed random number generator
     
     cout << "========================================" << endl;
     cout << "  Wildlife Sanctuary Simulator" << endl;
@@ -416,6 +764,7 @@ int main() {
     }
     
     // Main menu loop
+    future<void> pendingSave;
     int menuChoice;
     do {
         displayMenu();
@@ -448,7 +797,8 @@ int main() {
                 myZoo.performDailyCheckups();
                 break;
             case 7:
-                cout << "\nTotal food required: " << myZoo.calculateTotalFoodRequirement() 
+                cout << "\nTotal food required: "
+                     << myZoo.calculateTotalFoodRequirement(max(1u, thread::hardware_concurrency()))
                      << " kg" << endl;
                 break;
             case 8:
@@ -464,10 +814,10 @@ int main() {
                 demonstratePolymorphismMenu(myZoo);
                 break;
             case 12:
-                saveToFileMenu(myZoo);
+                saveToFileMenu(myZoo, pendingSave);
                 break;
             case 13:
-                loadFromFileMenu(myZoo);
+                loadFromFileMenu(myZoo, pendingSave);
                 break;
             case 14:
                 animalFactoryMenu(myZoo);
@@ -478,7 +828,26 @@ int main() {
             case 16:
                 veterinarianMenu(myZoo);
                 break;
+            case 17:
+                treatSickAnimalsMenu(myZoo);
+                break;
+            case 18:
+                feedingPlanMenu(myZoo);
+                break;
+            case 19:
+                exportColumnarMenu(myZoo);
+                break;
+            case 20: {
+                PopulationReport report;
+                report.addZoo(myZoo, max(1u, thread::hardware_concurrency()));
+                report.print(cout);
+                break;
+            }
+            case 21:
+                topAnimalsMenu(myZoo);
+                break;
             case 0:
+                finishPendingSave(pendingSave);
                 cout << "\nThank you for visiting Wildlife Paradise!" << endl;
                 cout << "Goodbye!" << endl;
                 break;
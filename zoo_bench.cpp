@@ -0,0 +1,1749 @@
+/**
+ * Benchmarks and memory reports for the zoo data structures
+ *
+ * Usage: zoo_bench <report> [animals]
+ * Run without arguments to list the available reports.
+ */
+#include "Lion.h"
+#include "Elephant.h"
+#include "Monkey.h"
+#include "Eagle.h"
+#include "Penguin.h"
+#include "Parrot.h"
+#include "InternTable.h"
+#include "WordPool.h"
+#include "ZooRandom.h"
+#include "Zoo.h"
+#include "FeedingPlanner.h"
+#include "EnclosurePlanner.h"
+#include "MixedEnclosure.h"
+#include "ColumnarExporter.h"
+#include "ZooDiff.h"
+#include "ZooArchive.h"
+#include "ZooLiveView.h"
+#include "HistoryStore.h"
+#include "AnomalyDetector.h"
+#include "Veterinarian.h"
+#include "Exceptions.h"
+#include "AnimalFactory.h"
+#include "OperationTrace.h"
+#include "TraceReplayer.h"
+#include "AllocationTracker.h"
+#include "Enclosure.h"
+#include "PopulationReport.h"
+#include "ZooSketches.h"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <cstdlib>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <atomic>
+#include <algorithm>
+#include <future>
+#include <iterator>
+#include <cstring>
+
+using namespace std;
+typedef chrono::steady_clock Clock;
+
+namespace {
+
+const char* FUR_COLORS[] = { "Golden", "Tan", "Gray", "Brown", "Black" };
+const char* MONKEY_TYPES[] = { "Capuchin", "Spider Monkey", "Howler", "Squirrel Monkey" };
+const char* PENGUIN_TYPES[] = { "Emperor", "Adelie", "King", "Gentoo" };
+const char* BEAK_TYPES[] = { "Hooked", "Curved", "Small", "Straight" };
+const char* PLUMAGE[] = { "Green", "Blue", "Scarlet", "Yellow and Blue" };
+
+/**
+ * Builds a realistic mix of all six species with repeating attributes
+ */
+vector<Animal*> makeAnimals(size_t count) {
+    vector<Animal*> animals;
+    animals.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        string name = "Animal_" + to_string(i);
+        int age = 1 + static_cast<int>(i % 30);
+        double weight = 5.0 + static_cast<double>(i % 400);
+        switch (i % 6) {
+            case 0:
+                animals.push_back(new Lion(name, age, weight, true, FUR_COLORS[i % 2], 110, 20, i % 7 == 0));
+                break;
+            case 1:
+                animals.push_back(new Elephant(name, age, weight * 10, false, FUR_COLORS[2], 660, 1.5, 100, true));
+                break;
+            case 2:
+                animals.push_back(new Monkey(name, age, weight / 20, true, FUR_COLORS[i % 5], 160, 50, true,
+                                             MONKEY_TYPES[i % 4]));
+                break;
+            case 3:
+                animals.push_back(new Eagle(name, age, 5, 2.0, true, BEAK_TYPES[0], 7.0, 3000, i % 2 == 0));
+                break;
+            case 4:
+                animals.push_back(new Penguin(name, age, 12, 0.4, false, BEAK_TYPES[2], 8, 150,
+                                              PENGUIN_TYPES[i % 4]));
+                break;
+            default:
+                animals.push_back(new Parrot(name, age, 1.2, 0.5, true, BEAK_TYPES[1], PLUMAGE[i % 4], 8));
+                break;
+        }
+    }
+    return animals;
+}
+
+void destroyAnimals(vector<Animal*>& animals) {
+    for (Animal* animal : animals) {
+        delete animal;
+    }
+    animals.clear();
+}
+
+// Bytes a plain std::string holding text costs (object plus heap block)
+size_t plainStringCost(const string& text) {
+    static const size_t inlineCapacity = string().capacity();
+    return sizeof(string) + (text.size() > inlineCapacity ? text.size() + 1 : 0);
+}
+
+/**
+ * Memory saved by interning repeated attribute strings
+ * Compares the per-field cost of a private std::string copy against one
+ * InternedString handle, and the allocations getSpecies() used to make.
+ */
+int reportIntern(size_t count) {
+    vector<Animal*> animals = makeAnimals(count);
+
+    size_t plainBytes = 0;
+    size_t internedBytes = 0;
+    size_t fields = 0;
+    size_t speciesAllocations = 0;
+    static const size_t inlineCapacity = string().capacity();
+
+    for (const Animal* animal : animals) {
+        vector<const string*> values;
+        if (const Mammal* mammal = dynamic_cast<const Mammal*>(animal)) {
+            values.push_back(&mammal->getFurColor());
+        }
+        if (const Bird* bird = dynamic_cast<const Bird*>(animal)) {
+            values.push_back(&bird->getBeakType());
+        }
+        if (const Parrot* parrot = dynamic_cast<const Parrot*>(animal)) {
+            values.push_back(&parrot->getPlumageColor());
+        }
+        if (dynamic_cast<const Monkey*>(animal) || dynamic_cast<const Penguin*>(animal)) {
+            // Sub-species name plus the cached "Monkey (...)" label; the
+            // label used to be rebuilt (and often heap-allocated) per call
+            const string& label = animal->getSpecies();
+            size_t prefix = label.find('(');
+            string subSpecies = label.substr(prefix + 1, label.size() - prefix - 2);
+            plainBytes += plainStringCost(subSpecies);
+            internedBytes += 2 * sizeof(InternedString);
+            ++fields;
+            if (label.size() > inlineCapacity) {
+                ++speciesAllocations;
+            }
+        }
+        for (const string* value : values) {
+            plainBytes += plainStringCost(*value);
+            internedBytes += sizeof(InternedString);
+            ++fields;
+        }
+    }
+    size_t tableBytes = InternTable::global().memoryUsage();
+
+    Clock::time_point start = Clock::now();
+    size_t checksum = 0;
+    for (const Animal* animal : animals) {
+        checksum += animal->getSpecies().size();
+    }
+    chrono::duration<double, nano> scan = Clock::now() - start;
+
+    double perMillion = 1e6 / static_cast<double>(count);
+    double saved = (static_cast<double>(plainBytes) - internedBytes - tableBytes) * perMillion;
+
+    cout << "=== String Interning Report (" << count << " animals) ===" << endl;
+    cout << "Interned attribute fields:   " << fields << endl;
+    cout << "Distinct interned strings:   " << InternTable::global().size()
+         << " (" << tableBytes << " bytes, shared)" << endl;
+    cout << fixed << setprecision(2);
+    cout << "Bytes per animal, std::string: " << static_cast<double>(plainBytes) / count << endl;
+    cout << "Bytes per animal, interned:    " << static_cast<double>(internedBytes) / count << endl;
+    cout << "Saved per million animals:     " << saved / (1024.0 * 1024.0) << " MiB" << endl;
+    cout << "getSpecies() heap allocations avoided per full scan: " << speciesAllocations << endl;
+    cout << "getSpecies() cost now: " << scan.count() / count << " ns/call"
+         << " (checksum " << checksum << ")" << endl;
+
+    destroyAnimals(animals);
+    return 0;
+}
+
+/**
+ * Parrot vocabularies from the shared word pool and per-thread RNG
+ * Runs the same seeded simulation twice on several threads and checks
+ * that the results match, then reports throughput and vocabulary memory.
+ */
+int reportParrot(size_t count) {
+    const unsigned threads = max(2u, thread::hardware_concurrency());
+    const char* extraWords[] = { "Cracker!", "Good morning!", "Bye bye!", "Who's a good bird?" };
+
+    vector<Parrot*> parrots;
+    parrots.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        Parrot* parrot = new Parrot("Parrot_" + to_string(i), 3, 1.0, 0.5, true, "Curved", "Green", 8);
+        parrots.push_back(parrot);
+    }
+    // Teach a few parrots some words, quietly
+    streambuf* console = cout.rdbuf(nullptr);
+    for (size_t i = 0; i < count; i += 10) {
+        parrots[i]->learnWord(extraWords[i % 4]);
+    }
+    cout.rdbuf(console);
+
+    auto simulate = [&](vector<uint64_t>& checksums) {
+        vector<thread> workers;
+        for (unsigned t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t]() {
+                ZooRandom::seedThread(1234 + t);
+                uint64_t sum = 0;
+                for (size_t i = t; i < parrots.size(); i += threads) {
+                    const Parrot* parrot = parrots[i];
+                    sum = sum * 31 + parrot->getWord(ZooRandom::below(parrot->getVocabularySize())).size();
+                }
+                checksums[t] = sum;
+            });
+        }
+        for (thread& worker : workers) {
+            worker.join();
+        }
+    };
+
+    vector<uint64_t> first(threads), second(threads);
+    Clock::time_point start = Clock::now();
+    simulate(first);
+    chrono::duration<double> elapsed = Clock::now() - start;
+    simulate(second);
+
+    // Old layout: a vector of two std::string copies per parrot
+    size_t oldBytes = sizeof(vector<string>) + 2 * sizeof(string);
+    size_t newBytes = sizeof(vector<WordPool::WordId>);
+
+    cout << "=== Parrot Vocabulary Report (" << count << " parrots, "
+         << threads << " threads) ===" << endl;
+    cout << "Shared word pool size:        " << WordPool::global().size() << " words" << endl;
+    cout << "Vocabulary bytes per parrot:  " << oldBytes << " -> " << newBytes
+         << " (+4 per learned word)" << endl;
+    cout << "Parallel talk throughput:     "
+         << static_cast<long>(count / elapsed.count()) << " words/s" << endl;
+    cout << "Reproducible across runs:     " << (first == second ? "yes" : "NO") << endl;
+
+    for (Parrot* parrot : parrots) {
+        delete parrot;
+    }
+    return first == second ? 0 : 1;
+}
+
+// Heap footprint of one allocation of size bytes (glibc-style chunking)
+size_t allocationFootprint(size_t size) {
+    size_t chunk = (size + sizeof(size_t) + 15) & ~size_t(15);
+    return chunk < 32 ? 32 : chunk;
+}
+
+template <typename T>
+void printLayout(const char* species) {
+    cout << "  " << left << setw(10) << species << right
+         << setw(8) << sizeof(T) << setw(10) << allocationFootprint(sizeof(T))
+         << setw(14) << (sizeof(T) + 63) / 64 << endl;
+}
+
+/**
+ * Object sizes per species and the cost of a full-zoo scan over the hot
+ * fields (age, weight, health)
+ */
+int reportLayout(size_t count) {
+    cout << "=== Animal Layout Report ===" << endl;
+    cout << "  " << left << setw(10) << "species" << right
+         << setw(8) << "sizeof" << setw(10) << "on heap" << setw(14) << "cache lines" << endl;
+    printLayout<Lion>("Lion");
+    printLayout<Elephant>("Elephant");
+    printLayout<Monkey>("Monkey");
+    printLayout<Eagle>("Eagle");
+    printLayout<Penguin>("Penguin");
+    printLayout<Parrot>("Parrot");
+    cout << "  sizeof(Animal) = " << sizeof(Animal) << endl;
+
+    vector<Animal*> animals = makeAnimals(count);
+    size_t heapBytes = 0;
+    for (const Animal* animal : animals) {
+        size_t objectSize = 0;
+        if (dynamic_cast<const Lion*>(animal)) objectSize = sizeof(Lion);
+        else if (dynamic_cast<const Elephant*>(animal)) objectSize = sizeof(Elephant);
+        else if (dynamic_cast<const Monkey*>(animal)) objectSize = sizeof(Monkey);
+        else if (dynamic_cast<const Eagle*>(animal)) objectSize = sizeof(Eagle);
+        else if (dynamic_cast<const Penguin*>(animal)) objectSize = sizeof(Penguin);
+        else objectSize = sizeof(Parrot);
+        heapBytes += allocationFootprint(objectSize);
+    }
+
+    // Shuffle the visiting order so the scan is not helped by allocation order
+    vector<Animal*> order = animals;
+    ZooRandom::seedThread(42);
+    for (size_t i = order.size(); i > 1; --i) {
+        swap(order[i - 1], order[ZooRandom::below(i)]);
+    }
+
+    const int rounds = 5;
+    double best = 1e300;
+    double checksum = 0.0;
+    for (int round = 0; round < rounds; ++round) {
+        Clock::time_point start = Clock::now();
+        double weight = 0.0;
+        long ages = 0;
+        long sick = 0;
+        for (const Animal* animal : order) {
+            weight += animal->getWeight();
+            ages += animal->getAge();
+            sick += animal->getHealthStatus() ? 0 : 1;
+        }
+        chrono::duration<double, nano> elapsed = Clock::now() - start;
+        best = min(best, elapsed.count());
+        checksum += weight + ages + sick;
+    }
+
+    cout << fixed << setprecision(2);
+    cout << "Heap bytes per animal (objects only): "
+         << static_cast<double>(heapBytes) / count << endl;
+    cout << "Per million animals:                  "
+         << heapBytes * (1e6 / count) / (1024.0 * 1024.0) << " MiB" << endl;
+    cout << "Hot-field scan, random order:         " << best / count << " ns/animal"
+         << " (checksum " << checksum << ")" << endl;
+
+    destroyAnimals(animals);
+    return 0;
+}
+
+// Zoo holding the makeAnimals() mix, without per-animal logging
+Zoo* makeZoo(size_t count) {
+    Zoo* zoo = new Zoo("Benchmark Zoo", static_cast<int>(count));
+    zoo->setVerbose(false);
+    for (Animal* animal : makeAnimals(count)) {
+        zoo->addAnimal(animal);
+    }
+    return zoo;
+}
+
+/**
+ * Diet-aware planning and 90-day procurement over a large zoo, then one
+ * day of parallel feeding drawing from a shared lock-free inventory
+ */
+int reportFeeding(size_t count) {
+    Zoo* zoo = makeZoo(count);
+    const unsigned threads = max(2u, thread::hardware_concurrency());
+
+    Clock::time_point start = Clock::now();
+    FeedingPlanner planner;
+    planner.addZoo(*zoo);
+    FoodInventory stock;
+    vector<FeedingPlanner::ProcurementLine> order = planner.projectProcurement(stock, 90);
+    chrono::duration<double, milli> planTime = Clock::now() - start;
+
+    // Stock exactly one day of food, then feed everyone in parallel
+    const FoodAmounts& daily = planner.getTotals();
+    for (int i = 0; i < FOOD_TYPE_COUNT; ++i) {
+        stock.restock(static_cast<FoodType>(i), daily.kg[i] * 1.001);
+    }
+    start = Clock::now();
+    FeedingPlanner::FeedingResult fed = FeedingPlanner::feedInParallel(*zoo, stock, threads);
+    chrono::duration<double, milli> feedTime = Clock::now() - start;
+
+    cout << "=== Feeding Planner Report (" << count << " animals) ===" << endl;
+    cout << fixed << setprecision(1);
+    for (const FeedingPlanner::ProcurementLine& line : order) {
+        cout << "  " << left << setw(14) << foodTypeName(line.food) << right
+             << setw(14) << line.dailyKg << " kg/day" << setw(16) << line.toOrderKg
+             << " kg for 90 days" << endl;
+    }
+    cout << setprecision(2);
+    cout << "Plan + 90-day projection:   " << planTime.count() << " ms" << endl;
+    cout << "Parallel feeding (" << threads << " threads): " << feedTime.count() << " ms, "
+         << fed.animalsFed << " fed, " << fed.shortages << " shortages" << endl;
+
+    delete zoo;
+    return 0;
+}
+
+/**
+ * Bin packing of a large zoo into enclosures with head-count and weight
+ * limits (10k enclosures for 1M animals)
+ */
+int reportPacking(size_t count) {
+    Zoo* zoo = makeZoo(count);
+    const unsigned threads = max(2u, thread::hardware_concurrency());
+
+    // Per species: average weight from the sample mix, ~10% spare room
+    const double averageWeight[] = { 204.5, 2045.0, 10.2, 5.0, 12.0, 1.2 };
+    const int capacity = 110;
+    size_t perSpecies = max<size_t>(1, count / 600);
+    vector<EnclosureSpec> specs;
+    for (int s = 0; s < SPECIES_COUNT; ++s) {
+        SpeciesId species = static_cast<SpeciesId>(s);
+        for (size_t i = 0; i < perSpecies; ++i) {
+            EnclosureSpec spec = { string(speciesName(species)) + " Habitat " + to_string(i + 1),
+                                   species, capacity, averageWeight[s] * 100 };
+            specs.push_back(spec);
+        }
+    }
+
+    EnclosurePlanner planner(specs);
+    Clock::time_point start = Clock::now();
+    EnclosurePlan plan = planner.plan(*zoo, threads);
+    chrono::duration<double, milli> elapsed = Clock::now() - start;
+
+    // Validate every constraint
+    size_t placed = 0;
+    bool valid = true;
+    for (size_t i = 0; i < specs.size(); ++i) {
+        placed += plan.members[i].size();
+        valid = valid && static_cast<int>(plan.members[i].size()) <= specs[i].capacity
+                && plan.totalWeight[i] <= specs[i].maxTotalWeight + 1e-6;
+        for (const Animal* animal : plan.members[i]) {
+            valid = valid && animal->getSpeciesId() == specs[i].species;
+        }
+    }
+
+    cout << "=== Enclosure Packing Report (" << count << " animals, "
+         << specs.size() << " enclosures, " << threads << " threads) ===" << endl;
+    cout << "Placed:          " << placed << endl;
+    cout << "Unassigned:      " << plan.unassigned.size() << endl;
+    cout << "Enclosures used: " << plan.enclosuresUsed << endl;
+    cout << "Constraints:     " << (valid ? "satisfied" : "VIOLATED") << endl;
+    cout << fixed << setprecision(1);
+    cout << "Planning time:   " << elapsed.count() << " ms" << endl;
+
+    delete zoo;
+    return valid ? 0 : 1;
+}
+
+/**
+ * Mixed-species enclosure against the Zoo's IAnimal* path
+ * Same lions and elephants, summed the way Zoo::calculateTotalFoodRequirement
+ * does it (dynamic_cast plus virtual call per pointer) versus a statically
+ * dispatched walk over Savanna's per-type arrays.
+ */
+int reportMixed(size_t count) {
+    vector<IAnimal*> pointers;
+    pointers.reserve(count);
+    Savanna savanna("Benchmark Savanna", static_cast<int>(count));
+    savanna.reserve<Lion>(count / 2 + 1);
+    savanna.reserve<Elephant>(count / 2 + 1);
+    for (size_t i = 0; i < count; ++i) {
+        string name = "Animal_" + to_string(i);
+        int age = 1 + static_cast<int>(i % 30);
+        double weight = 5.0 + static_cast<double>(i % 400);
+        if (i % 2 == 0) {
+            pointers.push_back(new Lion(name, age, weight, true, FUR_COLORS[i % 2], 110, 20, i % 7 == 0));
+            savanna.addAnimal<Lion>(name, age, weight, true, FUR_COLORS[i % 2], 110, 20, i % 7 == 0);
+        } else {
+            pointers.push_back(new Elephant(name, age, weight * 10, false, FUR_COLORS[2], 660, 1.5, 100, true));
+            savanna.addAnimal<Elephant>(name, age, weight * 10, false, FUR_COLORS[2], 660, 1.5, 100, true);
+        }
+    }
+
+    const int rounds = 5;
+    double bestPointers = 1e300;
+    double bestMixed = 1e300;
+    double pointerTotal = 0.0;
+    double mixedTotal = 0.0;
+    for (int round = 0; round < rounds; ++round) {
+        Clock::time_point start = Clock::now();
+        double total = 0.0;
+        for (const IAnimal* animal : pointers) {
+            const Animal* a = dynamic_cast<const Animal*>(animal);
+            if (a) {
+                total += a->calculateFoodRequirement();
+            }
+        }
+        chrono::duration<double, nano> elapsed = Clock::now() - start;
+        bestPointers = min(bestPointers, elapsed.count());
+        pointerTotal = total;
+
+        start = Clock::now();
+        total = savanna.calculateTotalFoodRequirement();
+        elapsed = Clock::now() - start;
+        bestMixed = min(bestMixed, elapsed.count());
+        mixedTotal = total;
+    }
+
+    cout << "=== Mixed Enclosure Report (" << count << " lions and elephants) ===" << endl;
+    cout << fixed << setprecision(2);
+    cout << "IAnimal* vector:     " << bestPointers / count << " ns/animal" << endl;
+    cout << "Savanna (per-type):  " << bestMixed / count << " ns/animal" << endl;
+    cout << "Speedup:             " << bestPointers / bestMixed << "x" << endl;
+    cout << "Food totals match:   " << (abs(pointerTotal - mixedTotal) < 1e-6 * pointerTotal ? "yes" : "NO") << endl;
+
+    for (IAnimal* animal : pointers) {
+        delete animal;
+    }
+    return 0;
+}
+
+/**
+ * Columnar export of a large zoo: throughput, file size against the
+ * text save, and the footer statistics read back from the file
+ */
+int reportColumnar(size_t count) {
+    Zoo* zoo = makeZoo(count);
+    const unsigned threads = max(2u, thread::hardware_concurrency());
+    const string columnarPath = "zoo_bench_export.zcol";
+    const string textPath = "zoo_bench_export.txt";
+
+    Clock::time_point start = Clock::now();
+    zoo->saveToFile(textPath);
+    chrono::duration<double, milli> textTime = Clock::now() - start;
+
+    ColumnarExporter singleThreaded(ColumnarExporter::DEFAULT_ROW_GROUP_SIZE, 1);
+    start = Clock::now();
+    singleThreaded.exportZoo(*zoo, columnarPath);
+    chrono::duration<double, milli> singleTime = Clock::now() - start;
+
+    ColumnarExporter exporter(ColumnarExporter::DEFAULT_ROW_GROUP_SIZE, threads);
+    start = Clock::now();
+    ColumnarExporter::ExportStats stats = exporter.exportZoo(*zoo, columnarPath);
+    chrono::duration<double, milli> parallelTime = Clock::now() - start;
+
+    ifstream text(textPath, ios::binary | ios::ate);
+    long long textBytes = static_cast<long long>(text.tellg());
+
+    cout << "=== Columnar Export Report (" << count << " animals) ===" << endl;
+    cout << fixed << setprecision(1);
+    cout << "Text save:            " << textTime.count() << " ms, " << textBytes << " bytes (base fields only)" << endl;
+    cout << "Columnar, 1 thread:   " << singleTime.count() << " ms" << endl;
+    cout << "Columnar, " << threads << " threads:  " << parallelTime.count() << " ms, "
+         << stats.bytes << " bytes, " << stats.rowGroups << " row groups" << endl;
+    cout.unsetf(ios::floatfield);
+    ColumnarExporter::describe(columnarPath, cout);
+
+    remove(columnarPath.c_str());
+    remove(textPath.c_str());
+    delete zoo;
+    return stats.rows == count ? 0 : 1;
+}
+
+/**
+ * Diff of two large zoo states and merge of the delta
+ * The second zoo drops every 10000th animal, reweighs every 5000th and
+ * gains a few newcomers.
+ */
+int reportDiff(size_t count) {
+    const unsigned threads = max(2u, thread::hardware_concurrency());
+    Zoo* before = makeZoo(count);
+    Zoo* after = new Zoo("Benchmark Zoo", static_cast<int>(count));
+    after->setVerbose(false);
+    vector<Animal*> animals = makeAnimals(count);
+    for (size_t i = 0; i < animals.size(); ++i) {
+        if (i % 10000 == 7) {
+            delete animals[i];
+            continue;
+        }
+        if (i % 5000 == 3) {
+            animals[i]->setWeight(animals[i]->getWeight() + 1.5);
+        }
+        after->addAnimal(animals[i]);
+    }
+    size_t newcomers = count / 20000;
+    for (size_t i = 0; i < newcomers; ++i) {
+        after->addAnimal(new Lion("Newcomer_" + to_string(i), 2, 120, true, "Tan", 110, 15, false));
+    }
+
+    Clock::time_point start = Clock::now();
+    ZooSnapshot old = ZooSnapshot::fromZoo(*before, threads);
+    ZooSnapshot now = ZooSnapshot::fromZoo(*after, threads);
+    chrono::duration<double, milli> snapshotTime = Clock::now() - start;
+
+    start = Clock::now();
+    ZooDelta delta = ZooDiff::compare(old, now, threads);
+    chrono::duration<double, milli> compareTime = Clock::now() - start;
+
+    start = Clock::now();
+    delta.apply(*before);
+    chrono::duration<double, milli> applyTime = Clock::now() - start;
+
+    ZooDelta remaining = ZooDiff::compare(ZooSnapshot::fromZoo(*before, threads),
+                                          ZooSnapshot::fromZoo(*after, threads), threads);
+
+    cout << "=== Zoo Diff Report (" << count << " animals, " << threads << " threads) ===" << endl;
+    delta.print(cout, 3);
+    cout << fixed << setprecision(1);
+    cout << "Snapshots (both): " << snapshotTime.count() << " ms" << endl;
+    cout << "Compare:          " << compareTime.count() << " ms" << endl;
+    cout << "Apply delta:      " << applyTime.count() << " ms" << endl;
+    cout << "After merge:      " << (remaining.empty() ? "identical" : "STILL DIFFERENT") << endl;
+
+    delete before;
+    delete after;
+    return remaining.empty() ? 0 : 1;
+}
+
+/**
+ * Archive round trip: save, lazy open, random lookups that decode animals
+ * into the zoo, repeat lookups, and a full eager load for comparison
+ */
+int reportArchive(size_t count) {
+    const string path = "zoo_bench_archive.zarc";
+    Zoo* zoo = makeZoo(count);
+    Clock::time_point start = Clock::now();
+    zoo->saveArchive(path);
+    chrono::duration<double, milli> saveTime = Clock::now() - start;
+    delete zoo;
+
+    Zoo lazy("Lazy", 1);
+    lazy.setVerbose(false);
+    start = Clock::now();
+    lazy.loadFromFile(path, Zoo::LoadMode::Lazy);
+    chrono::duration<double, milli> openTime = Clock::now() - start;
+
+    const size_t lookups = 10000;
+    ZooRandom::seedThread(7);
+    vector<string> names;
+    for (size_t i = 0; i < lookups; ++i) {
+        names.push_back("Animal_" + to_string(ZooRandom::below(count)));
+    }
+    start = Clock::now();
+    size_t found = 0;
+    for (const string& name : names) {
+        found += lazy.findAnimal(name) != nullptr;
+    }
+    chrono::duration<double, micro> coldTime = Clock::now() - start;
+    start = Clock::now();
+    for (size_t i = 0; i < 1000; ++i) {
+        found += lazy.findAnimal(names[lookups - 1 - i]) != nullptr;
+    }
+    chrono::duration<double, micro> warmTime = Clock::now() - start;
+    bool exact = static_cast<size_t>(lazy.getAnimalCount()) == count;
+
+    Zoo eager("Eager", 1);
+    eager.setVerbose(false);
+    start = Clock::now();
+    eager.loadFromFile(path, Zoo::LoadMode::Eager);
+    chrono::duration<double, milli> loadTime = Clock::now() - start;
+    exact = exact && static_cast<size_t>(eager.getAnimalCount()) == count;
+
+    ifstream file(path, ios::binary | ios::ate);
+    long long bytes = static_cast<long long>(file.tellg());
+    remove(path.c_str());
+
+    cout << "=== Zoo Archive Report (" << count << " animals) ===" << endl;
+    cout << fixed << setprecision(2);
+    cout << "Archive size:        " << bytes << " bytes" << endl;
+    cout << "Save:                " << saveTime.count() << " ms" << endl;
+    cout << "Lazy open:           " << openTime.count() << " ms" << endl;
+    cout << "Lookup, first touch: " << coldTime.count() / lookups << " us" << endl;
+    cout << "Lookup, in the zoo:  " << warmTime.count() / 1000 << " us" << endl;
+    cout << "Eager load:          " << loadTime.count() << " ms" << endl;
+    cout << "Animals found:       " << found << " of " << lookups + 1000
+         << (exact ? ", counts match" : ", COUNT MISMATCH") << endl;
+    return exact && found == lookups + 1000 ? 0 : 1;
+}
+
+// Flips the health of every 97th animal, offset by round
+void toggleHealth(Zoo& zoo, int round) {
+    const vector<IAnimal*>& animals = zoo.getAnimals();
+    for (size_t i = static_cast<size_t>(round) % 97; i < animals.size(); i += 97) {
+        Animal* a = static_cast<Animal*>(animals[i]);
+        a->setHealthStatus(!a->getHealthStatus());
+    }
+}
+
+/**
+ * Shared-memory live view: publish cost, reader snapshot cost, and a
+ * reader thread taking snapshots while the zoo changes and is republished.
+ * Every snapshot must agree with itself (sick rows == sick count).
+ */
+int reportLiveView(size_t count) {
+    Zoo* zoo = makeZoo(count);
+    LiveViewPublisher publisher("zoo_bench_live", static_cast<uint32_t>(count));
+    LiveViewReader reader("zoo_bench_live");
+
+    const int rounds = 5;
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < rounds; ++i) {
+        publisher.publish(*zoo);
+    }
+    chrono::duration<double, milli> publishTime = Clock::now() - start;
+
+    LiveSnapshot snapshot;
+    start = Clock::now();
+    for (int i = 0; i < rounds; ++i) {
+        reader.snapshot(snapshot);
+    }
+    chrono::duration<double, milli> snapshotTime = Clock::now() - start;
+
+    const int totalsReads = 100000;
+    LiveAggregates totals;
+    start = Clock::now();
+    for (int i = 0; i < totalsReads; ++i) {
+        reader.readTotals(totals);
+    }
+    chrono::duration<double, nano> totalsTime = Clock::now() - start;
+
+    // Health changes between publishes; first alone, then with a
+    // dashboard thread polling the view every millisecond
+    const int busyRounds = 10;
+    start = Clock::now();
+    for (int i = 0; i < busyRounds; ++i) {
+        toggleHealth(*zoo, i);
+        publisher.publish(*zoo);
+    }
+    chrono::duration<double, milli> quietTime = Clock::now() - start;
+
+    atomic<bool> done(false);
+    size_t snapshots = 0;
+    size_t inconsistent = 0;
+    unsigned long long retries = 0;
+    thread dashboard([&]() {
+        LiveViewReader view("zoo_bench_live");
+        LiveSnapshot seen;
+        while (!done.load()) {
+            this_thread::sleep_for(chrono::milliseconds(1));
+            view.snapshot(seen);
+            size_t sick = 0;
+            for (const LiveAnimalRow& row : seen.rows) {
+                sick += row.healthy == 0;
+            }
+            inconsistent += sick != seen.totals.sickCount;
+            ++snapshots;
+        }
+        retries = view.getRetries();
+    });
+    start = Clock::now();
+    for (int i = 0; i < busyRounds; ++i) {
+        toggleHealth(*zoo, i);
+        publisher.publish(*zoo);
+    }
+    chrono::duration<double, milli> busyTime = Clock::now() - start;
+    done = true;
+    dashboard.join();
+
+    cout << "=== Live View Report (" << count << " animals) ===" << endl;
+    cout << fixed << setprecision(2);
+    cout << "Segment:             " << publisher.getSegmentName() << ", "
+         << 2 * count * sizeof(LiveAnimalRow) / (1024 * 1024) << " MB of rows" << endl;
+    cout << "Publish:             " << publishTime.count() / rounds << " ms" << endl;
+    cout << "Reader snapshot:     " << snapshotTime.count() / rounds << " ms" << endl;
+    cout << "Reader totals only:  " << totalsTime.count() / totalsReads << " ns" << endl;
+    cout << "Change + publish:    " << quietTime.count() / busyRounds << " ms alone, "
+         << busyTime.count() / busyRounds << " ms with a dashboard polling" << endl;
+    cout << "Dashboard snapshots: " << snapshots << ", " << inconsistent << " inconsistent, "
+         << retries << " retried" << endl;
+
+    delete zoo;
+    return inconsistent == 0 ? 0 : 1;
+}
+
+// Two years of daily weights (random walk) and occasional sick days
+chrono::duration<double, milli> fillHistory(HistoryStore& store, const vector<uint32_t>& ids,
+                                            int32_t firstDay, int32_t days) {
+    ZooRandom::seedThread(99);
+    vector<double> weights(ids.size(), 100.0);
+    Clock::time_point start = Clock::now();
+    for (int32_t day = firstDay; day < firstDay + days; ++day) {
+        for (size_t i = 0; i < ids.size(); ++i) {
+            weights[i] += (static_cast<double>(ZooRandom::below(201)) - 100.0) / 1000.0;
+            store.record(ids[i], day, weights[i], ZooRandom::below(50) != 0);
+        }
+    }
+    return Clock::now() - start;
+}
+
+/**
+ * History store: append throughput, bytes per daily sample, range query
+ * and rollup latency, and the same load under a budget that forces old
+ * days into monthly rollups. Uses count / 20 animals for two years.
+ */
+int reportHistory(size_t count) {
+    const int32_t days = 730;
+    const int32_t firstDay = 19000;
+    size_t animals = max<size_t>(1, count / 20);
+    vector<uint32_t> ids;
+    ids.reserve(animals);
+    for (size_t i = 0; i < animals; ++i) {
+        ids.push_back(static_cast<uint32_t>(i + 1));
+    }
+    double samples = static_cast<double>(animals) * days;
+
+    size_t usage;
+    uint64_t rawKept;
+    chrono::duration<double, milli> fillTime;
+    chrono::duration<double, micro> queryTime, rollupTime;
+    size_t queried = 0;
+    size_t months = 0;
+    {
+        HistoryStore store(size_t(1) << 40);
+        fillTime = fillHistory(store, ids, firstDay, days);
+        usage = store.getMemoryUsage();
+        rawKept = store.getRawSampleCount();
+
+        const int lookups = 1000;
+        ZooRandom::seedThread(5);
+        Clock::time_point start = Clock::now();
+        for (int i = 0; i < lookups; ++i) {
+            queried += store.query(ids[ZooRandom::below(animals)], firstDay, firstDay + days).size();
+        }
+        queryTime = (Clock::now() - start) / lookups;
+        start = Clock::now();
+        for (int i = 0; i < lookups; ++i) {
+            months += store.rollup(ids[ZooRandom::below(animals)], firstDay, firstDay + days,
+                                    HistoryStore::ROLLUP_DAYS).size();
+        }
+        rollupTime = (Clock::now() - start) / lookups;
+    }
+
+    size_t budget = usage / 2;
+    HistoryStore tight(budget);
+    chrono::duration<double, milli> tightTime = fillHistory(tight, ids, firstDay, days);
+    vector<HistoryBucket> buckets = tight.rollup(ids[0], firstDay, firstDay + days, HistoryStore::ROLLUP_DAYS);
+    uint32_t covered = 0;
+    for (const HistoryBucket& b : buckets) {
+        covered += b.days;
+    }
+
+    double perSample = static_cast<double>(usage) / samples;
+    cout << "=== History Store Report (" << animals << " animals x " << days << " days) ===" << endl;
+    cout << fixed << setprecision(2);
+    cout << "Append:              " << fillTime.count() * 1e6 / samples << " ns/sample, "
+         << rawKept << " raw samples" << endl;
+    cout << "Memory:              " << usage / (1024.0 * 1024.0) << " MB, "
+         << perSample << " bytes/sample including per-animal overhead" << endl;
+    cout << "1M animals, 1 year:  " << perSample * 365e6 / (1024.0 * 1024.0 * 1024.0) << " GB at this rate" << endl;
+    cout << "Query 2 years:       " << queryTime.count() << " us (" << queried / 1000 << " days)" << endl;
+    cout << "Monthly rollup:      " << rollupTime.count() << " us (" << months / 1000 << " months)" << endl;
+    cout << "Budget " << budget / (1024 * 1024) << " MB:       " << tight.getMemoryUsage() / (1024.0 * 1024.0)
+         << " MB used, raw from day " << tight.getRawFromDay() - firstDay << ", "
+         << tightTime.count() * 1e6 / samples << " ns/sample" << endl;
+    cout << "Rollup after budget: " << buckets.size() << " months covering " << covered
+         << " of " << days << " days" << endl;
+    return tight.getMemoryUsage() <= budget && covered == static_cast<uint32_t>(days) ? 0 : 1;
+}
+
+// Counts alerts instead of treating anything
+class AlertCounter : public IHealthObserver {
+public:
+    size_t alerts = 0;
+    void onAnimalSick(Animal*) override { ++alerts; }
+};
+
+/**
+ * Anomaly detector throughput: weight readings fed straight to the
+ * detector in slot order and in random order, then through the zoo
+ * (Animal::setWeight -> Zoo observer -> detector). Every SPIKE_EVERY-th
+ * reading is a 30% drop; readings otherwise wobble by under 1%.
+ */
+int reportAnomaly(size_t count) {
+    const size_t SPIKE_EVERY = 99991;
+    const size_t rounds = 20;
+    const size_t updates = count * rounds;
+
+    vector<float> noise(4096);
+    ZooRandom::seedThread(3);
+    for (float& n : noise) {
+        n = static_cast<float>(1.0 + (ZooRandom::unit() - 0.5) * 0.01);
+    }
+
+    auto run = [&](bool randomOrder, size_t& injected, size_t& alerts) {
+        AnomalyDetector detector;
+        AlertCounter counter;
+        detector.attach(&counter);
+        injected = 0;
+        uint64_t state = 12345;
+        Clock::time_point start = Clock::now();
+        for (size_t i = 0; i < updates; ++i) {
+            size_t slot = i % count;
+            if (randomOrder) {
+                state = state * 6364136223846793005ull + 1442695040888963407ull;
+                slot = static_cast<size_t>((state >> 33) % count);
+            }
+            double weight = 100.0 * noise[i & 4095];
+            if (i % SPIKE_EVERY == SPIKE_EVERY - 1) {
+                weight *= 0.7;
+                injected += randomOrder || i / count >= 8;
+            }
+            detector.observeWeight(nullptr, slot, weight);
+        }
+        chrono::duration<double, nano> elapsed = Clock::now() - start;
+        alerts = counter.alerts;
+        return elapsed.count() / updates;
+    };
+
+    size_t orderedInjected, orderedAlerts, randomInjected, randomAlerts;
+    double orderedNs = run(false, orderedInjected, orderedAlerts);
+    double randomNs = run(true, randomInjected, randomAlerts);
+
+    Zoo* zoo = makeZoo(count);
+    AnomalyDetector detector;
+    AlertCounter counter;
+    detector.attach(&counter);
+    zoo->setAnomalyDetector(&detector);
+    const vector<IAnimal*>& animals = zoo->getAnimals();
+    vector<double> base(count);
+    for (size_t i = 0; i < count; ++i) {
+        base[i] = static_cast<Animal*>(animals[i])->getWeight();
+    }
+    const size_t zooUpdates = count * 10;
+    Clock::time_point start = Clock::now();
+    for (size_t i = 0; i < zooUpdates; ++i) {
+        size_t slot = i % count;
+        static_cast<Animal*>(animals[slot])->setWeight(base[slot] * noise[i & 4095]);
+    }
+    chrono::duration<double, nano> zooTime = Clock::now() - start;
+    zoo->setAnomalyDetector(nullptr);
+    delete zoo;
+
+    cout << "=== Anomaly Detector Report (" << count << " slots) ===" << endl;
+    cout << fixed << setprecision(2);
+    cout << "Slot order:    " << orderedNs << " ns/update (" << 1000.0 / orderedNs << " M/s), "
+         << orderedAlerts << " alerts for " << orderedInjected << " spikes after warm-up" << endl;
+    cout << "Random order:  " << randomNs << " ns/update (" << 1000.0 / randomNs << " M/s), "
+         << randomAlerts << " alerts for " << randomInjected << " spikes" << endl;
+    cout << "Via setWeight: " << zooTime.count() / zooUpdates << " ns/update, "
+         << counter.alerts << " alerts on noise only" << endl;
+    return orderedAlerts == orderedInjected && counter.alerts == 0 ? 0 : 1;
+}
+
+/**
+ * Lookups and removals where most names are missing: exceptions against
+ * status codes, and the name index against a linear scan
+ */
+int reportMisses(size_t count) {
+    const size_t lookups = 1000000;
+    const size_t MISS_PERCENT = 90;
+    vector<string> names;
+    names.reserve(lookups);
+    ZooRandom::seedThread(11);
+    size_t expectedHits = 0;
+    for (size_t i = 0; i < lookups; ++i) {
+        size_t id = ZooRandom::below(count);
+        bool miss = ZooRandom::below(100) < MISS_PERCENT;
+        names.push_back((miss ? "Missing_" : "Animal_") + to_string(id));
+        expectedHits += !miss;
+    }
+
+    Zoo* zoo = makeZoo(count);
+
+    size_t throwingHits = 0;
+    Clock::time_point start = Clock::now();
+    for (const string& name : names) {
+        try {
+            zoo->findAnimal(name);
+            ++throwingHits;
+        } catch (const AnimalNotFoundException&) {
+        }
+    }
+    chrono::duration<double, nano> throwingTime = Clock::now() - start;
+
+    size_t tryHits = 0;
+    start = Clock::now();
+    for (const string& name : names) {
+        tryHits += zoo->tryFindAnimal(name) != nullptr;
+    }
+    chrono::duration<double, nano> tryTime = Clock::now() - start;
+
+    start = Clock::now();
+    vector<IAnimal*> found = zoo->findAnimals(names);
+    chrono::duration<double, nano> batchTime = Clock::now() - start;
+    size_t batchHits = found.size() - count_if(found.begin(), found.end(),
+                                                [](IAnimal* a) { return a == nullptr; });
+
+    // What every lookup cost before the index: a scan of the animal table
+    const size_t scans = min<size_t>(lookups, max<size_t>(1, 20000000 / count));
+    size_t scanHits = 0;
+    start = Clock::now();
+    for (size_t i = 0; i < scans; ++i) {
+        for (const IAnimal* animal : zoo->getAnimals()) {
+            if (static_cast<const Animal*>(animal)->getName() == names[i]) {
+                ++scanHits;
+                break;
+            }
+        }
+    }
+    chrono::duration<double, nano> scanTime = Clock::now() - start;
+
+    // Remove a slice of names, most of them missing, both ways
+    const size_t removals = min<size_t>(lookups, count);
+    vector<string> toRemove(names.begin(), names.begin() + removals);
+    size_t throwingRemoved = 0;
+    start = Clock::now();
+    for (size_t i = 0; i < removals / 2; ++i) {
+        try {
+            zoo->removeAnimal(toRemove[i]);
+            ++throwingRemoved;
+        } catch (const AnimalNotFoundException&) {
+        }
+    }
+    chrono::duration<double, nano> throwingRemoveTime = Clock::now() - start;
+    start = Clock::now();
+    vector<ZooStatus> statuses = zoo->tryRemoveAnimals(
+        vector<string>(toRemove.begin() + removals / 2, toRemove.end()));
+    chrono::duration<double, nano> tryRemoveTime = Clock::now() - start;
+    size_t tryRemoved = count_if(statuses.begin(), statuses.end(),
+                                 [](ZooStatus s) { return s == ZooStatus::Ok; });
+    size_t remaining = static_cast<size_t>(zoo->getAnimalCount());
+    delete zoo;
+
+    cout << "=== Miss-Heavy Lookup Report (" << count << " animals, " << lookups << " lookups, "
+         << MISS_PERCENT << "% misses) ===" << endl;
+    cout << fixed << setprecision(1);
+    cout << "findAnimal + catch:   " << throwingTime.count() / lookups << " ns/lookup" << endl;
+    cout << "tryFindAnimal:        " << tryTime.count() / lookups << " ns/lookup ("
+         << throwingTime.count() / tryTime.count() << "x faster)" << endl;
+    cout << "findAnimals (batch):  " << batchTime.count() / lookups << " ns/lookup" << endl;
+    cout << "Linear scan:          " << scanTime.count() / scans << " ns/lookup (" << scans << " sampled)" << endl;
+    cout << "removeAnimal + catch: " << throwingRemoveTime.count() / (removals / 2) << " ns/remove" << endl;
+    cout << "tryRemoveAnimals:     " << tryRemoveTime.count() / (removals - removals / 2) << " ns/remove" << endl;
+    cout << "Hits: " << tryHits << " of " << expectedHits << " expected, "
+         << throwingRemoved + tryRemoved << " removed, " << remaining << " left" << endl;
+
+    bool consistent = throwingHits == expectedHits && tryHits == expectedHits && batchHits == expectedHits
+        && remaining + throwingRemoved + tryRemoved == count;
+    return consistent ? 0 : 1;
+}
+
+/**
+ * Text save: the old per-line flushing writer, the buffered synchronous
+ * save, and the background save while the caller keeps changing weights
+ */
+int reportSave(size_t count) {
+    const string syncPath = "zoo_bench_save_sync.txt";
+    const string asyncPath = "zoo_bench_save_async.txt";
+    const string flushPath = "zoo_bench_save_endl.txt";
+    Zoo* zoo = makeZoo(count);
+    const vector<IAnimal*>& animals = zoo->getAnimals();
+
+    // What saveToFile used to do: std::endl after every line
+    Clock::time_point start = Clock::now();
+    {
+        ofstream out(flushPath);
+        out << zoo->getZooName() << endl << zoo->getCapacity() << endl << animals.size() << endl;
+        string line;
+        for (const IAnimal* animal : animals) {
+            line.clear();
+            Zoo::formatRecord(line, *static_cast<const Animal*>(animal));
+            out << line << endl;
+        }
+    }
+    chrono::duration<double, milli> flushTime = Clock::now() - start;
+
+    start = Clock::now();
+    zoo->saveToFile(syncPath);
+    chrono::duration<double, milli> syncTime = Clock::now() - start;
+
+    start = Clock::now();
+    future<void> saved = zoo->saveToFileAsync(asyncPath);
+    chrono::duration<double, milli> blockedTime = Clock::now() - start;
+    size_t updates = 0;
+    while (saved.wait_for(chrono::seconds(0)) != future_status::ready) {
+        Animal* animal = static_cast<Animal*>(animals[updates % count]);
+        animal->setWeight(animal->getWeight() + 1.0);
+        ++updates;
+    }
+    saved.get();
+    chrono::duration<double, milli> asyncTime = Clock::now() - start;
+    delete zoo;
+
+    // The background file must hold the zoo as it was when the save began
+    auto slurp = [](const string& path) {
+        ifstream in(path, ios::binary);
+        return string(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+    };
+    string syncBytes = slurp(syncPath);
+    bool identical = syncBytes == slurp(asyncPath) && syncBytes == slurp(flushPath);
+    remove(syncPath.c_str());
+    remove(asyncPath.c_str());
+    remove(flushPath.c_str());
+
+    cout << "=== Save Report (" << count << " animals, " << syncBytes.size() / 1024 << " KiB) ===" << endl;
+    cout << fixed << setprecision(1);
+    cout << "endl per line:     " << flushTime.count() << " ms" << endl;
+    cout << "saveToFile:        " << syncTime.count() << " ms" << endl;
+    cout << "saveToFileAsync:   " << blockedTime.count() << " ms blocked, "
+         << asyncTime.count() << " ms until written" << endl;
+    cout << "Weight updates made while saving: " << updates << endl;
+    cout << "Files identical: " << (identical ? "yes" : "NO") << endl;
+    return identical ? 0 : 1;
+}
+
+/**
+ * Records a mixed workload (lookups, misses, weight and health changes,
+ * turnover), then replays the trace as fast as possible and checks the
+ * replayed zoo ends in the same state
+ */
+int reportReplay(size_t count) {
+    const string path = "zoo_bench_trace.ztr";
+    const size_t ops = 500000;
+
+    auto workload = [&](Zoo& zoo) {
+        ZooRandom::seedThread(5);
+        Clock::time_point start = Clock::now();
+        for (size_t i = 0; i < ops; ++i) {
+            string name = "Animal_" + to_string(ZooRandom::below(count));
+            Animal* animal = i % 10 == 4 ? nullptr : static_cast<Animal*>(zoo.tryFindAnimal(name));
+            if (i % 10 == 4) {
+                zoo.tryFindAnimal("Missing_" + to_string(i));
+            } else if (animal && i % 10 >= 5 && i % 10 <= 6) {
+                animal->setWeight(animal->getWeight() * 1.01);
+            } else if (animal && i % 10 == 7) {
+                animal->setHealthStatus(!animal->getHealthStatus());
+            } else if (animal && i % 10 == 8) {
+                zoo.tryRemoveAnimal(name);
+                IAnimal* born = AnimalFactory::createAnimal("lion", name, 1, 30.0);
+                if (zoo.tryAddAnimal(born) != ZooStatus::Ok) {
+                    delete born;
+                }
+            }
+        }
+        return chrono::duration<double, nano>(Clock::now() - start).count() / ops;
+    };
+
+    Zoo* plain = makeZoo(count);
+    double plainNs = workload(*plain);
+    delete plain;
+
+    Zoo* recorded = makeZoo(count);
+    uint64_t events, bytes;
+    double seedMs, recordedNs;
+    {
+        OperationRecorder recorder(path);
+        Clock::time_point start = Clock::now();
+        recorded->setRecorder(&recorder);
+        seedMs = chrono::duration<double, milli>(Clock::now() - start).count();
+        recordedNs = workload(*recorded);
+        recorded->setRecorder(nullptr);
+        recorder.flush();
+        events = recorder.getEventCount();
+        bytes = recorder.getByteCount();
+    }
+
+    Clock::time_point start = Clock::now();
+    TraceReplayer replayer(path);
+    chrono::duration<double, milli> loadTime = Clock::now() - start;
+    start = Clock::now();
+    vector<TraceReplayer::OpStats> stats = replayer.run(TraceReplayer::Pacing::Fastest);
+    chrono::duration<double, milli> replayTime = Clock::now() - start;
+    const Zoo* replayed = replayer.getZoo();
+    bool same = replayed && replayed->getAnimalCount() == recorded->getAnimalCount()
+        && replayed->getSickCount() == recorded->getSickCount()
+        && fabs(replayed->calculateTotalFoodRequirement() - recorded->calculateTotalFoodRequirement()) < 1e-6;
+    delete recorded;
+    remove(path.c_str());
+
+    cout << "=== Record and Replay Report (" << count << " animals, " << ops << " operations) ===" << endl;
+    cout << fixed << setprecision(1);
+    cout << "Workload:          " << plainNs << " ns/op plain, " << recordedNs << " ns/op recording" << endl;
+    cout << "Seeding the trace: " << seedMs << " ms" << endl;
+    cout << "Trace:             " << events << " events, " << bytes / 1024 << " KiB ("
+         << static_cast<double>(bytes) / events << " bytes/event)" << endl;
+    cout << "Replay:            " << loadTime.count() << " ms to read, " << replayTime.count() << " ms to run" << endl;
+    TraceReplayer::printReport(cout, stats);
+    cout << "Replayed zoo matches: " << (same ? "yes" : "NO") << endl;
+    return same ? 0 : 1;
+}
+
+/**
+ * Top-K by weight and food: scan and partial sort against the maintained
+ * rankings, and what keeping them current costs per weight change
+ */
+int reportTopK(size_t count) {
+    Zoo* zoo = makeZoo(count);
+    const vector<IAnimal*>& animals = zoo->getAnimals();
+    const size_t k = 50;
+    const size_t updates = 1000000;
+
+    auto scanTop = [&](RankBy by) {
+        vector<pair<double, Animal*>> keyed;
+        keyed.reserve(animals.size());
+        for (IAnimal* animal : animals) {
+            Animal* a = static_cast<Animal*>(animal);
+            keyed.emplace_back(by == RankBy::Weight ? a->getWeight() : a->calculateFoodRequirement(), a);
+        }
+        size_t n = min(k, keyed.size());
+        partial_sort(keyed.begin(), keyed.begin() + n, keyed.end(),
+                     [](const pair<double, Animal*>& x, const pair<double, Animal*>& y) { return x.first > y.first; });
+        vector<double> keys;
+        for (size_t i = 0; i < n; ++i) {
+            keys.push_back(keyed[i].first);
+        }
+        return keys;
+    };
+    auto keysOf = [](const vector<Animal*>& top, RankBy by) {
+        vector<double> keys;
+        for (const Animal* a : top) {
+            keys.push_back(by == RankBy::Weight ? a->getWeight() : a->calculateFoodRequirement());
+        }
+        return keys;
+    };
+    auto reweigh = [&]() {
+        ZooRandom::seedThread(31);
+        Clock::time_point start = Clock::now();
+        for (size_t i = 0; i < updates; ++i) {
+            Animal* animal = static_cast<Animal*>(animals[ZooRandom::below(count)]);
+            animal->setWeight(animal->getWeight() * (0.9 + 0.2 * ZooRandom::unit()));
+        }
+        return chrono::duration<double, nano>(Clock::now() - start).count() / updates;
+    };
+
+    double plainNs = reweigh();
+
+    Clock::time_point start = Clock::now();
+    vector<double> scanned = scanTop(RankBy::Weight);
+    chrono::duration<double, milli> scanTime = Clock::now() - start;
+
+    start = Clock::now();
+    zoo->topAnimals(RankBy::Weight, k);
+    chrono::duration<double, milli> buildTime = Clock::now() - start;
+
+    double rankedNs = reweigh();
+
+    // Turnover and birthdays go through the same hooks
+    for (size_t i = 0; i < count / 10; ++i) {
+        string name = "Animal_" + to_string(i * 7 % count);
+        if (zoo->tryRemoveAnimal(name) == ZooStatus::Ok) {
+            zoo->tryAddAnimal(AnimalFactory::createAnimal("elephant", name, 12, 3000.0 + i % 1000));
+        }
+        static_cast<Animal*>(animals[i % animals.size()])->setAge(static_cast<int>(i % 40));
+    }
+
+    const int queries = 10000;
+    vector<Animal*> top;
+    start = Clock::now();
+    for (int i = 0; i < queries; ++i) {
+        top = zoo->topAnimals(i % 2 ? RankBy::Food : RankBy::Weight, k);
+    }
+    double queryUs = chrono::duration<double, micro>(Clock::now() - start).count() / queries;
+
+    bool same = true;
+    for (RankBy by : { RankBy::Weight, RankBy::Food }) {
+        same = same && keysOf(zoo->topAnimals(by, k), by) == scanTop(by);
+    }
+    delete zoo;
+
+    cout << "=== Top-K Report (" << count << " animals, k = " << k << ") ===" << endl;
+    cout << fixed << setprecision(1);
+    cout << "Scan and partial sort: " << scanTime.count() << " ms (heaviest " << scanned.front() << " kg)" << endl;
+    cout << "Build rankings:        " << buildTime.count() << " ms, once" << endl;
+    cout << setprecision(2);
+    cout << "Ranked query:          " << queryUs << " us" << endl;
+    cout << setprecision(1);
+    cout << "setWeight:             " << plainNs << " ns plain, " << rankedNs << " ns ranked" << endl;
+    cout << "Matches a fresh scan after turnover: " << (same ? "yes" : "NO") << endl;
+    return same ? 0 : 1;
+}
+
+/**
+ * Prefix lookups over a zoo's names: a scan of every animal against the
+ * prefix index, which then follows adds and removals. A standalone index
+ * of 10M names shows lookups stay well under a millisecond at that size.
+ */
+int reportPrefix(size_t count) {
+    Zoo* zoo = makeZoo(count);
+    const size_t limit = 10;
+    const int queries = 10000;
+
+    // Prefixes of a few existing names, some matching many animals
+    vector<string> prefixes;
+    ZooRandom::seedThread(17);
+    for (int i = 0; i < 100; ++i) {
+        string name = "Animal_" + to_string(ZooRandom::below(count));
+        prefixes.push_back(name.substr(0, 8 + ZooRandom::below(name.size() - 7)));
+    }
+    auto scan = [&](const string& prefix) {
+        vector<string> matches;
+        for (IAnimal* animal : zoo->getAnimals()) {
+            const string& name = static_cast<Animal*>(animal)->getName();
+            if (name.compare(0, prefix.size(), prefix) == 0) {
+                matches.push_back(name);
+            }
+        }
+        sort(matches.begin(), matches.end());
+        matches.resize(min(matches.size(), limit));
+        return matches;
+    };
+
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < 10; ++i) {
+        scan(prefixes[i]);
+    }
+    double scanMs = chrono::duration<double, milli>(Clock::now() - start).count() / 10;
+
+    start = Clock::now();
+    zoo->completeName("", 1);
+    chrono::duration<double, milli> buildTime = Clock::now() - start;
+
+    // Turnover: every tenth animal leaves and a renamed one arrives
+    start = Clock::now();
+    size_t changes = 0;
+    for (size_t i = 0; i < count / 10; ++i) {
+        string name = "Animal_" + to_string(i * 7 % count);
+        if (zoo->tryRemoveAnimal(name) == ZooStatus::Ok) {
+            zoo->tryAddAnimal(AnimalFactory::createAnimal("lion", "Animal_" + to_string(count + i), 4, 180.0));
+            ++changes;
+        }
+    }
+    double changeUs = chrono::duration<double, micro>(Clock::now() - start).count() / max<size_t>(changes, 1);
+
+    start = Clock::now();
+    for (int i = 0; i < queries; ++i) {
+        zoo->completeName(prefixes[i % prefixes.size()], limit);
+    }
+    double queryUs = chrono::duration<double, micro>(Clock::now() - start).count() / queries;
+
+    bool same = true;
+    for (const string& prefix : prefixes) {
+        same = same && zoo->completeName(prefix, limit) == scan(prefix);
+    }
+    delete zoo;
+
+    // 10M names without the animals behind them
+    const size_t bigCount = 10000000;
+    NamePrefixIndex big;
+    start = Clock::now();
+    {
+        vector<string> names;
+        names.reserve(bigCount);
+        for (size_t i = 0; i < bigCount; ++i) {
+            names.push_back("Animal_" + to_string(ZooRandom::below(bigCount * 10)));
+        }
+        big.addAll(vector<string_view>(names.begin(), names.end()));
+    }
+    chrono::duration<double> bigBuild = Clock::now() - start;
+    start = Clock::now();
+    for (int i = 0; i < queries; ++i) {
+        big.complete("Animal_" + to_string(ZooRandom::below(bigCount)), limit);
+    }
+    double bigQueryUs = chrono::duration<double, micro>(Clock::now() - start).count() / queries;
+    start = Clock::now();
+    for (int i = 0; i < queries; ++i) {
+        string name = "Animal_" + to_string(ZooRandom::below(bigCount * 10));
+        big.remove(name);
+        big.add(name + "_b");
+    }
+    double bigChangeUs = chrono::duration<double, micro>(Clock::now() - start).count() / queries;
+
+    cout << "=== Prefix Search Report (" << count << " animals, " << limit << " matches) ===" << endl;
+    cout << fixed << setprecision(2);
+    cout << "Scan and sort:          " << scanMs << " ms per prefix" << endl;
+    cout << "Build index:            " << buildTime.count() << " ms, once" << endl;
+    cout << "Indexed lookup:         " << queryUs << " us" << endl;
+    cout << "Remove + add:           " << changeUs << " us" << endl;
+    cout << "Matches a fresh scan after turnover: " << (same ? "yes" : "NO") << endl;
+    cout << "--- " << bigCount << " names, no zoo ---" << endl;
+    cout << "Build index:            " << bigBuild.count() << " s (" << big.memoryUsage() / (1024 * 1024) << " MB)" << endl;
+    cout << "Lookup:                 " << bigQueryUs << " us" << endl;
+    cout << "Remove + add:           " << bigChangeUs << " us" << endl;
+    return same ? 0 : 1;
+}
+
+/**
+ * Sketch upkeep on adds, removals and weight changes, quantile query
+ * latency and error against exact answers, and merging two zoos
+ */
+int reportSketch(size_t count) {
+    Zoo* zoo = makeZoo(count);
+    const vector<IAnimal*>& animals = zoo->getAnimals();
+    const size_t updates = 1000000;
+
+    auto reweigh = [&]() {
+        ZooRandom::seedThread(21);
+        Clock::time_point start = Clock::now();
+        for (size_t i = 0; i < updates; ++i) {
+            Animal* animal = static_cast<Animal*>(animals[ZooRandom::below(count)]);
+            animal->setWeight(animal->getWeight() * (0.9 + 0.2 * ZooRandom::unit()));
+        }
+        return chrono::duration<double, nano>(Clock::now() - start).count() / updates;
+    };
+    double plainNs = reweigh();
+
+    ZooSketches sketches;
+    Clock::time_point start = Clock::now();
+    zoo->setSketches(&sketches);
+    chrono::duration<double, milli> attachTime = Clock::now() - start;
+    double sketchedNs = reweigh();
+
+    // Turnover goes through removals and adds
+    for (size_t i = 0; i < count / 10; ++i) {
+        string name = "Animal_" + to_string(i * 7 % count);
+        if (zoo->tryRemoveAnimal(name) == ZooStatus::Ok) {
+            zoo->tryAddAnimal(AnimalFactory::createAnimal("elephant", name, 12, 3000.0 + i % 1000));
+        }
+    }
+
+    // Exact answers to compare with
+    const double qs[] = { 0.5, 0.95, 0.99 };
+    double worstError = 0.0;
+    for (int s = 0; s < SPECIES_COUNT; ++s) {
+        vector<double> weights;
+        for (const IAnimal* animal : animals) {
+            const Animal* a = static_cast<const Animal*>(animal);
+            if (a->getSpeciesId() == static_cast<SpeciesId>(s)) {
+                weights.push_back(a->getWeight());
+            }
+        }
+        if (weights.empty()) continue;
+        sort(weights.begin(), weights.end());
+        for (double q : qs) {
+            double exact = weights[static_cast<size_t>(q * (weights.size() - 1))];
+            double approx = sketches.getSketch().getSpecies(static_cast<SpeciesId>(s)).weights.quantile(q);
+            worstError = max(worstError, fabs(approx - exact) / exact);
+        }
+    }
+
+    const int queries = 10000;
+    double sink = 0.0;
+    start = Clock::now();
+    for (int i = 0; i < queries; ++i) {
+        const SpeciesSketch& s = sketches.getSketch().getSpecies(static_cast<SpeciesId>(i % SPECIES_COUNT));
+        sink += s.weights.quantile(0.5) + s.weights.quantile(0.95) + s.weights.quantile(0.99);
+    }
+    double queryUs = chrono::duration<double, micro>(Clock::now() - start).count() / queries;
+
+    double names = sketches.getSketch().getTotal().names.estimate();
+    double namesError = fabs(names - static_cast<double>(count)) / count;
+
+    // A second site, shipped as bytes and merged
+    Zoo* other = makeZoo(count);
+    ZooSketches otherSketches;
+    other->setSketches(&otherSketches);
+    start = Clock::now();
+    string shipped = otherSketches.getSketch().encode();
+    PopulationSketch merged = sketches.getSketch();
+    merged.merge(PopulationSketch::decode(shipped));
+    double mergeUs = chrono::duration<double, micro>(Clock::now() - start).count();
+    bool mergedCount = merged.getTotal().weights.count() == 2 * count;
+    other->setSketches(nullptr);
+    delete other;
+    zoo->setSketches(nullptr);
+    delete zoo;
+
+    cout << "=== Sketch Report (" << count << " animals) ===" << endl;
+    cout << fixed << setprecision(1);
+    cout << "Attach (sketch every animal): " << attachTime.count() << " ms" << endl;
+    cout << "setWeight:                    " << plainNs << " ns plain, " << sketchedNs << " ns with sketches" << endl;
+    cout << setprecision(2);
+    cout << "Weight p50/p95/p99 query:     " << queryUs << " us per species (checksum " << sink << ")" << endl;
+    cout << "Worst weight quantile error:  " << worstError * 100 << "% (bound "
+         << QuantileSketch::RELATIVE_ACCURACY * 100 << "%)" << endl;
+    cout << "Distinct names:               " << names << " estimated, " << count << " exact ("
+         << namesError * 100 << "% off)" << endl;
+    cout << "Encode, decode and merge a second zoo: " << mergeUs << " us, " << shipped.size() << " bytes" << endl;
+    merged.print(cout);
+    bool ok = worstError <= QuantileSketch::RELATIVE_ACCURACY * 1.01 && namesError < 0.05 && mergedCount;
+    cout << "Within bounds: " << (ok ? "yes" : "NO") << endl;
+    return ok ? 0 : 1;
+}
+
+/**
+ * Parallel food total and population report at increasing thread
+ * counts; every run must produce the same bits as the one-thread run
+ */
+int reportReduce(size_t count) {
+    Zoo* zoo = makeZoo(count);
+    const vector<IAnimal*>& animals = zoo->getAnimals();
+    const unsigned maxThreads = max(4u, thread::hardware_concurrency());
+    const int rounds = 5;
+
+    // The plain left-to-right loop calculateTotalFoodRequirement used to run
+    Clock::time_point start = Clock::now();
+    double naive = 0.0;
+    for (int round = 0; round < rounds; ++round) {
+        naive = 0.0;
+        for (const IAnimal* animal : animals) {
+            naive += static_cast<const Animal*>(animal)->calculateFoodRequirement();
+        }
+    }
+    chrono::duration<double, milli> naiveTime = (Clock::now() - start) / rounds;
+
+    cout << "=== Deterministic Reduction Report (" << count << " animals, "
+         << thread::hardware_concurrency() << " hardware threads) ===" << endl;
+    cout << "Plain loop: " << naiveTime.count() << " ms, total " << setprecision(17) << naive << endl;
+    cout << setw(8) << "threads" << setw(12) << "food ms" << setw(12) << "report ms"
+         << setw(12) << "speedup" << setw(26) << "food total" << setw(12) << "identical" << endl;
+
+    double baseFood = 0.0, baseTime = 0.0;
+    PopulationStats baseStats;
+    bool allSame = true;
+    for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+        double food = 0.0;
+        start = Clock::now();
+        for (int round = 0; round < rounds; ++round) {
+            food = zoo->calculateTotalFoodRequirement(threads);
+        }
+        chrono::duration<double, milli> foodTime = (Clock::now() - start) / rounds;
+
+        PopulationReport report;
+        start = Clock::now();
+        for (int round = 0; round < rounds; ++round) {
+            report = PopulationReport();
+            report.addZoo(*zoo, threads);
+        }
+        chrono::duration<double, milli> reportTime = (Clock::now() - start) / rounds;
+        PopulationStats stats = report.getTotal();
+
+        if (threads == 1) {
+            baseFood = food;
+            baseStats = stats;
+            baseTime = foodTime.count();
+        }
+        // Compare bits, not values within a tolerance
+        bool same = memcmp(&food, &baseFood, sizeof(double)) == 0
+            && memcmp(&stats.totalFood, &baseStats.totalFood, sizeof(double)) == 0
+            && memcmp(&stats.totalWeight, &baseStats.totalWeight, sizeof(double)) == 0
+            && memcmp(&stats.totalAge, &baseStats.totalAge, sizeof(double)) == 0
+            && stats.count == baseStats.count && stats.sick == baseStats.sick;
+        allSame = allSame && same;
+        cout << setw(8) << threads << fixed << setprecision(1)
+             << setw(12) << foodTime.count() << setw(12) << reportTime.count()
+             << setw(11) << baseTime / foodTime.count() << "x"
+             << setw(26) << setprecision(10) << food << setw(12) << (same ? "yes" : "NO") << endl;
+        cout.unsetf(ios::floatfield);
+    }
+    delete zoo;
+    return allSame ? 0 : 1;
+}
+
+/**
+ * A management report the old way (a scan per statistic) against one
+ * PopulationReport pass, checking both agree
+ */
+int reportPopulation(size_t count) {
+    Zoo* zoo = makeZoo(count);
+    const int rounds = 5;
+
+    // Counts, food, sick animals, then mean age and weight per species
+    Clock::time_point start = Clock::now();
+    double checksum = 0.0;
+    int speciesCounts[SPECIES_COUNT] = {};
+    double scanFood = 0.0;
+    for (int round = 0; round < rounds; ++round) {
+        checksum += zoo->getAnimalCount();
+        for (int s = 0; s < SPECIES_COUNT; ++s) {
+            speciesCounts[s] = zoo->countBySpecies(speciesName(static_cast<SpeciesId>(s)));
+        }
+        scanFood = zoo->calculateTotalFoodRequirement();
+        checksum += zoo->getSickCount();
+        for (int s = 0; s < SPECIES_COUNT; ++s) {
+            const string species = speciesName(static_cast<SpeciesId>(s));
+            double ageSum = 0.0, weightSum = 0.0;
+            for (const IAnimal* animal : zoo->getAnimals()) {
+                if (animal->getSpecies() == species) {
+                    const Animal* a = static_cast<const Animal*>(animal);
+                    ageSum += a->getAge();
+                    weightSum += a->getWeight();
+                }
+            }
+            checksum += ageSum + weightSum;
+        }
+    }
+    chrono::duration<double, milli> scanTime = (Clock::now() - start) / rounds;
+
+    start = Clock::now();
+    PopulationReport report;
+    for (int round = 0; round < rounds; ++round) {
+        report = PopulationReport();
+        report.addZoo(*zoo);
+    }
+    chrono::duration<double, milli> passTime = (Clock::now() - start) / rounds;
+
+    bool same = fabs(report.getTotal().totalFood - scanFood) < 1e-6 * max(1.0, scanFood)
+        && report.getTotal().count == static_cast<size_t>(zoo->getAnimalCount())
+        && report.getTotal().sick == static_cast<size_t>(zoo->getSickCount());
+    // countBySpecies matches the exact label ("Capuchin Monkey" is not
+    // "Monkey"); the report groups by species family, so it never counts less
+    for (int s = 0; s < SPECIES_COUNT; ++s) {
+        same = same && report.getSpecies(static_cast<SpeciesId>(s)).count >= static_cast<size_t>(speciesCounts[s]);
+    }
+    delete zoo;
+
+    cout << "=== Population Report (" << count << " animals) ===" << endl;
+    cout << fixed << setprecision(1);
+    cout << "One scan per statistic: " << scanTime.count() << " ms (checksum " << checksum << ")" << endl;
+    cout << "Single pass:            " << passTime.count() << " ms ("
+         << scanTime.count() / passTime.count() << "x faster)" << endl;
+    report.print(cout);
+    cout << "Figures agree: " << (same ? "yes" : "NO") << endl;
+    return same ? 0 : 1;
+}
+
+// Swallows everything; used to keep chatty calls off the console
+class NullBuffer : public streambuf {
+protected:
+    int overflow(int c) override { return c; }
+};
+
+/**
+ * Heap allocations per operation for each subsystem, counted by the
+ * AllocationTracker. Numbers only appear in builds made with
+ * make TRACK_ALLOCATIONS=1; a rise between builds is a regression.
+ */
+int reportAllocations(size_t count) {
+    if (!AllocationTracker::isEnabled()) {
+        cout << "=== Allocation Report ===" << endl;
+        AllocationTracker::report(cout);
+        return 0;
+    }
+    const size_t lookups = min<size_t>(count, 200000);
+    const size_t enclosureSize = min<size_t>(count, 2000);
+    const string textPath = "zoo_bench_allocs.txt";
+    const string archivePath = "zoo_bench_allocs.zar";
+
+    vector<string> names, missing;
+    names.reserve(count);
+    missing.reserve(lookups);
+    for (size_t i = 0; i < count; ++i) {
+        names.push_back("Animal_" + to_string(i));
+    }
+    for (size_t i = 0; i < lookups; ++i) {
+        missing.push_back("Missing_" + to_string(i));
+    }
+
+    // The enclosure phases silence cout, so the table goes to its own stream
+    ostream out(cout.rdbuf());
+    out << "=== Allocation Report (" << count << " animals) ===" << endl;
+    out << left << setw(26) << "phase" << right << setw(10) << "ops"
+         << setw(12) << "allocs/op" << setw(12) << "bytes/op" << endl;
+    auto phase = [&out](const char* label, AllocRegion region, auto body) {
+        AllocationTracker::reset();
+        body();
+        AllocationStats s = AllocationTracker::get(region);
+        double ops = static_cast<double>(max<uint64_t>(s.operations, 1));
+        out << left << setw(26) << label << right << setw(10) << s.operations
+             << fixed << setprecision(2)
+             << setw(12) << s.allocations / ops << setw(12) << s.bytes / ops << endl;
+    };
+
+    vector<IAnimal*> created;
+    created.reserve(count);
+    phase("factory create", AllocRegion::Factory, [&] {
+        for (const string& name : names) {
+            created.push_back(AnimalFactory::createAnimal("lion", name, 5, 190.0));
+        }
+    });
+
+    Zoo zoo("Allocation Zoo", static_cast<int>(count));
+    zoo.setVerbose(false);
+    phase("zoo add", AllocRegion::Zoo, [&] {
+        for (IAnimal* animal : created) {
+            zoo.tryAddAnimal(animal);
+        }
+    });
+
+    size_t hits = 0;
+    phase("zoo find (hit)", AllocRegion::Zoo, [&] {
+        for (size_t i = 0; i < lookups; ++i) {
+            hits += zoo.tryFindAnimal(names[i]) != nullptr;
+        }
+    });
+    phase("zoo find (miss)", AllocRegion::Zoo, [&] {
+        for (const string& name : missing) {
+            hits += zoo.tryFindAnimal(name) != nullptr;
+        }
+    });
+    phase("zoo findAnimal (throws)", AllocRegion::Zoo, [&] {
+        for (size_t i = 0; i < lookups / 10; ++i) {
+            try {
+                zoo.findAnimal(missing[i]);
+            } catch (const AnimalNotFoundException&) {
+            }
+        }
+    });
+    zoo.countBySpecies("Lion"); // the first getSpecies() call interns the name
+    phase("zoo aggregates", AllocRegion::Zoo, [&] {
+        zoo.countBySpecies("Lion");
+        zoo.calculateTotalFoodRequirement();
+    });
+
+    phase("save text", AllocRegion::Persistence, [&] { zoo.saveToFile(textPath); });
+    phase("save archive", AllocRegion::Persistence, [&] { zoo.saveArchive(archivePath); });
+    phase("load archive (eager)", AllocRegion::Persistence, [&] {
+        Zoo loaded("Loaded", 1);
+        loaded.setVerbose(false);
+        loaded.loadFromFile(archivePath, Zoo::LoadMode::Eager);
+    });
+
+    phase("zoo remove", AllocRegion::Zoo, [&] {
+        for (size_t i = 0; i < lookups; ++i) {
+            zoo.tryRemoveAnimal(names[i]);
+        }
+    });
+
+    {
+        NullBuffer discard;
+        streambuf* console = cout.rdbuf(&discard);
+        Enclosure<Lion> enclosure("Allocation Enclosure", static_cast<int>(enclosureSize));
+        phase("enclosure add", AllocRegion::Enclosure, [&] {
+            for (size_t i = 0; i < enclosureSize; ++i) {
+                enclosure.addAnimal(AnimalFactory::createLion(names[i], 5, 190.0, true, "Golden",
+                                                             110, 20, false));
+            }
+        });
+        phase("enclosure remove", AllocRegion::Enclosure, [&] {
+            for (size_t i = 0; i < enclosureSize; ++i) {
+                enclosure.removeAnimal(names[i]);
+            }
+        });
+        cout.rdbuf(console);
+    }
+    remove(textPath.c_str());
+    remove(archivePath.c_str());
+
+    out << "Lookup hits: " << hits << " (expected " << lookups << ")" << endl;
+    return hits == lookups ? 0 : 1;
+}
+
+struct Report {
+    const char* name;
+    const char* description;
+    int (*run)(size_t animals);
+};
+
+const Report REPORTS[] = {
+    { "intern", "memory saved by interning repeated attribute strings", reportIntern },
+    { "feeding", "diet-aware feeding plan and parallel feeding", reportFeeding },
+    { "packing", "pack animals into enclosures (bin packing)", reportPacking },
+    { "mixed", "mixed-species enclosure vs IAnimal* dispatch", reportMixed },
+    { "columnar", "columnar export throughput and column statistics", reportColumnar },
+    { "diff", "diff two zoo states and merge the delta", reportDiff },
+    { "archive", "archive save, lazy open and on-demand lookups", reportArchive },
+    { "liveview", "shared-memory live view publish and snapshot cost", reportLiveView },
+    { "history", "time-series history: append, compression, queries, budget", reportHistory },
+    { "anomaly", "streaming weight/health anomaly detection throughput", reportAnomaly },
+    { "misses", "miss-heavy lookups: exceptions vs status codes, index vs scan", reportMisses },
+    { "save", "text save: per-line flush, buffered, and in the background", reportSave },
+    { "replay", "record a mixed workload, replay it, per-operation latency", reportReplay },
+    { "allocs", "heap allocations per operation by subsystem", reportAllocations },
+    { "population", "management report: a scan per statistic vs one pass", reportPopulation },
+    { "reduce", "parallel food totals: bit-identical across thread counts", reportReduce },
+    { "sketch", "age/weight quantile and distinct-name sketches: upkeep, queries, merge", reportSketch },
+    { "topk", "heaviest/hungriest K: scan and sort vs maintained rankings", reportTopK },
+    { "prefix", "name autocomplete: scan vs prefix index, incl. 10M names", reportPrefix },
+    { "layout", "object size per species and hot-field scan cost", reportLayout },
+    { "parrot", "shared vocabulary pool and reproducible per-thread RNG", reportParrot },
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t animals = argc > 2 ? static_cast<size_t>(atol(argv[2])) : 1000000;
+    if (argc > 1 && animals > 0) {
+        for (const Report& report : REPORTS) {
+            if (argv[1] == string(report.name)) {
+                return report.run(animals);
+            }
+        }
+    }
+
+    cerr << "Usage: " << argv[0] << " <report> [animals=1000000]" << endl;
+    for (const Report& report : REPORTS) {
+        cerr << "  " << left << setw(12) << report.name << report.description << endl;
+    }
+    return 1;
+}
@@ -0,0 +1,245 @@
+/**
+ * Load generator for the zoo socket server (zoo_simulator --server PATH)
+ * Opens several connections, keeps a fixed number of requests in flight on
+ * each one and reports throughput and latency percentiles.
+ *
+ * Usage: zoo_loadgen [--socket PATH] [--connections N] [--requests N]
+ *                    [--pipeline N] [--animals N]
+ */
+#include "ZooProtocol.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+using namespace std;
+using namespace ZooProtocol;
+typedef chrono::steady_clock Clock;
+
+struct Options {
+    string socketPath = "/tmp/zoo.sock";
+    int connections = 4;
+    long requests = 100000;   // per connection
+    int pipeline = 32;
+    int animals = 1000;       // preloaded before the measurement
+};
+
+struct WorkerResult {
+    vector<double> latenciesUs;
+    long errors = 0;
+};
+
+int connectTo(const string& path) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+bool sendAll(int fd, const string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+/**
+ * Reads responses from the socket into buffer and pops complete frames
+ * Returns the status of each completed frame through statuses
+ */
+bool receiveFrames(int fd, string& buffer, vector<uint8_t>& statuses) {
+    char chunk[64 * 1024];
+    ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+    if (n < 0 && errno == EINTR) return true;
+    if (n <= 0) return false;
+    buffer.append(chunk, static_cast<size_t>(n));
+
+    size_t offset = 0;
+    uint32_t length;
+    while (peekFrameLength(buffer.data() + offset, buffer.size() - offset, length)
+           && buffer.size() - offset >= HEADER_SIZE + length) {
+        statuses.push_back(length > 0 ? static_cast<uint8_t>(buffer[offset + HEADER_SIZE])
+                                      : static_cast<uint8_t>(STATUS_ERROR));
+        offset += HEADER_SIZE + length;
+    }
+    buffer.erase(0, offset);
+    return true;
+}
+
+void encodeRequest(string& out, long sequence, int animals) {
+    string name = "Animal_" + to_string(sequence % max(animals, 1));
+    FrameWriter frame(out);
+    switch (sequence % 10) {
+        case 0:
+            frame.putU8(OP_COUNT);
+            break;
+        case 1:
+            frame.putU8(OP_COUNT_SPECIES);
+            frame.putString("Lion");
+            break;
+        case 2:
+            frame.putU8(OP_FIND);
+            frame.putString("Missing_" + to_string(sequence));
+            break;
+        default:
+            frame.putU8(OP_FIND);
+            frame.putString(name);
+            break;
+    }
+    frame.finish();
+}
+
+void runWorker(const Options& options, int id, WorkerResult& result) {
+    int fd = connectTo(options.socketPath);
+    if (fd < 0) {
+        cerr << "Connection " << id << " failed: " << strerror(errno) << endl;
+        result.errors = options.requests;
+        return;
+    }
+
+    result.latenciesUs.reserve(static_cast<size_t>(options.requests));
+    deque<Clock::time_point> inFlight;
+    string input;
+    string output;
+    vector<uint8_t> statuses;
+    long nextToSend = 0;
+    long completed = 0;
+
+    while (completed < options.requests) {
+        output.clear();
+        while (nextToSend < options.requests
+               && static_cast<int>(inFlight.size()) < options.pipeline) {
+            encodeRequest(output, nextToSend + id * options.requests, options.animals);
+            inFlight.push_back(Clock::now());
+            ++nextToSend;
+        }
+        if (!output.empty() && !sendAll(fd, output)) break;
+
+        statuses.clear();
+        if (!receiveFrames(fd, input, statuses)) break;
+        Clock::time_point now = Clock::now();
+        for (uint8_t status : statuses) {
+            chrono::duration<double, micro> latency = now - inFlight.front();
+            inFlight.pop_front();
+            result.latenciesUs.push_back(latency.count());
+            if (status != STATUS_OK && status != STATUS_NOT_FOUND) {
+                ++result.errors;
+            }
+            ++completed;
+        }
+    }
+    close(fd);
+}
+
+void preload(const Options& options) {
+    int fd = connectTo(options.socketPath);
+    if (fd < 0) {
+        cerr << "Cannot connect to " << options.socketPath << ": " << strerror(errno) << endl;
+        exit(1);
+    }
+    const char* species[] = { "Lion", "Elephant", "Monkey", "Eagle", "Penguin", "Parrot" };
+    string output;
+    for (int i = 0; i < options.animals; ++i) {
+        FrameWriter frame(output);
+        frame.putU8(OP_ADD);
+        frame.putString(species[i % 6]);
+        frame.putString("Animal_" + to_string(i));
+        frame.putI32(1 + i % 20);
+        frame.putF64(10.0 + i % 500);
+        frame.finish();
+    }
+    sendAll(fd, output);
+
+    string input;
+    vector<uint8_t> statuses;
+    long rejected = 0;
+    while (static_cast<int>(statuses.size()) < options.animals
+           && receiveFrames(fd, input, statuses)) {
+    }
+    for (uint8_t status : statuses) {
+        if (status != STATUS_OK) ++rejected;
+    }
+    if (rejected > 0) {
+        cerr << "Warning: " << rejected << " preload adds were rejected "
+             << "(is the server capacity large enough?)" << endl;
+    }
+    close(fd);
+}
+
+double percentile(const vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    size_t index = static_cast<size_t>(p * (sorted.size() - 1));
+    return sorted[index];
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--socket" && hasValue) options.socketPath = argv[++i];
+        else if (arg == "--connections" && hasValue) options.connections = atoi(argv[++i]);
+        else if (arg == "--requests" && hasValue) options.requests = atol(argv[++i]);
+        else if (arg == "--pipeline" && hasValue) options.pipeline = atoi(argv[++i]);
+        else if (arg == "--animals" && hasValue) options.animals = atoi(argv[++i]);
+        else {
+            cerr << "Usage: " << argv[0] << " [--socket PATH] [--connections N] [--requests N]"
+                 << " [--pipeline N] [--animals N]" << endl;
+            return 1;
+        }
+    }
+    options.connections = max(options.connections, 1);
+    options.pipeline = max(options.pipeline, 1);
+
+    preload(options);
+
+    vector<WorkerResult> results(options.connections);
+    vector<thread> workers;
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < options.connections; ++i) {
+        workers.emplace_back(runWorker, cref(options), i, ref(results[i]));
+    }
+    for (thread& worker : workers) {
+        worker.join();
+    }
+    chrono::duration<double> elapsed = Clock::now() - start;
+
+    vector<double> latencies;
+    long errors = 0;
+    for (const WorkerResult& result : results) {
+        latencies.insert(latencies.end(), result.latenciesUs.begin(), result.latenciesUs.end());
+        errors += result.errors;
+    }
+    sort(latencies.begin(), latencies.end());
+
+    cout << "Connections:   " << options.connections << " x pipeline " << options.pipeline << endl;
+    cout << "Requests:      " << latencies.size() << " (" << errors << " errors)" << endl;
+    cout << "Elapsed:       " << elapsed.count() << " s" << endl;
+    cout << "Throughput:    " << static_cast<long>(latencies.size() / elapsed.count())
+         << " requests/s" << endl;
+    cout << "Latency (us):  p50 " << percentile(latencies, 0.50)
+         << "  p99 " << percentile(latencies, 0.99)
+         << "  p99.9 " << percentile(latencies, 0.999)
+         << "  max " << (latencies.empty() ? 0.0 : latencies.back()) << endl;
+    return errors == 0 ? 0 : 1;
+}
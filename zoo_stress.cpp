@@ -0,0 +1,412 @@
+/**
+ * Stress and soak test for concurrent zoo workloads (see ConcurrentZoo.h)
+ * Writer threads add and remove animals, reader threads look animals up
+ * and compute aggregates, and vet threads mark animals sick and notify a
+ * veterinarian, all for a fixed duration. Every interval it prints the
+ * throughput per role, latency percentiles, resident memory and the
+ * result of the invariant checks; the exit status is non-zero if any
+ * check ever failed.
+ *
+ * Usage: zoo_stress [--duration SECONDS] [--interval SECONDS]
+ *                   [--writers N] [--readers N] [--vets N]
+ *                   [--capacity N] [--animals N] [--seed N]
+ */
+#include "ConcurrentZoo.h"
+#include "AnimalFactory.h"
+#include "Veterinarian.h"
+#include "ZooRandom.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <array>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <memory>
+#include <cmath>
+#include <cstdlib>
+#include <set>
+#include <streambuf>
+#include <unistd.h>
+
+using namespace std;
+typedef chrono::steady_clock Clock;
+
+struct Options {
+    double duration = 10.0;     // seconds
+    double interval = 1.0;
+    int writers = 2;
+    int readers = 4;
+    int vets = 1;
+    int capacity = 100000;
+    int animals = 50000;        // preloaded
+    uint64_t seed = 1;
+};
+
+enum Role { WRITER, READER, VET, ROLE_COUNT };
+const char* ROLE_NAMES[ROLE_COUNT] = { "writers", "readers", "vets" };
+
+/**
+ * Log-linear latency histogram: four buckets per power of two of
+ * nanoseconds, so percentiles are within 19% without storing samples.
+ * Workers add with relaxed atomics; the reporter drains it each interval.
+ */
+class LatencyHistogram {
+public:
+    static const size_t BUCKETS = 64 * 4;
+
+private:
+    array<atomic<uint64_t>, BUCKETS> counts;
+
+    static size_t bucketOf(uint64_t nanos) {
+        if (nanos < 4) return static_cast<size_t>(nanos);
+        int top = 63 - __builtin_clzll(nanos);
+        return static_cast<size_t>(top) * 4 + ((nanos >> (top - 2)) & 3);
+    }
+
+public:
+    LatencyHistogram() {
+        for (atomic<uint64_t>& count : counts) count.store(0, memory_order_relaxed);
+    }
+
+    void add(uint64_t nanos) {
+        counts[bucketOf(nanos)].fetch_add(1, memory_order_relaxed);
+    }
+
+    // Moves every count into totals and clears this histogram
+    void drainInto(array<uint64_t, BUCKETS>& totals) {
+        for (size_t i = 0; i < BUCKETS; ++i) {
+            totals[i] += counts[i].exchange(0, memory_order_relaxed);
+        }
+    }
+
+    // Lower edge of the bucket holding the p-th fraction of totals
+    static double percentileMicros(const array<uint64_t, BUCKETS>& totals, double p) {
+        uint64_t all = 0;
+        for (uint64_t count : totals) all += count;
+        if (all == 0) return 0.0;
+        uint64_t rank = static_cast<uint64_t>(ceil(p * all));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKETS; ++i) {
+            seen += totals[i];
+            if (seen >= rank) {
+                if (i < 8) return i / 1000.0;
+                size_t top = i / 4;
+                return static_cast<double>((uint64_t(4) + i % 4) << (top - 2)) / 1000.0;
+            }
+        }
+        return 0.0;
+    }
+};
+
+// Swallows everything written to it
+class NullBuffer : public streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    streamsize xsputn(const char*, streamsize count) override { return count; }
+};
+
+struct RoleStats {
+    atomic<uint64_t> operations{0};
+    atomic<uint64_t> failures{0};   // not found, or zoo full
+    LatencyHistogram latency;
+};
+
+struct Shared {
+    ConcurrentZoo& zoo;
+    const Options& options;
+    atomic<bool> running{true};
+    atomic<long long> expectedCount{0};   // preload + successful adds - removes
+    RoleStats roles[ROLE_COUNT];
+
+    Shared(ConcurrentZoo& zoo, const Options& options) : zoo(zoo), options(options) {}
+};
+
+const char* SPECIES[] = { "lion", "elephant", "monkey", "eagle", "penguin", "parrot" };
+
+// Names are drawn from a pool twice the capacity, so adds and removes
+// hit existing and missing animals alike
+string poolName(size_t id) {
+    return "Animal_" + to_string(id);
+}
+
+template <typename Op>
+void timed(RoleStats& stats, Op op) {
+    Clock::time_point start = Clock::now();
+    bool ok = op();
+    uint64_t nanos = static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(Clock::now() - start).count());
+    stats.latency.add(nanos);
+    stats.operations.fetch_add(1, memory_order_relaxed);
+    if (!ok) stats.failures.fetch_add(1, memory_order_relaxed);
+}
+
+void runWriter(Shared& shared, uint64_t seed) {
+    ZooRandom::seedThread(seed);
+    size_t pool = static_cast<size_t>(shared.options.capacity) * 2;
+    RoleStats& stats = shared.roles[WRITER];
+    while (shared.running.load(memory_order_relaxed)) {
+        string name = poolName(ZooRandom::below(pool));
+        if (ZooRandom::below(2) == 0) {
+            IAnimal* animal = AnimalFactory::createAnimal(SPECIES[ZooRandom::below(6)], name,
+                                                          1 + static_cast<int>(ZooRandom::below(30)),
+                                                          5.0 + ZooRandom::below(400));
+            timed(stats, [&] {
+                ZooStatus status = shared.zoo.tryAddAnimal(animal);
+                if (status == ZooStatus::Ok) {
+                    shared.expectedCount.fetch_add(1, memory_order_relaxed);
+                    return true;
+                }
+                delete animal;
+                return false;
+            });
+        } else {
+            timed(stats, [&] {
+                if (shared.zoo.tryRemoveAnimal(name) == ZooStatus::Ok) {
+                    shared.expectedCount.fetch_sub(1, memory_order_relaxed);
+                    return true;
+                }
+                return false;
+            });
+        }
+    }
+}
+
+void runReader(Shared& shared, uint64_t seed) {
+    ZooRandom::seedThread(seed);
+    size_t pool = static_cast<size_t>(shared.options.capacity) * 2;
+    RoleStats& stats = shared.roles[READER];
+    for (uint64_t i = 0; shared.running.load(memory_order_relaxed); ++i) {
+        if (i % 1000 == 999) {
+            // Aggregates scan the whole zoo under the shared lock
+            timed(stats, [&] {
+                return shared.zoo.calculateTotalFoodRequirement() >= 0.0
+                    && shared.zoo.countBySpecies("Lion") >= 0;
+            });
+            continue;
+        }
+        if (i % 1000 == 499) {
+            // Indexed queries from several readers at once
+            timed(stats, [&] {
+                return shared.zoo.read([](const Zoo& zoo) {
+                    return zoo.topAnimals(RankBy::Weight, 10).size() <= 10
+                        && zoo.completeName("Animal_1", 10).size() <= 10;
+                });
+            });
+            continue;
+        }
+        string name = poolName(ZooRandom::below(pool));
+        timed(stats, [&] {
+            double weight = 0.0;
+            return shared.zoo.visitAnimal(name, [&weight](const Animal& a) { weight = a.getWeight(); });
+        });
+    }
+}
+
+void runVet(Shared& shared, uint64_t seed, Veterinarian& vet) {
+    ZooRandom::seedThread(seed);
+    size_t pool = static_cast<size_t>(shared.options.capacity) * 2;
+    RoleStats& stats = shared.roles[VET];
+    for (uint64_t i = 0; shared.running.load(memory_order_relaxed); ++i) {
+        string name = poolName(ZooRandom::below(pool));
+        if (i % 100 == 99) {
+            timed(stats, [&] { return shared.zoo.dispatchVeterinarian(vet) >= 0; });
+        } else if (i % 2 == 0) {
+            timed(stats, [&] { return shared.zoo.setHealthStatus(name, false); });
+        } else {
+            timed(stats, [&] { return shared.zoo.notifyVeterinarian(vet, name); });
+        }
+        this_thread::yield();
+    }
+}
+
+// Resident set size in KiB, 0 where /proc is not available
+long residentKiB() {
+    ifstream statm("/proc/self/statm");
+    long pages = 0, resident = 0;
+    if (!(statm >> pages >> resident)) return 0;
+    return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+/**
+ * Checks that the zoo agrees with itself and with the writers' tally:
+ * count == sum of countBySpecies() == adds - removes, count <= capacity,
+ * the sick count matches the animals, and every animal is found by name
+ * Returns a description of the first failure, or "" if all hold
+ */
+string checkInvariants(Shared& shared) {
+    return shared.zoo.read([&](const Zoo& zoo) -> string {
+        long long expected = shared.expectedCount.load();
+        const vector<IAnimal*>& animals = zoo.getAnimals();
+        long long count = zoo.getAnimalCount();
+        long long sick = 0;
+        long long unfindable = 0;
+        set<string> labels;
+        for (const IAnimal* animal : animals) {
+            const Animal* a = static_cast<const Animal*>(animal);
+            labels.insert(a->getSpecies());
+            if (!a->getHealthStatus()) ++sick;
+            const Animal* found = static_cast<const Animal*>(zoo.tryFindAnimal(a->getName()));
+            if (!found || found->getName() != a->getName()) ++unfindable;
+        }
+        long long speciesTotal = 0;
+        for (const string& label : labels) speciesTotal += zoo.countBySpecies(label);
+
+        if (count != static_cast<long long>(animals.size()) || count != speciesTotal) {
+            return "count " + to_string(count) + " != species total " + to_string(speciesTotal);
+        }
+        if (count > zoo.getCapacity()) {
+            return "count " + to_string(count) + " exceeds capacity " + to_string(zoo.getCapacity());
+        }
+        // Writers update the tally just after the zoo, so it may lag by
+        // at most one operation per writer
+        if (llabs(count - expected) > shared.options.writers) {
+            return "count " + to_string(count) + " != adds - removes " + to_string(expected);
+        }
+        if (sick != zoo.getSickCount()) {
+            return "sick count " + to_string(zoo.getSickCount()) + " != " + to_string(sick) + " sick animals";
+        }
+        if (unfindable > 0) {
+            return to_string(unfindable) + " animals not found by name";
+        }
+        return "";
+    });
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--duration" && hasValue) options.duration = atof(argv[++i]);
+        else if (arg == "--interval" && hasValue) options.interval = atof(argv[++i]);
+        else if (arg == "--writers" && hasValue) options.writers = atoi(argv[++i]);
+        else if (arg == "--readers" && hasValue) options.readers = atoi(argv[++i]);
+        else if (arg == "--vets" && hasValue) options.vets = atoi(argv[++i]);
+        else if (arg == "--capacity" && hasValue) options.capacity = atoi(argv[++i]);
+        else if (arg == "--animals" && hasValue) options.animals = atoi(argv[++i]);
+        else if (arg == "--seed" && hasValue) options.seed = strtoull(argv[++i], nullptr, 10);
+        else {
+            cerr << "Usage: " << argv[0] << " [--duration SECONDS] [--interval SECONDS]\n"
+                 << "       [--writers N] [--readers N] [--vets N]\n"
+                 << "       [--capacity N] [--animals N] [--seed N]" << endl;
+            return 1;
+        }
+    }
+    if (options.capacity <= 0 || options.interval <= 0.0) {
+        cerr << "capacity and interval must be positive" << endl;
+        return 1;
+    }
+
+    // The zoo and the vets narrate everything they do; keep stdout for the report
+    NullBuffer discard;
+    streambuf* console = cout.rdbuf(&discard);
+    ostream report(console);
+
+    Zoo zoo("Stress Zoo", options.capacity);
+    zoo.setVerbose(false);
+    ConcurrentZoo concurrent(zoo);
+    Shared shared(concurrent, options);
+    ZooRandom::seedThread(options.seed);
+    for (int i = 0; i < options.animals && i < options.capacity; ++i) {
+        IAnimal* animal = AnimalFactory::createAnimal(SPECIES[i % 6], poolName(ZooRandom::below(options.capacity * 2u)),
+                                                      1 + i % 30, 5.0 + i % 400);
+        if (concurrent.tryAddAnimal(animal) == ZooStatus::Ok) {
+            ++shared.expectedCount;
+        } else {
+            delete animal;
+        }
+    }
+
+    report << "Stress run: " << options.writers << " writers, " << options.readers << " readers, "
+           << options.vets << " vets, capacity " << options.capacity << ", "
+           << shared.expectedCount.load() << " animals preloaded, " << options.duration << " s" << endl;
+    report << setw(8) << "time(s)";
+    for (int role = 0; role < ROLE_COUNT; ++role) {
+        report << setw(12) << string(ROLE_NAMES[role]) + "/s";
+    }
+    report << setw(10) << "p50(us)" << setw(10) << "p99(us)" << setw(11) << "p999(us)"
+           << setw(9) << "animals" << setw(10) << "RSS(MiB)" << "  invariants" << endl;
+
+    vector<unique_ptr<Veterinarian>> vets;
+    for (int i = 0; i < options.vets; ++i) {
+        vets.emplace_back(new Veterinarian("Stress_" + to_string(i), "Soak Testing"));
+    }
+
+    vector<thread> workers;
+    uint64_t nextSeed = options.seed * 1000;
+    for (int i = 0; i < options.writers; ++i) workers.emplace_back(runWriter, ref(shared), ++nextSeed);
+    for (int i = 0; i < options.readers; ++i) workers.emplace_back(runReader, ref(shared), ++nextSeed);
+    for (int i = 0; i < options.vets; ++i) workers.emplace_back(runVet, ref(shared), ++nextSeed, ref(*vets[i]));
+
+    Clock::time_point start = Clock::now();
+    Clock::time_point deadline = start + chrono::duration_cast<Clock::duration>(chrono::duration<double>(options.duration));
+    array<uint64_t, LatencyHistogram::BUCKETS> all{};
+    uint64_t previous[ROLE_COUNT] = {};
+    long startRss = residentKiB();
+    long peakRss = startRss;
+    int failedChecks = 0;
+    double worstP99 = 0.0;
+
+    Clock::time_point last = start;
+    while (Clock::now() < deadline) {
+        Clock::time_point wake = min(deadline, last + chrono::duration_cast<Clock::duration>(
+                                                       chrono::duration<double>(options.interval)));
+        this_thread::sleep_until(wake);
+        Clock::time_point now = Clock::now();
+        double seconds = chrono::duration<double>(now - last).count();
+        last = now;
+
+        array<uint64_t, LatencyHistogram::BUCKETS> interval{};
+        report << fixed << setprecision(1) << setw(8) << chrono::duration<double>(now - start).count();
+        for (int role = 0; role < ROLE_COUNT; ++role) {
+            uint64_t total = shared.roles[role].operations.load(memory_order_relaxed);
+            report << setw(12) << static_cast<uint64_t>((total - previous[role]) / seconds);
+            previous[role] = total;
+            shared.roles[role].latency.drainInto(interval);
+        }
+        for (size_t i = 0; i < interval.size(); ++i) all[i] += interval[i];
+        double p99 = LatencyHistogram::percentileMicros(interval, 0.99);
+        worstP99 = max(worstP99, p99);
+
+        string problem = checkInvariants(shared);
+        if (!problem.empty()) ++failedChecks;
+        long rss = residentKiB();
+        peakRss = max(peakRss, rss);
+
+        report << setprecision(2) << setw(10) << LatencyHistogram::percentileMicros(interval, 0.5)
+               << setw(10) << p99 << setw(11) << LatencyHistogram::percentileMicros(interval, 0.999)
+               << setw(9) << concurrent.getAnimalCount() << setprecision(1) << setw(10) << rss / 1024.0
+               << "  " << (problem.empty() ? "ok" : problem) << endl;
+    }
+
+    shared.running = false;
+    for (thread& worker : workers) worker.join();
+    double elapsed = chrono::duration<double>(Clock::now() - start).count();
+    for (int role = 0; role < ROLE_COUNT; ++role) {
+        shared.roles[role].latency.drainInto(all);
+    }
+    string finalProblem = checkInvariants(shared);
+    if (!finalProblem.empty()) ++failedChecks;
+    long endRss = residentKiB();
+
+    report << "\n=== Stress Summary ===" << endl;
+    for (int role = 0; role < ROLE_COUNT; ++role) {
+        uint64_t ops = shared.roles[role].operations.load();
+        report << left << setw(8) << ROLE_NAMES[role] << right << setw(14) << ops << " ops"
+               << setw(12) << static_cast<uint64_t>(ops / elapsed) << "/s"
+               << setw(12) << shared.roles[role].failures.load() << " not found or full" << endl;
+    }
+    report << setprecision(2) << "Latency over the run: p50 " << LatencyHistogram::percentileMicros(all, 0.5)
+           << " us, p99 " << LatencyHistogram::percentileMicros(all, 0.99)
+           << " us, p99.9 " << LatencyHistogram::percentileMicros(all, 0.999)
+           << " us; worst interval p99 " << worstP99 << " us" << endl;
+    report << setprecision(1) << "Memory: " << startRss / 1024.0 << " MiB at start, "
+           << peakRss / 1024.0 << " MiB peak, " << endRss / 1024.0 << " MiB at end" << endl;
+    report << "Invariant checks failed: " << failedChecks
+           << (finalProblem.empty() ? "" : " (last: " + finalProblem + ")") << endl;
+
+    cout.rdbuf(console);
+    return failedChecks == 0 ? 0 : 1;
+}